@@ -1,3 +1,6 @@
+#include "ThemeIconProvider.h"
+#include "WallpaperProvider.h"
+#include "WindowIconProvider.h"
 #include <QDir>
 #include <QGuiApplication>
 #include <QIODevice>
@@ -7,6 +10,9 @@ int main(int argc, char *argv[]) {
   QGuiApplication app(argc, argv);
 
   QQmlApplicationEngine engine;
+  engine.addImageProvider("theme", new ThemeIconProvider);
+  engine.addImageProvider("window", new WindowIconProvider);
+  engine.addImageProvider("wallpaper", new WallpaperProvider);
 
   // Add import paths for CanvasDesk modules
   engine.addImportPath("qrc:/");
@@ -0,0 +1,227 @@
+#include "AppListModel.h"
+#include <QHash>
+#include <QSet>
+
+namespace {
+
+// Above this many row changes a reset is cheaper for the views
+const int MaxIncrementalChanges = 64;
+
+} // namespace
+
+AppListModel::AppListModel(QObject *parent) : QAbstractListModel(parent) {}
+
+int AppListModel::rowCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : m_ids.size();
+}
+
+QVariant AppListModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid() || index.row() >= m_ids.size())
+    return {};
+
+  const int row = index.row();
+  switch (role) {
+  case IdRole:
+    return m_ids.at(row);
+  case Qt::DisplayRole:
+  case NameRole:
+    return m_names.at(row);
+  case IconRole:
+    return m_icons.at(row);
+  case ExecRole:
+    return m_execs.at(row);
+  case GenericNameRole:
+    return m_genericNames.at(row);
+  case CommentRole:
+    return m_comments.at(row);
+  case KeywordsRole:
+    return m_keywords.at(row);
+  }
+  return {};
+}
+
+QHash<int, QByteArray> AppListModel::roleNames() const {
+  return {{IdRole, "id"},
+          {NameRole, "name"},
+          {IconRole, "icon"},
+          {ExecRole, "exec"},
+          {GenericNameRole, "genericName"},
+          {CommentRole, "comment"},
+          {KeywordsRole, "keywords"}};
+}
+
+void AppListModel::setEntries(const QList<DesktopEntry> &entries) {
+  const int oldCount = m_ids.size();
+
+  QSet<QString> ids;
+  ids.reserve(entries.size());
+  for (const DesktopEntry &entry : entries)
+    ids.insert(entry.id);
+
+  // Count rows that would be removed, inserted or moved
+  QStringList kept;
+  kept.reserve(m_ids.size());
+  for (const QString &id : std::as_const(m_ids)) {
+    if (ids.contains(id))
+      kept << id;
+  }
+  const QSet<QString> keptIds(kept.cbegin(), kept.cend());
+  int changes = (m_ids.size() - kept.size()) + (entries.size() - kept.size());
+  for (int i = 0, k = 0; i < entries.size(); ++i) {
+    const QString &id = entries.at(i).id;
+    if (k < kept.size() && id == kept.at(k))
+      ++k;
+    else if (keptIds.contains(id))
+      ++changes;
+  }
+
+  if (m_ids.isEmpty() || changes > MaxIncrementalChanges)
+    resetEntries(entries);
+  else
+    updateEntries(entries, ids);
+
+  if (m_ids.size() != oldCount)
+    emit countChanged();
+}
+
+void AppListModel::resetEntries(const QList<DesktopEntry> &entries) {
+  beginResetModel();
+  m_ids.clear();
+  m_names.clear();
+  m_icons.clear();
+  m_execs.clear();
+  m_genericNames.clear();
+  m_comments.clear();
+  m_keywords.clear();
+  for (const DesktopEntry &entry : entries) {
+    m_ids << entry.id;
+    m_names << entry.name;
+    m_icons << entry.icon;
+    m_execs << entry.exec;
+    m_genericNames << entry.genericName;
+    m_comments << entry.comment;
+    m_keywords << entry.keywords;
+  }
+  endResetModel();
+}
+
+void AppListModel::updateEntries(const QList<DesktopEntry> &entries,
+                                 const QSet<QString> &ids) {
+  // Drop apps that are gone (bottom-up so row numbers stay valid)
+  for (int row = m_ids.size() - 1; row >= 0; --row) {
+    if (!ids.contains(m_ids.at(row)))
+      removeEntry(row);
+  }
+
+  QHash<QString, int> rows;
+  rows.reserve(m_ids.size());
+  for (int row = 0; row < m_ids.size(); ++row)
+    rows.insert(m_ids.at(row), row);
+
+  // Remaining rows are normally already in order; only touch what differs.
+  // An insert or move shifts the rows behind it, so renumber that span.
+  for (int i = 0; i < entries.size(); ++i) {
+    const DesktopEntry &entry = entries.at(i);
+    if (i < m_ids.size() && m_ids.at(i) == entry.id) {
+      updateEntry(i, entry);
+      continue;
+    }
+
+    const int existing = rows.value(entry.id, -1);
+    int last;
+    if (existing != -1) {
+      moveEntry(existing, i);
+      updateEntry(i, entry);
+      last = existing;
+    } else {
+      insertEntry(i, entry);
+      last = m_ids.size() - 1;
+    }
+    for (int row = i; row <= last; ++row)
+      rows[m_ids.at(row)] = row;
+  }
+}
+
+QVariantMap AppListModel::get(int row) const {
+  if (row < 0 || row >= m_ids.size())
+    return {};
+  return {{"id", m_ids.at(row)},
+          {"name", m_names.at(row)},
+          {"icon", m_icons.at(row)},
+          {"exec", m_execs.at(row)},
+          {"genericName", m_genericNames.at(row)},
+          {"comment", m_comments.at(row)},
+          {"keywords", m_keywords.at(row)}};
+}
+
+int AppListModel::indexOf(const QString &id) const { return m_ids.indexOf(id); }
+
+void AppListModel::insertEntry(int row, const DesktopEntry &entry) {
+  beginInsertRows(QModelIndex(), row, row);
+  m_ids.insert(row, entry.id);
+  m_names.insert(row, entry.name);
+  m_icons.insert(row, entry.icon);
+  m_execs.insert(row, entry.exec);
+  m_genericNames.insert(row, entry.genericName);
+  m_comments.insert(row, entry.comment);
+  m_keywords.insert(row, entry.keywords);
+  endInsertRows();
+}
+
+void AppListModel::removeEntry(int row) {
+  beginRemoveRows(QModelIndex(), row, row);
+  m_ids.removeAt(row);
+  m_names.removeAt(row);
+  m_icons.removeAt(row);
+  m_execs.removeAt(row);
+  m_genericNames.removeAt(row);
+  m_comments.removeAt(row);
+  m_keywords.removeAt(row);
+  endRemoveRows();
+}
+
+void AppListModel::moveEntry(int from, int to) {
+  // Only called with from > to
+  beginMoveRows(QModelIndex(), from, from, QModelIndex(), to);
+  m_ids.move(from, to);
+  m_names.move(from, to);
+  m_icons.move(from, to);
+  m_execs.move(from, to);
+  m_genericNames.move(from, to);
+  m_comments.move(from, to);
+  m_keywords.move(from, to);
+  endMoveRows();
+}
+
+void AppListModel::updateEntry(int row, const DesktopEntry &entry) {
+  QList<int> roles;
+  if (m_names.at(row) != entry.name) {
+    m_names[row] = entry.name;
+    roles << NameRole << Qt::DisplayRole;
+  }
+  if (m_icons.at(row) != entry.icon) {
+    m_icons[row] = entry.icon;
+    roles << IconRole;
+  }
+  if (m_execs.at(row) != entry.exec) {
+    m_execs[row] = entry.exec;
+    roles << ExecRole;
+  }
+  if (m_genericNames.at(row) != entry.genericName) {
+    m_genericNames[row] = entry.genericName;
+    roles << GenericNameRole;
+  }
+  if (m_comments.at(row) != entry.comment) {
+    m_comments[row] = entry.comment;
+    roles << CommentRole;
+  }
+  if (m_keywords.at(row) != entry.keywords) {
+    m_keywords[row] = entry.keywords;
+    roles << KeywordsRole;
+  }
+
+  if (!roles.isEmpty()) {
+    const QModelIndex idx = index(row);
+    emit dataChanged(idx, idx, roles);
+  }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "DesktopEntryIndex.h"
+#include <QAbstractListModel>
+#include <QQmlEngine>
+#include <QSet>
+#include <QStringList>
+
+// Installed applications as a list model (AppManager.model).
+//
+// Storage is one column per role rather than a QVariantMap per app, and
+// setEntries() reconciles a new catalogue row by row, so installing or
+// removing a package only inserts/removes/changes the affected delegates.
+// A first fill, or a catalogue that differs in many rows, is one reset.
+class AppListModel : public QAbstractListModel {
+  Q_OBJECT
+  QML_ELEMENT
+  QML_UNCREATABLE("Use AppManager.model")
+  Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+  enum Roles {
+    IdRole = Qt::UserRole + 1,
+    NameRole,
+    IconRole,
+    ExecRole,
+    GenericNameRole,
+    CommentRole,
+    KeywordsRole
+  };
+
+  explicit AppListModel(QObject *parent = nullptr);
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index, int role) const override;
+  QHash<int, QByteArray> roleNames() const override;
+
+  // Entries are matched by id; order follows `entries`
+  void setEntries(const QList<DesktopEntry> &entries);
+
+  Q_INVOKABLE QVariantMap get(int row) const;
+  Q_INVOKABLE int indexOf(const QString &id) const;
+
+signals:
+  void countChanged();
+
+private:
+  void resetEntries(const QList<DesktopEntry> &entries);
+  void updateEntries(const QList<DesktopEntry> &entries,
+                     const QSet<QString> &ids);
+  void insertEntry(int row, const DesktopEntry &entry);
+  void removeEntry(int row);
+  void moveEntry(int from, int to);
+  void updateEntry(int row, const DesktopEntry &entry);
+
+  QStringList m_ids;
+  QStringList m_names;
+  QStringList m_icons;
+  QStringList m_execs;
+  QStringList m_genericNames;
+  QStringList m_comments;
+  QList<QStringList> m_keywords;
+};
@@ -1,111 +1,223 @@
 #include "AppManager.h"
+#include "DesktopExec.h"
+#include <QCoreApplication>
+#include <QDateTime>
 #include <QDebug>
 #include <QDir>
-#include <QFile>
-#include <QProcess>
-#include <QRegularExpression>
+#include <QFileInfo>
+#include <QSet>
 #include <QStandardPaths>
-#include <QTextStream>
+#include <QtConcurrent/QtConcurrentRun>
 
 AppManager::AppManager(QObject *parent) : QObject(parent) {
+  m_model = new AppListModel(this);
+  m_launcher = new ProcessLauncher(this);
+  connect(m_launcher, &ProcessLauncher::exited, StartupTracker::instance(),
+          &StartupTracker::processExited);
+
+  // Rescan when an applications directory changes; the index only reparses
+  // the files that were touched
+  m_changeTimer.setSingleShot(true);
+  m_changeTimer.setInterval(300);
+  connect(&m_changeTimer, &QTimer::timeout, this, &AppManager::scanApps);
+  connect(&m_dirWatcher, &QFileSystemWatcher::directoryChanged, this,
+          [this]() { m_changeTimer.start(); });
+
+  connect(&m_scanWatcher, &QFutureWatcherBase::finished, this,
+          &AppManager::onScanFinished);
+
+  // Show the cached catalogue right away; the scan only reports changes
+  if (m_index.load())
+    applyIndex();
+
   // Delay scanning to avoid issues during initialization
   QMetaObject::invokeMethod(this, &AppManager::scanApps, Qt::QueuedConnection);
 }
 
-QVariantList AppManager::apps() const { return m_apps; }
+QVariantList AppManager::apps() const {
+  QVariantList apps;
+  apps.reserve(m_model->rowCount());
+  for (int row = 0; row < m_model->rowCount(); ++row)
+    apps.append(m_model->get(row));
+  return apps;
+}
+
+static QStringList terminalCommand() {
+  const QString terminal = qEnvironmentVariable("TERMINAL");
+  if (!terminal.isEmpty())
+    return {terminal, "-e"};
+  for (const char *name : {"x-terminal-emulator", "konsole", "xfce4-terminal",
+                           "alacritty", "kitty", "xterm"}) {
+    const QString path = QStandardPaths::findExecutable(name);
+    if (!path.isEmpty())
+      return {path, "-e"};
+  }
+  return {};
+}
 
 void AppManager::launch(const QString &exec) {
-  // Basic launch logic: split by space, handle quotes roughly
-  // For a real DE, use QProcess::startDetached with argument parsing
-  // This is a simplified version.
-
-  // Remove % field codes (e.g. %u, %F) which are common in .desktop files
-  QString cleanExec = exec;
-  cleanExec.replace(QRegularExpression("%[a-zA-Z]"), "");
-  cleanExec = cleanExec.trimmed();
-
-  qDebug() << "Launching:" << cleanExec;
-
-  // Create process with current environment (inherits DISPLAY, etc.)
-  QProcess process;
-  process.setProgram("/bin/sh");
-  process.setArguments(QStringList() << "-c" << cleanExec);
-  process.startDetached();
+  // Button commands are shell snippets ($VAR, ~, globs, quotes); only
+  // launchApp() spawns desktop entries without a shell
+  const qint64 pid = m_launcher->start({"/bin/sh", "-c", exec});
+  if (pid >= 0)
+    emit launched(QString(), pid, QString());
+  // Not tracked: the shell's pid says nothing about the app
 }
 
-void AppManager::rescan() { scanApps(); }
+bool AppManager::launchApp(const QString &id, const QVariantList &targets) {
+  auto it = m_visible.constFind(id);
+  if (it == m_visible.cend()) {
+    qWarning() << "[AppManager] Unknown application:" << id;
+    return false;
+  }
 
-QString AppManager::homeDir() const { return QDir::homePath(); }
+  QList<QUrl> urls;
+  for (const QVariant &target : targets) {
+    urls << (target.userType() == QMetaType::QUrl
+                 ? target.toUrl()
+                 : QUrl::fromUserInput(target.toString(), QDir::currentPath(),
+                                       QUrl::AssumeLocalFile));
+  }
+  return startEntry(*it, urls);
+}
 
-void AppManager::scanApps() {
-  m_apps.clear();
-
-  QStringList paths;
-  paths << QStandardPaths::standardLocations(
-      QStandardPaths::ApplicationsLocation);
-  // Add common fallback if not in standard paths
-  if (!paths.contains("/usr/share/applications")) {
-    paths << "/usr/share/applications";
+bool AppManager::startEntry(const DesktopEntry &entry,
+                            const QList<QUrl> &targets) {
+  bool ok = false;
+  const QStringList tokens = DesktopExec::tokenize(entry.exec, &ok);
+  if (!ok || tokens.isEmpty()) {
+    qWarning() << "[AppManager] Invalid Exec line:" << entry.exec;
+    return false;
   }
 
-  for (const QString &path : paths) {
-    QDir dir(path);
-    if (!dir.exists())
+  bool started = false;
+  for (QStringList argv : DesktopExec::expand(tokens, entry, targets)) {
+    if (entry.terminal)
+      argv = terminalCommand() + argv;
+
+    const QString appId = entry.id.isEmpty() ? argv.first() : entry.id;
+    const QString startupId = createStartupId(appId);
+
+    ProcessLauncher::Options options;
+    options.workingDir = entry.workingDir;
+    options.environment << "DESKTOP_STARTUP_ID=" + startupId.toUtf8();
+
+    const qint64 pid = m_launcher->start(argv, options);
+    if (pid < 0)
       continue;
 
-    QStringList filters;
-    filters << "*.desktop";
-    dir.setNameFilters(filters);
-
-    QFileInfoList list = dir.entryInfoList(QDir::Files);
-    for (const QFileInfo &fileInfo : list) {
-      QVariantMap app = parseDesktopFile(fileInfo.absoluteFilePath());
-      if (!app.isEmpty() && !app["name"].toString().isEmpty()) {
-        m_apps.append(app);
-      }
-    }
+    started = true;
+    qDebug() << "[AppManager] Launched" << argv.first() << "(pid" << pid
+             << ") in" << m_launcher->lastLatencyNs() / 1000 << "us";
+
+    // Busy feedback only for apps that declare startup notification support
+    StartupTracker::instance()->launchStarted(
+        startupId, appId, entry.name.isEmpty() ? argv.first() : entry.name,
+        entry.icon, entry.startupWMClass, pid,
+        entry.startupNotify || !entry.startupWMClass.isEmpty());
+    emit launched(appId, pid, startupId);
+  }
+  return started;
+}
+
+QString AppManager::createStartupId(const QString &appId) {
+  // <unique>_TIME<timestamp>, see the startup-notification spec
+  const QString app = QFileInfo(appId).completeBaseName();
+  return QString("canvasdesk-%1-%2-%3_TIME%4")
+      .arg(QCoreApplication::applicationPid())
+      .arg(++m_launchCount)
+      .arg(app.isEmpty() ? QString("app") : app)
+      .arg(QDateTime::currentMSecsSinceEpoch() & 0xffffffff);
+}
+
+void AppManager::rescan() { scanApps(); }
+
+QString AppManager::homeDir() const { return QDir::homePath(); }
+
+void AppManager::scanApps() {
+  if (m_scanWatcher.isRunning()) {
+    m_rescanPending = true;
+    return;
   }
 
-  emit appsChanged();
+  // Revalidate a copy of the index off the GUI thread
+  m_scanWatcher.setFuture(QtConcurrent::run(
+      [index = m_index]() mutable -> std::optional<DesktopEntryIndex> {
+        if (!index.refresh(DesktopEntryIndex::applicationDirs()))
+          return std::nullopt;
+        index.save();
+        return index;
+      }));
 }
 
-QVariantMap AppManager::parseDesktopFile(const QString &path) {
-  QFile file(path);
-  if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-    return {};
+void AppManager::onScanFinished() {
+  if (std::optional<DesktopEntryIndex> index = m_scanWatcher.result()) {
+    m_index = *index;
+    applyIndex();
+    emit appsChanged();
+  }
 
-  QVariantMap app;
-  app["id"] = QFileInfo(path).fileName();
+  watchDirectories();
 
-  QTextStream in(&file);
-  bool inDesktopEntry = false;
+  if (m_rescanPending) {
+    m_rescanPending = false;
+    scanApps();
+  }
+}
 
-  while (!in.atEnd()) {
-    QString line = in.readLine().trimmed();
-    if (line == "[Desktop Entry]") {
-      inDesktopEntry = true;
-      continue;
-    }
+void AppManager::watchDirectories() {
+  // Everything the last scan walked, subdirectories included; directories
+  // that didn't exist at startup are picked up on the next scan
+  QSet<QString> wanted;
+  for (const QString &dir : DesktopEntryIndex::applicationDirs()) {
+    if (QFileInfo(dir).isDir())
+      wanted.insert(dir);
+  }
+  for (const QString &dir : m_index.directories())
+    wanted.insert(dir);
+
+  const QStringList watched = m_dirWatcher.directories();
+  QStringList gone;
+  for (const QString &dir : watched) {
+    if (!wanted.remove(dir))
+      gone << dir;
+  }
+  if (!gone.isEmpty())
+    m_dirWatcher.removePaths(gone);
+  if (!wanted.isEmpty())
+    m_dirWatcher.addPaths(QStringList(wanted.cbegin(), wanted.cend()));
+}
 
-    if (line.startsWith("[") && line != "[Desktop Entry]") {
-      inDesktopEntry = false;
-    }
+static bool tryExecExists(const QString &tryExec) {
+  if (QFileInfo(tryExec).isAbsolute())
+    return QFileInfo(tryExec).isExecutable();
+  return !QStandardPaths::findExecutable(tryExec).isEmpty();
+}
 
-    if (!inDesktopEntry)
+void AppManager::applyIndex() {
+  const QStringList desktops =
+      qEnvironmentVariable("XDG_CURRENT_DESKTOP").split(':', Qt::SkipEmptyParts);
+
+  QList<DesktopEntry> visible;
+  QSet<QString> seen;
+  m_visible.clear();
+  for (const DesktopEntry &entry : m_index.entries()) {
+    // Earlier directories (the user's) take precedence for the same id; a
+    // Hidden entry there deletes the app
+    if (seen.contains(entry.id))
       continue;
+    seen.insert(entry.id);
 
-    if (line.startsWith("Name=")) {
-      if (!app.contains(
-              "name")) // Don't overwrite if already found (e.g. localized)
-        app["name"] = line.mid(5);
-    } else if (line.startsWith("Icon=")) {
-      app["icon"] = line.mid(5);
-    } else if (line.startsWith("Exec=")) {
-      app["exec"] = line.mid(5);
-    } else if (line.startsWith("NoDisplay=true")) {
-      return {}; // Skip hidden apps
-    }
+    if (!entry.isApplication || entry.hidden || entry.noDisplay ||
+        entry.name.isEmpty())
+      continue; // Skip hidden apps
+    if (!entry.shouldShowIn(desktops))
+      continue;
+    if (!entry.tryExec.isEmpty() && !tryExecExists(entry.tryExec))
+      continue; // Not installed
+    visible.append(entry);
+    m_visible.insert(entry.id, entry);
   }
 
-  return app;
+  m_model->setEntries(visible);
 }
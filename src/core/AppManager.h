@@ -1,17 +1,32 @@
 #pragma once
 
+#include "AppListModel.h"
+#include "DesktopEntryIndex.h"
+#include "ProcessLauncher.h"
+#include "StartupTracker.h"
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QHash>
 #include <QJSEngine>
 #include <QObject>
 #include <QQmlEngine>
 #include <QVariantList>
+#include <QTimer>
 #include <QVariantMap>
+#include <optional>
 
 class AppManager : public QObject {
   Q_OBJECT
   QML_ELEMENT
   QML_SINGLETON
 
+  // Prefer `model`: `apps` is rebuilt in full on every change
   Q_PROPERTY(QVariantList apps READ apps NOTIFY appsChanged)
+  Q_PROPERTY(AppListModel *model READ model CONSTANT)
+  // Time spent starting the last process (ms)
+  Q_PROPERTY(double lastSpawnLatency READ lastSpawnLatency NOTIFY launched)
+  // Pending launches (busy feedback) and launch-to-window latencies
+  Q_PROPERTY(StartupTracker *startup READ startup CONSTANT)
 
 public:
   static AppManager *create(QQmlEngine *qmlEngine, QJSEngine *jsEngine) {
@@ -25,16 +40,37 @@ public:
   explicit AppManager(QObject *parent = nullptr);
 
   QVariantList apps() const;
+  AppListModel *model() const { return m_model; }
+  // Runs a shell command line through /bin/sh -c (e.g. a Button's exec)
   Q_INVOKABLE void launch(const QString &exec);
+  // Launches an installed app by desktop file ID, optionally with files/URLs
+  Q_INVOKABLE bool launchApp(const QString &id,
+                             const QVariantList &targets = {});
+  double lastSpawnLatency() const { return m_launcher->lastLatencyNs() / 1e6; }
+  StartupTracker *startup() const { return StartupTracker::instance(); }
   Q_INVOKABLE void rescan();
   Q_INVOKABLE QString homeDir() const;
 
 signals:
   void appsChanged();
+  void launched(const QString &appId, qint64 pid, const QString &startupId);
 
 private:
   void scanApps();
-  QVariantMap parseDesktopFile(const QString &path);
+  void onScanFinished();
+  void applyIndex();
+  void watchDirectories();
+  bool startEntry(const DesktopEntry &entry, const QList<QUrl> &targets);
+  QString createStartupId(const QString &appId);
 
-  QVariantList m_apps;
+  AppListModel *m_model = nullptr;
+  DesktopEntryIndex m_index;
+  QHash<QString, DesktopEntry> m_visible; // Listed apps by id
+  ProcessLauncher *m_launcher = nullptr;
+  int m_launchCount = 0;
+  QFileSystemWatcher m_dirWatcher;
+  QTimer m_changeTimer; // Coalesces bursts of inotify events (package installs)
+  // Result is empty when nothing changed on disk
+  QFutureWatcher<std::optional<DesktopEntryIndex>> m_scanWatcher;
+  bool m_rescanPending = false;
 };
@@ -0,0 +1,405 @@
+#include "AppSearchModel.h"
+#include "AppListModel.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSet>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// Above this many row changes a reset is cheaper for the views
+const int MaxIncrementalChanges = 64;
+
+quint64 charMask(QStringView text) {
+  quint64 mask = 0;
+  for (QChar ch : text) {
+    const char16_t c = ch.unicode();
+    if (c >= 'a' && c <= 'z')
+      mask |= quint64(1) << (c - 'a');
+    else if (c >= '0' && c <= '9')
+      mask |= quint64(1) << (26 + c - '0');
+    else if (!ch.isSpace() && c != ';')
+      mask |= quint64(1) << (36 + c % 28);
+  }
+  return mask;
+}
+
+bool isBoundary(QChar before) {
+  return before.isSpace() || before == '-' || before == '_' ||
+         before == '.' || before == ';';
+}
+
+// Matches at index 0 or right after a separator
+bool startsWord(const QString &text, const QString &term) {
+  qsizetype from = 0;
+  while (true) {
+    const qsizetype idx = text.indexOf(term, from);
+    if (idx < 0)
+      return false;
+    if (idx == 0 || isBoundary(text.at(idx - 1)))
+      return true;
+    from = idx + 1;
+  }
+}
+
+// Subsequence match; 0 if some character is missing, else 1..99 favouring
+// consecutive runs and word starts
+int fuzzyScore(const QString &text, const QString &term) {
+  int score = 10;
+  qsizetype pos = 0;
+  qsizetype last = -2;
+  for (QChar ch : term) {
+    const qsizetype idx = text.indexOf(ch, pos);
+    if (idx < 0)
+      return 0;
+    if (idx == last + 1)
+      score += 6;
+    if (idx == 0 || isBoundary(text.at(idx - 1)))
+      score += 8;
+    score -= int(std::min<qsizetype>(idx - pos, 5));
+    last = idx;
+    pos = idx + 1;
+  }
+  return std::clamp(score, 1, 99);
+}
+
+QString programName(const QString &exec) {
+  QString program = exec.section(' ', 0, 0, QString::SectionSkipEmpty);
+  program.remove('"');
+  return program.section('/', -1).toCaseFolded();
+}
+
+} // namespace
+
+AppSearchModel::AppSearchModel(QObject *parent) : QAbstractListModel(parent) {}
+
+void AppSearchModel::setSourceModel(AppListModel *model) {
+  if (m_source == model)
+    return;
+  if (m_source)
+    disconnect(m_source, nullptr, this, nullptr);
+
+  m_source = model;
+  if (m_source) {
+    // Structural changes shift source row numbers: follow them, then apply
+    // the new results as row changes like any other query update
+    connect(m_source, &QAbstractItemModel::rowsInserted, this,
+            [this](const QModelIndex &, int first, int last) {
+              const int n = last - first + 1;
+              onSourceRowsChanged(
+                  [=](int row) { return row >= first ? row + n : row; });
+            });
+    connect(m_source, &QAbstractItemModel::rowsRemoved, this,
+            [this](const QModelIndex &, int first, int last) {
+              const int n = last - first + 1;
+              onSourceRowsChanged([=](int row) {
+                if (row < first)
+                  return row;
+                return row > last ? row - n : -1; // -1: gone
+              });
+            });
+    connect(m_source, &QAbstractItemModel::rowsMoved, this,
+            [this](const QModelIndex &, int start, int end, const QModelIndex &,
+                   int dest) {
+              const int n = end - start + 1;
+              onSourceRowsChanged([=](int row) {
+                if (row >= start && row <= end)
+                  return dest > end ? row - start + dest - n
+                                    : row - start + dest;
+                if (dest > end && row > end && row < dest)
+                  return row - n;
+                if (dest < start && row >= dest && row < start)
+                  return row + n;
+                return row;
+              });
+            });
+    connect(m_source, &QAbstractItemModel::modelReset, this,
+            &AppSearchModel::onSourceReset);
+    connect(m_source, &QAbstractItemModel::dataChanged, this,
+            &AppSearchModel::scheduleRefresh);
+  }
+
+  onSourceReset();
+  emit sourceModelChanged();
+}
+
+void AppSearchModel::setQuery(const QString &query) {
+  if (m_query == query)
+    return;
+  m_query = query;
+  emit queryChanged();
+  refresh();
+}
+
+int AppSearchModel::rowCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant AppSearchModel::data(const QModelIndex &index, int role) const {
+  if (!m_source || !index.isValid() || index.row() >= m_rows.size())
+    return {};
+  if (role == ScoreRole)
+    return m_scores.at(index.row());
+  return m_source->data(m_source->index(m_rows.at(index.row())), role);
+}
+
+QHash<int, QByteArray> AppSearchModel::roleNames() const {
+  QHash<int, QByteArray> roles =
+      m_source ? m_source->roleNames() : QHash<int, QByteArray>();
+  roles.insert(ScoreRole, "score");
+  return roles;
+}
+
+QVariantMap AppSearchModel::get(int row) const {
+  if (!m_source || row < 0 || row >= m_rows.size())
+    return {};
+  return m_source->get(m_rows.at(row));
+}
+
+void AppSearchModel::onSourceReset() {
+  m_indexDirty = true;
+  beginResetModel();
+  m_rows.clear();
+  m_scores.clear();
+  m_terms.clear();
+  endResetModel();
+  refresh();
+}
+
+void AppSearchModel::onSourceRowsChanged(
+    const std::function<int(int)> &remap) {
+  // Shown rows keep pointing at the same apps; removed ones drop out now so
+  // views never read a dead row while the refresh is queued
+  for (int i = m_rows.size() - 1; i >= 0; --i) {
+    m_rows[i] = remap(m_rows.at(i));
+    if (m_rows.at(i) == -1) {
+      beginRemoveRows(QModelIndex(), i, i);
+      m_rows.removeAt(i);
+      m_scores.removeAt(i);
+      endRemoveRows();
+      emit countChanged();
+    }
+  }
+  scheduleRefresh();
+}
+
+void AppSearchModel::scheduleRefresh() {
+  // AppListModel::setEntries() signals once per changed row; reindex once
+  m_indexDirty = true;
+  if (m_refreshPending)
+    return;
+  m_refreshPending = true;
+  QMetaObject::invokeMethod(
+      this,
+      [this]() {
+        if (m_refreshPending)
+          refresh();
+      },
+      Qt::QueuedConnection);
+}
+
+void AppSearchModel::rebuildIndex() {
+  const int count = m_source ? m_source->rowCount() : 0;
+  m_names.resize(count);
+  m_genericNames.resize(count);
+  m_keywords.resize(count);
+  m_programs.resize(count);
+  m_masks.resize(count);
+
+  for (int row = 0; row < count; ++row) {
+    const QModelIndex idx = m_source->index(row);
+    m_names[row] = idx.data(AppListModel::NameRole).toString().toCaseFolded();
+    m_genericNames[row] =
+        idx.data(AppListModel::GenericNameRole).toString().toCaseFolded();
+    const QStringList keywords =
+        idx.data(AppListModel::KeywordsRole).toStringList();
+    m_keywords[row] =
+        keywords.isEmpty() ? QString()
+                           : ';' + keywords.join(';').toCaseFolded() + ';';
+    m_programs[row] =
+        programName(idx.data(AppListModel::ExecRole).toString());
+    m_masks[row] = charMask(m_names[row]) | charMask(m_genericNames[row]) |
+                   charMask(m_keywords[row]) | charMask(m_programs[row]);
+  }
+
+  m_indexDirty = false;
+  m_terms.clear(); // Previous matches refer to the old index
+}
+
+int AppSearchModel::scoreTerm(int row, const QString &term) const {
+  const QString &name = m_names.at(row);
+  if (name == term)
+    return 1000;
+  if (name.startsWith(term))
+    return 800 - int(std::min<qsizetype>(name.size() - term.size(), 99));
+  if (startsWord(name, term))
+    return 600;
+  if (name.contains(term))
+    return 400;
+
+  if (startsWord(m_genericNames.at(row), term) ||
+      startsWord(m_keywords.at(row), term))
+    return 300;
+  if (m_programs.at(row).startsWith(term))
+    return 250;
+  if (m_genericNames.at(row).contains(term) ||
+      m_keywords.at(row).contains(term))
+    return 200;
+  if (m_programs.at(row).contains(term))
+    return 100;
+
+  return fuzzyScore(name, term);
+}
+
+QList<AppSearchModel::Match> AppSearchModel::search(const QStringList &terms,
+                                                    bool narrow) {
+  QList<int> pool;
+  if (narrow) {
+    pool = m_matchRows;
+  } else {
+    pool.resize(m_names.size());
+    std::iota(pool.begin(), pool.end(), 0);
+  }
+
+  const quint64 mask = charMask(terms.join(' '));
+  QList<Match> results;
+  QList<int> matched;
+  for (int row : pool) {
+    if ((m_masks.at(row) & mask) != mask)
+      continue;
+
+    int total = 0;
+    for (const QString &term : terms) {
+      const int score = scoreTerm(row, term);
+      if (score == 0) {
+        total = 0;
+        break;
+      }
+      total += score;
+    }
+    if (total > 0) {
+      results.append({row, total});
+      matched.append(row);
+    }
+  }
+  m_matchRows = matched;
+
+  std::stable_sort(results.begin(), results.end(),
+                   [this](const Match &a, const Match &b) {
+                     if (a.score != b.score)
+                       return a.score > b.score;
+                     return m_names.at(a.row) < m_names.at(b.row);
+                   });
+  return results;
+}
+
+void AppSearchModel::refresh() {
+  m_refreshPending = false;
+
+  QElapsedTimer timer;
+  timer.start();
+
+  if (m_indexDirty) {
+    rebuildIndex();
+    qDebug() << "[AppSearchModel] Indexed" << m_names.size() << "apps in"
+             << timer.nsecsElapsed() / 1e6 << "ms";
+  }
+
+  const QStringList terms =
+      m_query.toCaseFolded().split(' ', Qt::SkipEmptyParts);
+
+  QList<Match> results;
+  if (terms.isEmpty()) {
+    for (int row = 0; row < m_names.size(); ++row)
+      results.append({row, 0});
+    m_terms.clear();
+  } else {
+    // Typing forward ("fi" -> "fir"): only the previous matches can match
+    bool narrow = !m_terms.isEmpty() && terms.size() == m_terms.size();
+    for (int i = 0; narrow && i < terms.size(); ++i)
+      narrow = terms.at(i).startsWith(m_terms.at(i));
+    results = search(terms, narrow);
+    m_terms = terms;
+  }
+
+  applyResults(results);
+
+  m_lastSearchNs = timer.nsecsElapsed();
+  emit searched();
+}
+
+void AppSearchModel::applyResults(const QList<Match> &results) {
+  const int oldCount = m_rows.size();
+
+  QHash<int, int> next; // source row -> result position
+  next.reserve(results.size());
+  for (int i = 0; i < results.size(); ++i)
+    next.insert(results.at(i).row, i);
+
+  // Count removals, insertions and kept rows that change position
+  QList<int> keptOld;
+  for (int row : m_rows) {
+    if (next.contains(row))
+      keptOld.append(row);
+  }
+  const QSet<int> current(m_rows.cbegin(), m_rows.cend());
+  int changes = int(m_rows.size() - keptOld.size()) +
+                int(results.size() - keptOld.size());
+  int kept = 0;
+  for (const Match &match : results) {
+    if (current.contains(match.row) && keptOld.at(kept++) != match.row)
+      ++changes;
+  }
+
+  if (changes > MaxIncrementalChanges) {
+    beginResetModel();
+    m_rows.clear();
+    m_scores.clear();
+    for (const Match &match : results) {
+      m_rows.append(match.row);
+      m_scores.append(match.score);
+    }
+    endResetModel();
+  } else {
+    // Drop rows that no longer match (bottom-up so indexes stay valid)
+    for (int i = m_rows.size() - 1; i >= 0; --i) {
+      if (!next.contains(m_rows.at(i))) {
+        beginRemoveRows(QModelIndex(), i, i);
+        m_rows.removeAt(i);
+        m_scores.removeAt(i);
+        endRemoveRows();
+      }
+    }
+
+    for (int i = 0; i < results.size(); ++i) {
+      const Match &match = results.at(i);
+      if (i < m_rows.size() && m_rows.at(i) == match.row) {
+        if (m_scores.at(i) != match.score) {
+          m_scores[i] = match.score;
+          emit dataChanged(index(i), index(i), {ScoreRole});
+        }
+        continue;
+      }
+
+      const int existing = m_rows.indexOf(match.row, i + 1);
+      if (existing != -1) {
+        beginMoveRows(QModelIndex(), existing, existing, QModelIndex(), i);
+        m_rows.move(existing, i);
+        m_scores.move(existing, i);
+        endMoveRows();
+        m_scores[i] = match.score;
+        emit dataChanged(index(i), index(i), {ScoreRole});
+      } else {
+        beginInsertRows(QModelIndex(), i, i);
+        m_rows.insert(i, match.row);
+        m_scores.insert(i, match.score);
+        endInsertRows();
+      }
+    }
+  }
+
+  if (m_rows.size() != oldCount)
+    emit countChanged();
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QPointer>
+#include <QQmlEngine>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+class AppListModel;
+
+// Ranked, filtered view of an AppListModel for the launcher search box.
+//
+// Each term of the query has to match the name, generic name, keywords or
+// program name of an app. Exact and prefix name matches rank highest, then
+// word starts, substrings, other fields and finally a subsequence ("ffx"
+// -> Firefox) fuzzy match on the name. An empty query lists every app in
+// catalogue order.
+//
+// The index keeps case-folded fields plus a character bitmask per app so most
+// apps are rejected without a string compare, and typing forward only rescans
+// the previous matches. Results are applied as row changes, not a reset.
+// Source row changes are batched into one queued reindex and refresh.
+class AppSearchModel : public QAbstractListModel {
+  Q_OBJECT
+  QML_ELEMENT
+  Q_PROPERTY(AppListModel *sourceModel READ sourceModel WRITE setSourceModel
+                 NOTIFY sourceModelChanged)
+  Q_PROPERTY(QString query READ query WRITE setQuery NOTIFY queryChanged)
+  Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+  Q_PROPERTY(double lastSearchTime READ lastSearchTime NOTIFY searched)
+
+public:
+  enum Roles { ScoreRole = Qt::UserRole + 100 };
+
+  explicit AppSearchModel(QObject *parent = nullptr);
+
+  AppListModel *sourceModel() const { return m_source; }
+  void setSourceModel(AppListModel *model);
+
+  QString query() const { return m_query; }
+  void setQuery(const QString &query);
+
+  double lastSearchTime() const { return m_lastSearchNs / 1e6; } // ms
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index, int role) const override;
+  QHash<int, QByteArray> roleNames() const override;
+
+  Q_INVOKABLE QVariantMap get(int row) const;
+
+signals:
+  void sourceModelChanged();
+  void queryChanged();
+  void countChanged();
+  void searched();
+
+private:
+  struct Match {
+    int row;
+    int score;
+  };
+
+  void onSourceReset();
+  void onSourceRowsChanged(const std::function<int(int)> &remap);
+  void scheduleRefresh();
+  void rebuildIndex();
+  QList<Match> search(const QStringList &terms, bool narrow);
+  int scoreTerm(int row, const QString &term) const;
+  void applyResults(const QList<Match> &results);
+  void refresh();
+
+  QPointer<AppListModel> m_source;
+  QString m_query;
+  QStringList m_terms;     // Case-folded query terms of the last search
+  QList<int> m_matchRows;  // Source rows matching m_terms (for narrowing)
+
+  // Index, one entry per source row
+  QStringList m_names;
+  QStringList m_genericNames;
+  QStringList m_keywords; // ";kw1;kw2;" for boundary checks
+  QStringList m_programs; // Executable base name from Exec
+  QList<quint64> m_masks;
+  bool m_indexDirty = true;
+  bool m_refreshPending = false; // Source changes waiting for one refresh
+
+  QList<int> m_rows; // Shown source rows, best first
+  QList<int> m_scores;
+  qint64 m_lastSearchNs = 0;
+};
@@ -1,7 +1,62 @@
 #include "Component.h"
+#include <QJsonObject>
 
 Component::Component(QObject *parent) : QObject(parent) {}
 
+Component *Component::fromVariant(const QVariantMap &data,
+                                  const QString &fallbackUid,
+                                  QObject *parent) {
+  // Round-trip through JSON so values coming from QML and from disk compare
+  // equal (all numbers become doubles)
+  QVariantMap normalized = QJsonObject::fromVariantMap(data).toVariantMap();
+
+  auto *component = new Component(parent);
+  component->m_type = normalized.take("type").toString();
+  component->m_role = normalized.take("role").toString();
+  component->m_uid = normalized.take("uid").toString();
+  if (component->m_uid.isEmpty())
+    component->m_uid = fallbackUid;
+
+  const QVariantList children = normalized.take("dockedComponents").toList();
+  for (int i = 0; i < children.size(); ++i) {
+    QVariantMap childData = children.at(i).toMap();
+    QString childFallback = QString("%1/%2#%3")
+                                .arg(component->m_uid)
+                                .arg(childData.value("type").toString())
+                                .arg(i);
+    component->insertChild(
+        i, fromVariant(childData, childFallback, component));
+  }
+
+  component->m_properties = normalized;
+  return component;
+}
+
+QVariantMap Component::toVariant() const {
+  QVariantMap data = m_properties;
+  data["uid"] = m_uid;
+  data["type"] = m_type;
+  if (!m_role.isEmpty())
+    data["role"] = m_role;
+
+  if (!m_children.isEmpty()) {
+    QVariantList children;
+    for (const Component *child : m_children)
+      children.append(child->toVariant());
+    data["dockedComponents"] = children;
+  }
+  return data;
+}
+
+QString Component::uid() const { return m_uid; }
+
+void Component::setUid(const QString &uid) {
+  if (m_uid == uid)
+    return;
+  m_uid = uid;
+  emit uidChanged();
+}
+
 QString Component::type() const { return m_type; }
 
 void Component::setType(const QString &type) {
@@ -31,6 +86,39 @@ void Component::setProperties(const QVariantMap &properties) {
 
 QList<Component *> Component::childrenList() const { return m_children; }
 
+Component *Component::parentComponent() const {
+  return qobject_cast<Component *>(parent());
+}
+
+int Component::indexOfChild(const Component *child) const {
+  return m_children.indexOf(const_cast<Component *>(child));
+}
+
+void Component::insertChild(int index, Component *child) {
+  if (!child)
+    return;
+  if (Component *oldParent = child->parentComponent())
+    oldParent->takeChild(child);
+
+  child->setParent(this);
+  m_children.insert(qBound(0, index, int(m_children.size())), child);
+}
+
+void Component::takeChild(Component *child) {
+  if (m_children.removeOne(child))
+    child->setParent(nullptr);
+}
+
+Component *Component::findByUid(const QString &uid) {
+  if (m_uid == uid)
+    return this;
+  for (Component *child : m_children) {
+    if (Component *found = child->findByUid(uid))
+      return found;
+  }
+  return nullptr;
+}
+
 QQmlListProperty<Component> Component::childComponents() {
   return QQmlListProperty<Component>(
       this, &m_children, &Component::appendComponent,
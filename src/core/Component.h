@@ -4,8 +4,11 @@
 #include <QQmlEngine>
 #include <QVariantMap>
 
+// Node of the desktop scene tree. The root (type "Desktop") holds the
+// top-level components; a panel's children are its docked components.
 class Component : public QObject {
   Q_OBJECT
+  Q_PROPERTY(QString uid READ uid WRITE setUid NOTIFY uidChanged)
   Q_PROPERTY(QString type READ type WRITE setType NOTIFY typeChanged)
   Q_PROPERTY(QString role READ role WRITE setRole NOTIFY roleChanged)
   Q_PROPERTY(QVariantMap properties READ properties WRITE setProperties NOTIFY
@@ -16,6 +19,16 @@ class Component : public QObject {
 public:
   explicit Component(QObject *parent = nullptr);
 
+  // Build a subtree from a layout.json component entry. Components without a
+  // "uid" get a stable one derived from their position (fallbackUid).
+  static Component *fromVariant(const QVariantMap &data,
+                                const QString &fallbackUid,
+                                QObject *parent = nullptr);
+  QVariantMap toVariant() const;
+
+  QString uid() const;
+  void setUid(const QString &uid);
+
   QString type() const;
   void setType(const QString &type);
 
@@ -28,7 +41,14 @@ public:
   QList<Component *> childrenList() const;
   QQmlListProperty<Component> childComponents();
 
+  Component *parentComponent() const;
+  int indexOfChild(const Component *child) const;
+  void insertChild(int index, Component *child);
+  void takeChild(Component *child); // Detach without deleting
+  Component *findByUid(const QString &uid);
+
 signals:
+  void uidChanged();
   void typeChanged();
   void roleChanged();
   void propertiesChanged();
@@ -41,6 +61,7 @@ private:
   static qsizetype componentCount(QQmlListProperty<Component> *list);
   static void clearComponents(QQmlListProperty<Component> *list);
 
+  QString m_uid;
   QString m_type;
   QString m_role;
   QVariantMap m_properties;
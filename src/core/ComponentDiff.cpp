@@ -0,0 +1,336 @@
+#include "ComponentDiff.h"
+#include "Component.h"
+#include <QDebug>
+#include <QHash>
+#include <QSet>
+#include <algorithm>
+
+namespace {
+
+struct NodeInfo {
+  const Component *node = nullptr;
+  QString parentUid;
+};
+
+using TreeIndex = QHash<QString, NodeInfo>;
+
+void indexTree(const Component *node, const QString &nodeUid,
+               TreeIndex &index) {
+  for (const Component *child : node->childrenList()) {
+    index.insert(child->uid(), {child, nodeUid});
+    indexTree(child, child->uid(), index);
+  }
+}
+
+// Subtree data for an Add patch. Descendants that already exist in the old
+// tree are left out; they get their own Move patch instead of being recreated.
+QVariantMap addedSubtree(const Component *node, const TreeIndex &oldIndex) {
+  QVariantMap data = node->properties();
+  data["uid"] = node->uid();
+  data["type"] = node->type();
+  if (!node->role().isEmpty())
+    data["role"] = node->role();
+
+  QVariantList children;
+  for (const Component *child : node->childrenList()) {
+    if (!oldIndex.contains(child->uid()))
+      children.append(addedSubtree(child, oldIndex));
+  }
+  if (!children.isEmpty())
+    data["dockedComponents"] = children;
+  return data;
+}
+
+QVariantMap changedProperties(const Component *from, const Component *to) {
+  QVariantMap changes;
+  const QVariantMap oldProps = from->properties();
+  const QVariantMap newProps = to->properties();
+
+  for (auto it = newProps.cbegin(); it != newProps.cend(); ++it) {
+    auto old = oldProps.constFind(it.key());
+    if (old == oldProps.cend() || old.value() != it.value())
+      changes.insert(it.key(), it.value());
+  }
+  for (auto it = oldProps.cbegin(); it != oldProps.cend(); ++it) {
+    if (!newProps.contains(it.key()))
+      changes.insert(it.key(), QVariant());
+  }
+
+  // Type/role changes are patched in place; a QML host swaps its loader
+  if (from->type() != to->type())
+    changes["type"] = to->type();
+  if (from->role() != to->role())
+    changes["role"] = to->role();
+  return changes;
+}
+
+// Positions (into `seq`) of a longest strictly increasing subsequence
+QSet<int> longestIncreasingRun(const QList<int> &seq) {
+  QList<int> tails;         // index into seq of the smallest tail per length
+  QList<int> prev(seq.size(), -1);
+  for (int i = 0; i < seq.size(); ++i) {
+    auto it = std::lower_bound(
+        tails.begin(), tails.end(), seq[i],
+        [&seq](int tailPos, int value) { return seq[tailPos] < value; });
+    int len = int(it - tails.begin());
+    if (len > 0)
+      prev[i] = tails[len - 1];
+    if (it == tails.end())
+      tails.append(i);
+    else
+      *it = i;
+  }
+
+  QSet<int> keep;
+  for (int i = tails.isEmpty() ? -1 : tails.last(); i != -1; i = prev[i])
+    keep.insert(i);
+  return keep;
+}
+
+void diffChildren(const Component *to, const QString &toUid,
+                  const TreeIndex &oldIndex, bool parentIsNew,
+                  QList<ComponentPatch> &patches) {
+  const QList<Component *> children = to->childrenList();
+
+  // Children that stay under the same parent: only those outside the longest
+  // in-order run need to move
+  QList<int> stayingPositions;
+  QList<int> oldOrder;
+  for (int i = 0; i < children.size(); ++i) {
+    auto it = oldIndex.constFind(children[i]->uid());
+    if (it != oldIndex.cend() && it->parentUid == toUid) {
+      stayingPositions.append(i);
+      oldOrder.append(it->node->parentComponent()->indexOfChild(it->node));
+    }
+  }
+  QSet<int> inPlace;
+  for (int pos : longestIncreasingRun(oldOrder))
+    inPlace.insert(stayingPositions[pos]);
+
+  for (int i = 0; i < children.size(); ++i) {
+    const Component *child = children[i];
+    auto old = oldIndex.constFind(child->uid());
+
+    ComponentPatch placement;
+    placement.uid = child->uid();
+    placement.parentUid = toUid;
+    placement.afterUid = i > 0 ? children[i - 1]->uid() : QString();
+    placement.index = i;
+
+    if (old == oldIndex.cend()) {
+      // New node; if its parent is new too it was included in that Add
+      if (!parentIsNew) {
+        placement.op = ComponentPatch::Add;
+        placement.data = addedSubtree(child, oldIndex);
+        patches.append(placement);
+      }
+      diffChildren(child, child->uid(), oldIndex, true, patches);
+      continue;
+    }
+
+    if (!inPlace.contains(i)) {
+      placement.op = ComponentPatch::Move;
+      patches.append(placement);
+    }
+
+    QVariantMap changes = changedProperties(old->node, child);
+    if (!changes.isEmpty()) {
+      ComponentPatch update;
+      update.op = ComponentPatch::Update;
+      update.uid = child->uid();
+      update.data = changes;
+      patches.append(update);
+    }
+
+    diffChildren(child, child->uid(), oldIndex, false, patches);
+  }
+}
+
+void collectRemovals(const Component *from, const TreeIndex &newIndex,
+                     QList<ComponentPatch> &patches) {
+  for (const Component *child : from->childrenList()) {
+    if (!newIndex.contains(child->uid())) {
+      ComponentPatch remove;
+      remove.op = ComponentPatch::Remove;
+      remove.uid = child->uid();
+      patches.append(remove);
+      // Surviving descendants were moved out already; the rest go with it
+      continue;
+    }
+    collectRemovals(child, newIndex, patches);
+  }
+}
+
+const char *opName(ComponentPatch::Op op) {
+  switch (op) {
+  case ComponentPatch::Add:
+    return "add";
+  case ComponentPatch::Remove:
+    return "remove";
+  case ComponentPatch::Move:
+    return "move";
+  case ComponentPatch::Update:
+    return "update";
+  }
+  return "update";
+}
+
+Component *resolveParent(Component *root, const QString &parentUid) {
+  return parentUid.isEmpty() ? root : root->findByUid(parentUid);
+}
+
+int insertPosition(Component *parent, const ComponentPatch &patch) {
+  if (patch.afterUid.isEmpty())
+    return 0;
+  const QList<Component *> siblings = parent->childrenList();
+  for (int i = 0; i < siblings.size(); ++i) {
+    if (siblings.at(i)->uid() == patch.afterUid)
+      return i + 1;
+  }
+  return patch.index; // Anchor missing; fall back to the absolute index
+}
+
+} // namespace
+
+QVariantMap ComponentPatch::toVariant() const {
+  QVariantMap map;
+  map["op"] = QString::fromLatin1(opName(op));
+  map["uid"] = uid;
+  if (op == Add || op == Move) {
+    map["parentUid"] = parentUid;
+    map["afterUid"] = afterUid;
+    map["index"] = index;
+  }
+  if (op == Add || op == Update)
+    map["data"] = data;
+  return map;
+}
+
+ComponentPatch ComponentPatch::fromVariant(const QVariantMap &map) {
+  ComponentPatch patch;
+  const QString op = map.value("op").toString();
+  if (op == "add")
+    patch.op = Add;
+  else if (op == "remove")
+    patch.op = Remove;
+  else if (op == "move")
+    patch.op = Move;
+  else
+    patch.op = Update;
+
+  patch.uid = map.value("uid").toString();
+  patch.parentUid = map.value("parentUid").toString();
+  patch.afterUid = map.value("afterUid").toString();
+  patch.index = map.value("index", -1).toInt();
+  patch.data = map.value("data").toMap();
+  return patch;
+}
+
+namespace ComponentDiff {
+
+QList<ComponentPatch> diff(const Component *from, const Component *to) {
+  QList<ComponentPatch> patches;
+  if (!to)
+    return patches;
+
+  TreeIndex oldIndex;
+  TreeIndex newIndex;
+  if (from)
+    indexTree(from, QString(), oldIndex);
+  indexTree(to, QString(), newIndex);
+
+  // Adds/moves/updates in new-tree order, so each placement's anchor is
+  // already in its final position; removals last so nothing that survives is
+  // deleted along with an old ancestor
+  diffChildren(to, QString(), oldIndex, false, patches);
+  if (from)
+    collectRemovals(from, newIndex, patches);
+
+  return patches;
+}
+
+bool apply(Component *root, const QList<ComponentPatch> &patches) {
+  if (!root)
+    return false;
+
+  bool ok = true;
+  for (const ComponentPatch &patch : patches) {
+    switch (patch.op) {
+    case ComponentPatch::Add: {
+      Component *parent = resolveParent(root, patch.parentUid);
+      if (!parent) {
+        ok = false;
+        break;
+      }
+      Component *node = Component::fromVariant(patch.data, patch.uid);
+      parent->insertChild(insertPosition(parent, patch), node);
+      break;
+    }
+    case ComponentPatch::Move: {
+      Component *node = root->findByUid(patch.uid);
+      Component *parent = resolveParent(root, patch.parentUid);
+      if (!node || node == root || !parent) {
+        ok = false;
+        break;
+      }
+      if (Component *oldParent = node->parentComponent())
+        oldParent->takeChild(node);
+      parent->insertChild(insertPosition(parent, patch), node);
+      break;
+    }
+    case ComponentPatch::Update: {
+      Component *node = root->findByUid(patch.uid);
+      if (!node) {
+        ok = false;
+        break;
+      }
+      QVariantMap props = node->properties();
+      for (auto it = patch.data.cbegin(); it != patch.data.cend(); ++it) {
+        if (it.key() == "type")
+          node->setType(it.value().toString());
+        else if (it.key() == "role")
+          node->setRole(it.value().toString());
+        else if (it.value().isNull())
+          props.remove(it.key());
+        else
+          props.insert(it.key(), it.value());
+      }
+      node->setProperties(props);
+      break;
+    }
+    case ComponentPatch::Remove: {
+      Component *node = root->findByUid(patch.uid);
+      if (!node || node == root) {
+        ok = false;
+        break;
+      }
+      if (Component *parent = node->parentComponent())
+        parent->takeChild(node);
+      delete node;
+      break;
+    }
+    }
+  }
+
+  if (!ok)
+    qWarning() << "[ComponentDiff] Some patches did not match the scene tree";
+  return ok;
+}
+
+QVariantList toVariantList(const QList<ComponentPatch> &patches) {
+  QVariantList list;
+  list.reserve(patches.size());
+  for (const ComponentPatch &patch : patches)
+    list.append(patch.toVariant());
+  return list;
+}
+
+QList<ComponentPatch> fromVariantList(const QVariantList &list) {
+  QList<ComponentPatch> patches;
+  patches.reserve(list.size());
+  for (const QVariant &entry : list)
+    patches.append(ComponentPatch::fromVariant(entry.toMap()));
+  return patches;
+}
+
+} // namespace ComponentDiff
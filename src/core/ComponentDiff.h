@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QVariantList>
+#include <QVariantMap>
+
+class Component;
+
+// One edit to a Component tree. Patches are ordered: apply them in sequence.
+struct ComponentPatch {
+  enum Op { Add, Remove, Move, Update };
+
+  Op op = Update;
+  QString uid;
+  QString parentUid; // Add/Move: new parent ("" = scene root)
+  QString afterUid;  // Add/Move: preceding sibling ("" = first child)
+  int index = -1;    // Add/Move: final index among the new parent's children
+  QVariantMap data;  // Add: full subtree, Update: changed properties only
+                     // (a removed property is reported as null)
+
+  QVariantMap toVariant() const;
+  static ComponentPatch fromVariant(const QVariantMap &map);
+};
+
+namespace ComponentDiff {
+
+// Minimal patch list turning `from` into `to`. Nodes are matched by uid; a
+// changed type or role is patched in place with an Update carrying "type"/
+// "role", like any other property. Sibling reordering keeps the longest run
+// of children already in order and only moves the rest.
+QList<ComponentPatch> diff(const Component *from, const Component *to);
+
+// Apply patches to a live tree. Returns false if any patch didn't match.
+bool apply(Component *root, const QList<ComponentPatch> &patches);
+
+QVariantList toVariantList(const QList<ComponentPatch> &patches);
+QList<ComponentPatch> fromVariantList(const QVariantList &list);
+
+} // namespace ComponentDiff
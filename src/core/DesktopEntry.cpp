@@ -0,0 +1,250 @@
+#include "DesktopEntry.h"
+#include <QFile>
+#include <climits>
+
+namespace {
+
+// Expands \s \n \t \r \\ (and \; inside lists)
+QString unescape(QByteArrayView value) {
+  if (!value.contains('\\'))
+    return QString::fromUtf8(value);
+
+  QByteArray out;
+  out.reserve(value.size());
+  for (qsizetype i = 0; i < value.size(); ++i) {
+    char c = value[i];
+    if (c != '\\' || i + 1 == value.size()) {
+      out += c;
+      continue;
+    }
+    switch (value[++i]) {
+    case 's':
+      out += ' ';
+      break;
+    case 'n':
+      out += '\n';
+      break;
+    case 't':
+      out += '\t';
+      break;
+    case 'r':
+      out += '\r';
+      break;
+    case '\\':
+      out += '\\';
+      break;
+    case ';':
+      out += ';';
+      break;
+    default:
+      out += '\\';
+      out += value[i];
+    }
+  }
+  return QString::fromUtf8(out);
+}
+
+QStringList splitList(QByteArrayView value) {
+  QStringList list;
+  qsizetype start = 0;
+  for (qsizetype i = 0; i <= value.size(); ++i) {
+    if (i < value.size() && value[i] == '\\') {
+      ++i; // Escaped char, including \;
+      continue;
+    }
+    if (i == value.size() || value[i] == ';') {
+      QByteArrayView part = value.sliced(start, i - start);
+      if (!part.isEmpty())
+        list.append(unescape(part));
+      start = i + 1;
+    }
+  }
+  return list;
+}
+
+bool isTrue(QByteArrayView value) { return value == "true" || value == "1"; }
+
+int localeRank(QByteArrayView locale, const QList<QByteArray> &locales) {
+  for (int i = 0; i < locales.size(); ++i) {
+    if (locales.at(i) == locale)
+      return i;
+  }
+  return -1;
+}
+
+} // namespace
+
+bool DesktopEntry::shouldShowIn(const QStringList &desktops) const {
+  if (!onlyShowIn.isEmpty()) {
+    for (const QString &desktop : desktops) {
+      if (onlyShowIn.contains(desktop))
+        return true;
+    }
+    return false;
+  }
+  for (const QString &desktop : desktops) {
+    if (notShowIn.contains(desktop))
+      return false;
+  }
+  return true;
+}
+
+namespace DesktopEntryParser {
+
+QList<QByteArray> localeCandidates() {
+  QByteArray locale;
+  for (const char *var : {"LC_ALL", "LC_MESSAGES", "LANG"}) {
+    locale = qgetenv(var);
+    if (!locale.isEmpty())
+      break;
+  }
+
+  // lang_COUNTRY.ENCODING@MODIFIER
+  QByteArray modifier;
+  qsizetype at = locale.indexOf('@');
+  if (at >= 0) {
+    modifier = locale.mid(at + 1);
+    locale.truncate(at);
+  }
+  qsizetype dot = locale.indexOf('.');
+  if (dot >= 0)
+    locale.truncate(dot);
+
+  QByteArray lang = locale;
+  QByteArray country;
+  qsizetype underscore = locale.indexOf('_');
+  if (underscore >= 0) {
+    lang = locale.left(underscore);
+    country = locale.mid(underscore + 1);
+  }
+
+  QList<QByteArray> candidates;
+  if (lang.isEmpty() || lang == "C" || lang == "POSIX")
+    return candidates;
+  if (!country.isEmpty() && !modifier.isEmpty())
+    candidates << lang + '_' + country + '@' + modifier;
+  if (!country.isEmpty())
+    candidates << lang + '_' + country;
+  if (!modifier.isEmpty())
+    candidates << lang + '@' + modifier;
+  candidates << lang;
+  return candidates;
+}
+
+DesktopEntry parse(QByteArrayView contents, const QList<QByteArray> &locales) {
+  DesktopEntry entry;
+
+  // Lower is better; unlocalized values rank after every locale match
+  const int unlocalized = locales.size();
+  int nameRank = INT_MAX;
+  int genericNameRank = INT_MAX;
+  int commentRank = INT_MAX;
+  int keywordsRank = INT_MAX;
+
+  bool inGroup = false;
+  qsizetype pos = 0;
+  while (pos < contents.size()) {
+    qsizetype end = contents.indexOf('\n', pos);
+    if (end < 0)
+      end = contents.size();
+    QByteArrayView line = contents.sliced(pos, end - pos).trimmed();
+    pos = end + 1;
+
+    if (line.isEmpty() || line.front() == '#')
+      continue;
+
+    if (line.front() == '[') {
+      if (inGroup)
+        break; // Actions and other groups follow; nothing more to read
+      inGroup = line == "[Desktop Entry]";
+      continue;
+    }
+    if (!inGroup)
+      continue;
+
+    qsizetype eq = line.indexOf('=');
+    if (eq <= 0)
+      continue;
+    QByteArrayView key = line.first(eq).trimmed();
+    QByteArrayView value = line.sliced(eq + 1).trimmed();
+
+    int rank = unlocalized;
+    if (key.endsWith(']')) {
+      qsizetype bracket = key.indexOf('[');
+      if (bracket <= 0)
+        continue;
+      rank = localeRank(key.sliced(bracket + 1, key.size() - bracket - 2),
+                        locales);
+      if (rank < 0)
+        continue; // Some other language
+      key = key.first(bracket);
+    }
+
+    if (key == "Name") {
+      if (rank < nameRank) {
+        entry.name = unescape(value);
+        nameRank = rank;
+      }
+    } else if (key == "GenericName") {
+      if (rank < genericNameRank) {
+        entry.genericName = unescape(value);
+        genericNameRank = rank;
+      }
+    } else if (key == "Comment") {
+      if (rank < commentRank) {
+        entry.comment = unescape(value);
+        commentRank = rank;
+      }
+    } else if (key == "Keywords") {
+      if (rank < keywordsRank) {
+        entry.keywords = splitList(value);
+        keywordsRank = rank;
+      }
+    } else if (rank != unlocalized) {
+      continue; // Only the keys above are localized
+    } else if (key == "Type") {
+      entry.isApplication = value == "Application";
+    } else if (key == "Icon") {
+      entry.icon = unescape(value);
+    } else if (key == "Exec") {
+      entry.exec = unescape(value);
+    } else if (key == "TryExec") {
+      entry.tryExec = unescape(value);
+    } else if (key == "Path") {
+      entry.workingDir = unescape(value);
+    } else if (key == "StartupWMClass") {
+      entry.startupWMClass = unescape(value);
+    } else if (key == "Categories") {
+      entry.categories = splitList(value);
+    } else if (key == "MimeType") {
+      entry.mimeTypes = splitList(value);
+    } else if (key == "OnlyShowIn") {
+      entry.onlyShowIn = splitList(value);
+    } else if (key == "NotShowIn") {
+      entry.notShowIn = splitList(value);
+    } else if (key == "NoDisplay") {
+      entry.noDisplay = isTrue(value);
+    } else if (key == "Hidden") {
+      entry.hidden = isTrue(value);
+    } else if (key == "Terminal") {
+      entry.terminal = isTrue(value);
+    } else if (key == "StartupNotify") {
+      entry.startupNotify = isTrue(value);
+    }
+  }
+
+  return entry;
+}
+
+DesktopEntry parseFile(const QString &path) {
+  static const QList<QByteArray> locales = localeCandidates();
+
+  DesktopEntry entry;
+  QFile file(path);
+  if (file.open(QIODevice::ReadOnly))
+    entry = parse(file.readAll(), locales);
+  entry.path = path;
+  return entry;
+}
+
+} // namespace DesktopEntryParser
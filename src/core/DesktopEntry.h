@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+// The [Desktop Entry] group of a .desktop file (freedesktop.org Desktop Entry
+// Specification 1.5). Localized keys hold the best match for the user's locale.
+struct DesktopEntry {
+  QString id; // Desktop file ID: path below applications/, '/' -> '-'
+  QString path;
+
+  QString name;
+  QString genericName;
+  QString comment;
+  QString icon;
+  QString exec;
+  QString tryExec;
+  QString workingDir; // Path=
+  QString startupWMClass;
+  QStringList keywords;
+  QStringList categories;
+  QStringList mimeTypes;
+  QStringList onlyShowIn;
+  QStringList notShowIn;
+
+  bool isApplication = false; // Type=Application
+  bool noDisplay = false;
+  bool hidden = false; // "Deleted"; still masks entries with the same id
+  bool terminal = false;
+  bool startupNotify = false;
+
+  // Stat data the entry was parsed from
+  qint64 mtime = 0; // ms since epoch
+  qint64 size = 0;
+
+  // OnlyShowIn/NotShowIn against $XDG_CURRENT_DESKTOP
+  bool shouldShowIn(const QStringList &desktops) const;
+};
+
+namespace DesktopEntryParser {
+
+// Locale suffixes for localized keys from LC_ALL/LC_MESSAGES/LANG, best match
+// first: lang_COUNTRY@MODIFIER, lang_COUNTRY, lang@MODIFIER, lang
+QList<QByteArray> localeCandidates();
+
+// Parses file contents in place; QStrings are only created for kept values
+DesktopEntry parse(QByteArrayView contents, const QList<QByteArray> &locales);
+
+// Single read of `path`; id and stat fields are left for the caller
+DesktopEntry parseFile(const QString &path);
+
+} // namespace DesktopEntryParser
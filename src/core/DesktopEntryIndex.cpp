@@ -0,0 +1,278 @@
+#include "DesktopEntryIndex.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QtConcurrent/QtConcurrentMap>
+
+namespace {
+
+const quint32 IndexMagic = 0x43444549; // "CDEI"
+const quint32 IndexVersion = 4;        // Bump on DesktopEntry/DirStamp changes
+
+qint64 modifiedMs(const QFileInfo &info) {
+  return info.lastModified().toMSecsSinceEpoch();
+}
+
+QDataStream &operator<<(QDataStream &out, const DesktopEntry &e) {
+  return out << e.id << e.path << e.name << e.genericName << e.comment
+             << e.icon << e.exec << e.tryExec << e.workingDir
+             << e.startupWMClass << e.keywords << e.categories << e.mimeTypes
+             << e.onlyShowIn << e.notShowIn << e.isApplication << e.noDisplay
+             << e.hidden << e.terminal << e.startupNotify << e.mtime << e.size;
+}
+
+QDataStream &operator>>(QDataStream &in, DesktopEntry &e) {
+  return in >> e.id >> e.path >> e.name >> e.genericName >> e.comment >>
+         e.icon >> e.exec >> e.tryExec >> e.workingDir >> e.startupWMClass >>
+         e.keywords >> e.categories >> e.mimeTypes >> e.onlyShowIn >>
+         e.notShowIn >> e.isApplication >> e.noDisplay >> e.hidden >>
+         e.terminal >> e.startupNotify >> e.mtime >> e.size;
+}
+
+} // namespace
+
+DesktopEntryIndex::DesktopEntryIndex(const QString &cachePath)
+    : m_cachePath(cachePath) {}
+
+QString DesktopEntryIndex::defaultCachePath() {
+  return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) +
+         "/canvasdesk/desktop-entries.idx";
+}
+
+QStringList DesktopEntryIndex::applicationDirs() {
+  // $XDG_DATA_HOME/applications, then $XDG_DATA_DIRS in order
+  QStringList candidates =
+      QStandardPaths::standardLocations(QStandardPaths::ApplicationsLocation);
+  // Add common fallback if not in standard paths
+  candidates << "/usr/share/applications";
+
+  // The same directory can be listed twice, or reached through a symlink
+  QStringList paths;
+  QStringList seen;
+  for (const QString &path : candidates) {
+    const QString canonical = QFileInfo(path).canonicalFilePath();
+    const QString key = canonical.isEmpty() ? path : canonical;
+    if (!seen.contains(key)) {
+      seen << key;
+      paths << path;
+    }
+  }
+  return paths;
+}
+
+bool DesktopEntryIndex::load() {
+  QFile file(m_cachePath);
+  if (!file.open(QIODevice::ReadOnly) || file.size() == 0)
+    return false;
+
+  uchar *mapped = file.map(0, file.size());
+  if (!mapped)
+    return false;
+
+  const QByteArray raw =
+      QByteArray::fromRawData(reinterpret_cast<const char *>(mapped),
+                              file.size());
+  QDataStream in(raw);
+  in.setVersion(QDataStream::Qt_6_5);
+
+  quint32 magic = 0;
+  quint32 version = 0;
+  QList<QByteArray> locales;
+  in >> magic >> version;
+  if (magic == IndexMagic && version == IndexVersion)
+    in >> locales;
+  // Localized names were resolved at parse time; another locale reparses
+  if (magic != IndexMagic || version != IndexVersion ||
+      locales != DesktopEntryParser::localeCandidates()) {
+    file.unmap(mapped);
+    return false;
+  }
+
+  QList<DirStamp> dirs;
+  qint32 dirCount = 0;
+  in >> dirCount;
+  for (qint32 i = 0; i < dirCount && in.status() == QDataStream::Ok; ++i) {
+    DirStamp dir;
+    in >> dir.path >> dir.idPrefix >> dir.mtime >> dir.files >> dir.subdirs;
+    dirs.append(dir);
+  }
+
+  QList<DesktopEntry> entries;
+  qint32 entryCount = 0;
+  in >> entryCount;
+  if (entryCount > 0)
+    entries.reserve(entryCount);
+  for (qint32 i = 0; i < entryCount && in.status() == QDataStream::Ok; ++i) {
+    DesktopEntry entry;
+    in >> entry;
+    entries.append(entry);
+  }
+
+  const bool ok = in.status() == QDataStream::Ok;
+  file.unmap(mapped);
+  if (!ok) {
+    qWarning() << "[DesktopEntryIndex] Ignoring corrupt index" << m_cachePath;
+    return false;
+  }
+
+  m_dirs = dirs;
+  m_entries = entries;
+  return true;
+}
+
+bool DesktopEntryIndex::save() const {
+  QDir().mkpath(QFileInfo(m_cachePath).absolutePath());
+
+  QSaveFile file(m_cachePath);
+  if (!file.open(QIODevice::WriteOnly)) {
+    qWarning() << "[DesktopEntryIndex] Failed to write" << m_cachePath;
+    return false;
+  }
+
+  QDataStream out(&file);
+  out.setVersion(QDataStream::Qt_6_5);
+  out << IndexMagic << IndexVersion << DesktopEntryParser::localeCandidates();
+
+  out << qint32(m_dirs.size());
+  for (const DirStamp &dir : m_dirs)
+    out << dir.path << dir.idPrefix << dir.mtime << dir.files << dir.subdirs;
+
+  out << qint32(m_entries.size());
+  for (const DesktopEntry &entry : m_entries)
+    out << entry;
+
+  return file.commit();
+}
+
+QStringList DesktopEntryIndex::directories() const {
+  QStringList paths;
+  paths.reserve(m_dirs.size());
+  for (const DirStamp &dir : m_dirs)
+    paths << dir.path;
+  return paths;
+}
+
+struct DesktopEntryIndex::ScanState {
+  QHash<QString, const DirStamp *> oldDirs;
+  QHash<QString, const DesktopEntry *> cached;
+  QSet<QString> visited; // Canonical paths; symlinked dirs can loop back
+
+  QList<DirStamp> dirs;
+  QList<DesktopEntry> entries;
+  QStringList toParse;
+  QList<int> parseSlots;
+  qint64 parseBytes = 0;
+  bool changed = false;
+};
+
+bool DesktopEntryIndex::refresh(const QStringList &dirs) {
+  QElapsedTimer timer;
+  timer.start();
+
+  ScanState state;
+  for (const DirStamp &dir : m_dirs)
+    state.oldDirs.insert(dir.path, &dir);
+  for (const DesktopEntry &entry : m_entries)
+    state.cached.insert(entry.path, &entry);
+
+  for (const QString &path : dirs)
+    scanDir(path, QString(), state);
+
+  const qint64 statMs = timer.elapsed();
+
+  if (!state.toParse.isEmpty()) {
+    const QList<DesktopEntry> parsed = QtConcurrent::blockingMapped(
+        state.toParse, &DesktopEntryParser::parseFile);
+    for (int i = 0; i < parsed.size(); ++i) {
+      DesktopEntry &slot = state.entries[state.parseSlots.at(i)];
+      DesktopEntry entry = parsed.at(i);
+      entry.id = slot.id;
+      entry.mtime = slot.mtime;
+      entry.size = slot.size;
+      slot = entry;
+    }
+    state.changed = true;
+  }
+
+  if (state.entries.size() != m_entries.size())
+    state.changed = true;
+
+  m_dirs = state.dirs;
+  m_entries = state.entries;
+
+  const qint64 elapsedMs = timer.elapsed();
+  qDebug() << "[DesktopEntryIndex]" << m_entries.size() << "entries in"
+           << m_dirs.size() << "dirs; stat" << statMs << "ms, parsed"
+           << state.toParse.size() << "files (" << state.parseBytes / 1024
+           << "KiB ) in" << elapsedMs - statMs << "ms";
+  return state.changed;
+}
+
+void DesktopEntryIndex::scanDir(const QString &path, const QString &idPrefix,
+                                ScanState &state) const {
+  QFileInfo dirInfo(path);
+  if (!dirInfo.isDir())
+    return;
+  const QString canonical = dirInfo.canonicalFilePath();
+  if (canonical.isEmpty() || state.visited.contains(canonical))
+    return;
+  state.visited.insert(canonical);
+
+  DirStamp stamp;
+  stamp.path = path;
+  stamp.idPrefix = idPrefix;
+  stamp.mtime = modifiedMs(dirInfo);
+
+  // Adding, removing or renaming an entry bumps the directory mtime
+  auto old = state.oldDirs.constFind(path);
+  if (old != state.oldDirs.cend() && (*old)->mtime == stamp.mtime) {
+    stamp.files = (*old)->files;
+    stamp.subdirs = (*old)->subdirs;
+  } else {
+    QDir dir(path);
+    stamp.files = dir.entryList({"*.desktop"}, QDir::Files, QDir::Name);
+    stamp.subdirs =
+        dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+  }
+
+  for (const QString &name : stamp.files) {
+    const QString filePath = path + '/' + name;
+    QFileInfo info(filePath);
+    if (!info.exists()) {
+      state.changed = true;
+      continue;
+    }
+
+    // In-place edits don't touch the directory; stat each file
+    const qint64 mtime = modifiedMs(info);
+    const qint64 size = info.size();
+    auto hit = state.cached.constFind(filePath);
+    if (hit != state.cached.cend() && (*hit)->mtime == mtime &&
+        (*hit)->size == size) {
+      state.entries.append(**hit);
+      continue;
+    }
+
+    DesktopEntry placeholder;
+    placeholder.id = idPrefix + name;
+    placeholder.mtime = mtime;
+    placeholder.size = size;
+    state.parseSlots.append(state.entries.size());
+    state.entries.append(placeholder);
+    state.toParse.append(filePath);
+    state.parseBytes += size;
+  }
+
+  state.dirs.append(stamp);
+
+  for (const QString &subdir : stamp.subdirs)
+    scanDir(path + '/' + subdir, idPrefix + subdir + '-', state);
+}
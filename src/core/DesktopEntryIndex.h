@@ -0,0 +1,54 @@
+#pragma once
+
+#include "DesktopEntry.h"
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+// Cached index of the .desktop files in the application directories.
+//
+// The index is stored in one binary file that load() maps in a single read.
+// refresh() revalidates it against the filesystem: a directory whose mtime is
+// unchanged reuses its cached listing, and only files whose mtime or size
+// changed are reparsed (in parallel on the global thread pool). Entries hold
+// names already localized, so an index written under another locale is
+// discarded like one from an older version.
+//
+// Entries are kept in precedence order ($XDG_DATA_HOME first, then
+// $XDG_DATA_DIRS); for a repeated desktop file ID the first entry wins.
+//
+// Plain value type: AppManager refreshes a copy on a worker thread.
+class DesktopEntryIndex {
+public:
+  explicit DesktopEntryIndex(const QString &cachePath = defaultCachePath());
+
+  static QString defaultCachePath();
+  static QStringList applicationDirs();
+
+  bool load();
+  bool save() const;
+
+  // Returns true if any entry was added, removed or reparsed
+  bool refresh(const QStringList &dirs);
+
+  const QList<DesktopEntry> &entries() const { return m_entries; }
+  // Every directory scanned, subdirectories included
+  QStringList directories() const;
+
+private:
+  struct DirStamp {
+    QString path;
+    QString idPrefix; // Subdirectories contribute "subdir-" to the id
+    qint64 mtime = 0;
+    QStringList files;   // *.desktop names, sorted
+    QStringList subdirs; // Sorted
+  };
+  struct ScanState;
+
+  void scanDir(const QString &path, const QString &idPrefix,
+               ScanState &state) const;
+
+  QString m_cachePath;
+  QList<DirStamp> m_dirs;
+  QList<DesktopEntry> m_entries; // Precedence order, then file name order
+};
@@ -0,0 +1,170 @@
+#include "DesktopExec.h"
+
+namespace {
+
+bool isFieldCode(const QString &token, QChar code) {
+  return token.size() == 2 && token.at(0) == '%' && token.at(1) == code;
+}
+
+QString localPath(const QUrl &url) {
+  return url.isLocalFile() ? url.toLocalFile() : QString();
+}
+
+// Walks `token` once, passing literal characters (%% unescaped) to `literal`
+// and field code letters to `code`. Detection and substitution both use it,
+// so an escaped %%f is never mistaken for a field code.
+template <typename Literal, typename Code>
+void scanToken(const QString &token, Literal literal, Code code) {
+  for (qsizetype i = 0; i < token.size(); ++i) {
+    if (token.at(i) != '%' || i + 1 == token.size()) {
+      literal(token.at(i));
+      continue;
+    }
+    const QChar next = token.at(++i);
+    if (next == '%')
+      literal(next);
+    else
+      code(next);
+  }
+}
+
+// Expands codes embedded in a single argument. `target` feeds %f/%u.
+QString expandInline(const QString &token, const DesktopEntry &entry,
+                     const QUrl &target) {
+  QString out;
+  out.reserve(token.size());
+  scanToken(
+      token, [&](QChar c) { out += c; },
+      [&](QChar code) {
+        switch (code.unicode()) {
+        case 'f':
+        case 'F':
+          out += localPath(target);
+          break;
+        case 'u':
+        case 'U':
+          if (!target.isEmpty())
+            out += target.toString();
+          break;
+        case 'c':
+          out += entry.name;
+          break;
+        case 'k':
+          out += entry.path;
+          break;
+        default:
+          // %i is handled as a whole argument; %d %D %n %N %v %m deprecated
+          break;
+        }
+      });
+  return out;
+}
+
+} // namespace
+
+namespace DesktopExec {
+
+QStringList tokenize(const QString &exec, bool *ok) {
+  QStringList args;
+  QString current;
+  bool inQuotes = false;
+  bool hasToken = false;
+
+  for (qsizetype i = 0; i < exec.size(); ++i) {
+    const QChar c = exec.at(i);
+    if (inQuotes) {
+      // Inside quotes only " ` $ and \ are escaped
+      if (c == '\\' && i + 1 < exec.size() &&
+          QStringView(u"\"`$\\").contains(exec.at(i + 1))) {
+        current += exec.at(++i);
+      } else if (c == '"') {
+        inQuotes = false;
+      } else {
+        current += c;
+      }
+      continue;
+    }
+
+    if (c == '"') {
+      inQuotes = true;
+      hasToken = true;
+    } else if (c == ' ' || c == '\t' || c == '\n') {
+      if (hasToken) {
+        args << current;
+        current.clear();
+        hasToken = false;
+      }
+    } else if (c == '\\' && i + 1 < exec.size()) {
+      // Not allowed by the spec outside quotes, but common in the wild
+      current += exec.at(++i);
+      hasToken = true;
+    } else {
+      current += c;
+      hasToken = true;
+    }
+  }
+
+  if (inQuotes) {
+    if (ok)
+      *ok = false;
+    return {};
+  }
+  if (hasToken)
+    args << current;
+  if (ok)
+    *ok = true;
+  return args;
+}
+
+QList<QStringList> expand(const QStringList &tokens, const DesktopEntry &entry,
+                          const QList<QUrl> &targets) {
+  bool single = false; // %f or %u: one target per process
+  bool wantsFiles = false;
+  for (const QString &token : tokens) {
+    scanToken(
+        token, [](QChar) {},
+        [&](QChar code) {
+          if (code == 'f' || code == 'u')
+            single = true;
+          if (code == 'f' || code == 'F')
+            wantsFiles = true;
+        });
+  }
+
+  // %f/%F only take local files
+  QList<QUrl> usable;
+  for (const QUrl &url : targets) {
+    if (!wantsFiles || url.isLocalFile())
+      usable << url;
+  }
+
+  const int instances = single && usable.size() > 1 ? int(usable.size()) : 1;
+  QList<QStringList> commands;
+  for (int n = 0; n < instances; ++n) {
+    const QUrl target = usable.isEmpty() ? QUrl() : usable.at(n);
+
+    QStringList argv;
+    for (const QString &token : tokens) {
+      if (isFieldCode(token, 'F')) {
+        for (const QUrl &url : usable)
+          argv << localPath(url);
+      } else if (isFieldCode(token, 'U')) {
+        for (const QUrl &url : usable)
+          argv << url.toString();
+      } else if (isFieldCode(token, 'i')) {
+        if (!entry.icon.isEmpty())
+          argv << "--icon" << entry.icon;
+      } else {
+        const QString arg = expandInline(token, entry, target);
+        // A lone field code with nothing to substitute is dropped entirely
+        if (!arg.isEmpty() || !token.startsWith('%') || token.size() != 2)
+          argv << arg;
+      }
+    }
+    if (!argv.isEmpty())
+      commands << argv;
+  }
+  return commands;
+}
+
+} // namespace DesktopExec
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "DesktopEntry.h"
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+
+// Exec= handling per the Desktop Entry Specification ("The Exec key").
+namespace DesktopExec {
+
+// Splits an Exec value into arguments using the spec's quoting rules.
+// Returns an empty list (and sets *ok to false) for unbalanced quotes.
+QStringList tokenize(const QString &exec, bool *ok = nullptr);
+
+// Expands field codes (%f %F %u %U %i %c %k %%; deprecated codes are
+// dropped). Returns one argument list per process to start: several only
+// when a %f/%u command is given more than one target.
+QList<QStringList> expand(const QStringList &tokens, const DesktopEntry &entry,
+                          const QList<QUrl> &targets);
+
+} // namespace DesktopExec
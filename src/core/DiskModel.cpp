@@ -0,0 +1,134 @@
+#include "DiskModel.h"
+#include <QSet>
+
+DiskModel::DiskModel(QObject *parent) : QAbstractListModel(parent) {}
+
+int DiskModel::rowCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant DiskModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid() || index.row() >= m_rows.size())
+    return {};
+
+  const DiskInfo &info = m_rows.at(index.row());
+  switch (role) {
+  case Qt::DisplayRole:
+  case MountPointRole:
+    return info.mountPoint;
+  case DeviceRole:
+    return info.device;
+  case FsTypeRole:
+    return info.fsType;
+  case TotalRole:
+    return double(info.totalBytes);
+  case AvailableRole:
+    return double(info.availableBytes);
+  case UsageRole:
+    return info.usage();
+  case ReadRateRole:
+    return info.readBytesPerSec;
+  case WriteRateRole:
+    return info.writeBytesPerSec;
+  case ReadOpsRole:
+    return info.readOpsPerSec;
+  case WriteOpsRole:
+    return info.writeOpsPerSec;
+  case ResponsiveRole:
+    return info.responsive;
+  }
+  return {};
+}
+
+QHash<int, QByteArray> DiskModel::roleNames() const {
+  return {{MountPointRole, "mountPoint"}, {DeviceRole, "device"},
+          {FsTypeRole, "fsType"},         {TotalRole, "total"},
+          {AvailableRole, "available"},   {UsageRole, "usage"},
+          {ReadRateRole, "readRate"},     {WriteRateRole, "writeRate"},
+          {ReadOpsRole, "readOps"},       {WriteOpsRole, "writeOps"},
+          {ResponsiveRole, "responsive"}};
+}
+
+void DiskModel::setDisks(const QVector<DiskInfo> &disks) {
+  const int oldCount = m_rows.size();
+
+  QSet<QString> mountPoints;
+  mountPoints.reserve(disks.size());
+  for (const DiskInfo &info : disks)
+    mountPoints.insert(info.mountPoint);
+
+  // Drop unmounted filesystems (bottom-up so row numbers stay valid)
+  for (int row = m_rows.size() - 1; row >= 0; --row) {
+    if (!mountPoints.contains(m_rows.at(row).mountPoint)) {
+      beginRemoveRows(QModelIndex(), row, row);
+      m_rows.removeAt(row);
+      endRemoveRows();
+    }
+  }
+
+  for (int i = 0; i < disks.size(); ++i) {
+    const DiskInfo &info = disks.at(i);
+    if (i < m_rows.size() && m_rows.at(i).mountPoint == info.mountPoint) {
+      updateRow(i, info);
+      continue;
+    }
+
+    int existing = -1;
+    for (int row = i + 1; row < m_rows.size() && existing == -1; ++row) {
+      if (m_rows.at(row).mountPoint == info.mountPoint)
+        existing = row;
+    }
+    if (existing != -1) {
+      beginMoveRows(QModelIndex(), existing, existing, QModelIndex(), i);
+      m_rows.move(existing, i);
+      endMoveRows();
+      updateRow(i, info);
+    } else {
+      beginInsertRows(QModelIndex(), i, i);
+      m_rows.insert(i, info);
+      endInsertRows();
+    }
+  }
+
+  if (m_rows.size() != oldCount)
+    emit countChanged();
+}
+
+int DiskModel::indexOf(const QString &mountPoint) const {
+  for (int row = 0; row < m_rows.size(); ++row) {
+    if (m_rows.at(row).mountPoint == mountPoint)
+      return row;
+  }
+  return -1;
+}
+
+void DiskModel::updateRow(int row, const DiskInfo &info) {
+  DiskInfo &current = m_rows[row];
+  QList<int> roles;
+  if (current.device != info.device)
+    roles << DeviceRole;
+  if (current.fsType != info.fsType)
+    roles << FsTypeRole;
+  if (current.totalBytes != info.totalBytes)
+    roles << TotalRole;
+  if (current.availableBytes != info.availableBytes)
+    roles << AvailableRole;
+  if (current.usage() != info.usage())
+    roles << UsageRole;
+  if (current.readBytesPerSec != info.readBytesPerSec)
+    roles << ReadRateRole;
+  if (current.writeBytesPerSec != info.writeBytesPerSec)
+    roles << WriteRateRole;
+  if (current.readOpsPerSec != info.readOpsPerSec)
+    roles << ReadOpsRole;
+  if (current.writeOpsPerSec != info.writeOpsPerSec)
+    roles << WriteOpsRole;
+  if (current.responsive != info.responsive)
+    roles << ResponsiveRole;
+
+  current = info;
+  if (!roles.isEmpty()) {
+    const QModelIndex idx = index(row);
+    emit dataChanged(idx, idx, roles);
+  }
+}
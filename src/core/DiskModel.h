@@ -0,0 +1,49 @@
+#pragma once
+
+#include "DiskSampler.h"
+#include <QAbstractListModel>
+#include <QQmlEngine>
+
+// Mounted filesystems as a list model (SystemMonitor.disks), updated while
+// SystemMonitor.Disk is subscribed. Rows are matched by mount point, so a
+// delegate stays put while its numbers change.
+class DiskModel : public QAbstractListModel {
+  Q_OBJECT
+  QML_ELEMENT
+  QML_UNCREATABLE("Use SystemMonitor.disks")
+  Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+  enum Roles {
+    MountPointRole = Qt::UserRole + 1,
+    DeviceRole,
+    FsTypeRole,
+    TotalRole,
+    AvailableRole,
+    UsageRole,
+    ReadRateRole,
+    WriteRateRole,
+    ReadOpsRole,
+    WriteOpsRole,
+    ResponsiveRole
+  };
+
+  explicit DiskModel(QObject *parent = nullptr);
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index, int role) const override;
+  QHash<int, QByteArray> roleNames() const override;
+
+  // Order follows `disks` (mount table order)
+  void setDisks(const QVector<DiskInfo> &disks);
+
+  Q_INVOKABLE int indexOf(const QString &mountPoint) const;
+
+signals:
+  void countChanged();
+
+private:
+  void updateRow(int row, const DiskInfo &info);
+
+  QVector<DiskInfo> m_rows;
+};
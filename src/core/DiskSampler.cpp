@@ -0,0 +1,318 @@
+#include "DiskSampler.h"
+#include <QDebug>
+#include <QMutex>
+#include <QSet>
+#include <QSocketNotifier>
+#include <QThreadPool>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <sys/sysmacros.h>
+
+using namespace ProcParse;
+
+namespace {
+
+const qsizetype StatsBufferSize = 64 * 1024;
+const qsizetype MaxMountBufferSize = 4 * 1024 * 1024;
+const int StatThreads = 4;
+const quint64 SectorSize = 512; // diskstats always counts 512-byte sectors
+
+QThreadPool *statPool() {
+  // Never deleted: a thread stuck in statvfs on a dead mount must not be
+  // waited for at exit
+  static QThreadPool *pool = [] {
+    auto *pool = new QThreadPool;
+    pool->setMaxThreadCount(StatThreads);
+    pool->setObjectName("CanvasDeskStatvfs");
+    return pool;
+  }();
+  return pool;
+}
+
+// Network filesystems have no block device but are real mounts
+bool isNetworkFs(const QByteArray &type) {
+  static const QSet<QByteArray> types = {"nfs",  "nfs4",      "cifs",
+                                         "smb3", "smbfs",     "ceph",
+                                         "9p",   "glusterfs", "fuse.sshfs"};
+  return types.contains(type);
+}
+
+// mountinfo escapes blanks, newlines and backslashes as \ooo
+QByteArray unescape(const char *p, const char *end) {
+  QByteArray out;
+  out.reserve(int(end - p));
+  while (p < end) {
+    if (*p == '\\' && end - p >= 4 && p[1] >= '0' && p[1] <= '3') {
+      out.append(char((p[1] - '0') * 64 + (p[2] - '0') * 8 + (p[3] - '0')));
+      p += 4;
+    } else {
+      out.append(*p++);
+    }
+  }
+  return out;
+}
+
+// Next blank-separated field as [*start, return value)
+const char *field(const char *p, const char *end, const char **start) {
+  *start = skipSpaces(p, end);
+  return skipField(p, end);
+}
+
+} // namespace
+
+struct DiskSampler::StatProbe {
+  QMutex mutex;
+  bool done = false;
+  bool ok = false;
+  quint64 totalBytes = 0;
+  quint64 availableBytes = 0;
+};
+
+DiskSampler::DiskSampler(const QByteArray &procRoot, QObject *parent)
+    : QObject(parent), m_mountinfo(procRoot + "/self/mountinfo"),
+      m_diskstats(procRoot + "/diskstats"),
+      m_statsBuffer(StatsBufferSize, Qt::Uninitialized) {
+  m_clock.start();
+}
+
+DiskSampler::~DiskSampler() = default;
+
+void DiskSampler::setActive(bool active) {
+  if (active == (m_notifier != nullptr))
+    return;
+
+  if (!active) {
+    delete m_notifier;
+    m_notifier = nullptr;
+    return;
+  }
+
+  // Rates from before a pause would average over the whole pause
+  m_lastCountersMs = -1;
+  for (Mount &mount : m_mounts)
+    mount.haveCounters = false;
+
+  readMounts();
+  if (!m_mountinfo.isOpen())
+    return;
+  m_notifier =
+      new QSocketNotifier(m_mountinfo.fd(), QSocketNotifier::Exception, this);
+  connect(m_notifier, &QSocketNotifier::activated, this, [this]() {
+    const int before = m_mounts.size();
+    QVector<QString> previous;
+    previous.reserve(before);
+    for (const Mount &mount : std::as_const(m_mounts))
+      previous.append(mount.info.mountPoint);
+
+    readMounts();
+
+    bool changed = m_mounts.size() != before;
+    for (int i = 0; !changed && i < before; ++i)
+      changed = m_mounts[i].info.mountPoint != previous[i];
+    if (changed)
+      emit mountsChanged();
+  });
+}
+
+bool DiskSampler::sample(QVector<DiskInfo> *disks) {
+  if (!m_notifier && m_mounts.isEmpty())
+    readMounts(); // Sampled without ever being activated
+
+  const qint64 now = m_clock.elapsed();
+  const bool haveBaseline = m_lastCountersMs >= 0;
+  const double elapsedSec =
+      haveBaseline ? (now - m_lastCountersMs) / 1000.0 : 0.0;
+  readCounters(elapsedSec);
+  m_lastCountersMs = now;
+
+  bool complete = haveBaseline;
+  for (Mount &mount : m_mounts) {
+    if (mount.probeStartMs >= 0) {
+      StatProbe &probe = *mount.probe;
+      QMutexLocker locker(&probe.mutex);
+      if (probe.done) {
+        probe.done = false;
+        mount.probeStartMs = -1;
+        mount.info.hasUsage = probe.ok;
+        mount.info.totalBytes = probe.totalBytes;
+        mount.info.availableBytes = probe.availableBytes;
+      }
+    }
+
+    if (mount.probeStartMs < 0)
+      probe(mount);
+    mount.info.responsive = now - mount.probeStartMs <= StatTimeoutMs;
+    if (!mount.info.hasUsage && mount.info.responsive)
+      complete = false;
+  }
+
+  if (disks->size() != m_mounts.size())
+    disks->resize(m_mounts.size());
+  for (int i = 0; i < m_mounts.size(); ++i)
+    (*disks)[i] = m_mounts[i].info;
+  return complete;
+}
+
+void DiskSampler::probe(Mount &mount) {
+  if (!mount.probe)
+    mount.probe = std::make_shared<StatProbe>();
+  mount.probeStartMs = m_clock.elapsed();
+
+  statPool()->start([probe = mount.probe, path = mount.path]() {
+    struct statvfs buffer;
+    const bool ok = statvfs(path.constData(), &buffer) == 0;
+
+    QMutexLocker locker(&probe->mutex);
+    probe->done = true;
+    probe->ok = ok && buffer.f_blocks > 0;
+    if (probe->ok) {
+      probe->totalBytes = quint64(buffer.f_blocks) * buffer.f_frsize;
+      probe->availableBytes = quint64(buffer.f_bavail) * buffer.f_frsize;
+    }
+  });
+}
+
+void DiskSampler::readMounts() {
+  if (m_mountBuffer.isEmpty())
+    m_mountBuffer.resize(StatsBufferSize);
+
+  qsizetype n = 0;
+  for (;;) {
+    n = m_mountinfo.read(m_mountBuffer.data(), m_mountBuffer.size());
+    if (n < m_mountBuffer.size() - 1 ||
+        m_mountBuffer.size() >= MaxMountBufferSize)
+      break;
+    m_mountBuffer.resize(m_mountBuffer.size() * 2); // Possibly truncated
+  }
+  if (n <= 0) {
+    qWarning() << "[DiskSampler] Cannot read" << m_mountinfo.path();
+    return;
+  }
+
+  QVector<Mount> mounts;
+  QSet<quint64> devices;
+  const char *end = m_mountBuffer.constData() + n;
+  for (const char *line = m_mountBuffer.constData(); line < end;
+       line = nextLine(line, end)) {
+    // id parent major:minor root mount-point options [optional...] - type
+    // source super-options
+    const char *lineEnd = nextLine(line, end);
+    const char *start = nullptr;
+    const char *p = field(line, lineEnd, &start); // id
+    p = field(p, lineEnd, &start);                // parent
+
+    quint64 devMajor = 0, devMinor = 0;
+    p = parseU64(skipSpaces(p, lineEnd), lineEnd, &devMajor);
+    if (p < lineEnd && *p == ':')
+      ++p;
+    p = parseU64(p, lineEnd, &devMinor);
+
+    p = field(p, lineEnd, &start); // root
+    const char *mountStart = nullptr;
+    p = field(p, lineEnd, &mountStart);
+    const char *mountEnd = p;
+    p = field(p, lineEnd, &start); // options
+
+    // Optional fields end with a lone "-"
+    do {
+      p = field(p, lineEnd, &start);
+    } while (p < lineEnd && !(p - start == 1 && *start == '-'));
+
+    const char *typeStart = nullptr;
+    p = field(p, lineEnd, &typeStart);
+    const QByteArray type(typeStart, int(p - typeStart));
+    const char *sourceStart = nullptr;
+    p = field(p, lineEnd, &sourceStart);
+    const QByteArray source = unescape(sourceStart, p);
+    const QByteArray path = unescape(mountStart, mountEnd);
+    if (path.isEmpty() || type.isEmpty())
+      continue;
+
+    // Block devices (loop-mounted squashfs images aside) and network shares
+    const bool isRoot = path == "/";
+    const bool blockBacked = source.startsWith("/dev/") && type != "squashfs";
+    if (!isRoot && !blockBacked && !isNetworkFs(type))
+      continue;
+
+    // mountinfo has 0:N for btrfs and similar; diskstats needs the device
+    // node's own number
+    quint64 device = devMajor > 0 ? devMajor << 32 | devMinor : 0;
+    struct stat node;
+    if (blockBacked && ::stat(source.constData(), &node) == 0 &&
+        S_ISBLK(node.st_mode))
+      device = quint64(::major(node.st_rdev)) << 32 | ::minor(node.st_rdev);
+
+    // Bind mounts and subvolumes show the same filesystem again
+    if (device != 0 && devices.contains(device))
+      continue;
+    devices.insert(device);
+
+    Mount mount;
+    for (const Mount &existing : std::as_const(m_mounts)) {
+      if (existing.path == path && existing.device == device) {
+        mount = existing; // Keeps counters and any outstanding statvfs
+        break;
+      }
+    }
+    mount.path = path;
+    mount.device = blockBacked ? device : 0;
+    mount.info.mountPoint = QString::fromUtf8(path);
+    mount.info.device = QString::fromUtf8(source);
+    mount.info.fsType = QString::fromLatin1(type);
+    mounts.append(mount);
+  }
+  m_mounts = mounts;
+}
+
+void DiskSampler::readCounters(double elapsedSec) {
+  char *buffer = m_statsBuffer.data();
+  const qsizetype n = m_diskstats.read(buffer, StatsBufferSize);
+  if (n <= 0)
+    return;
+
+  // major minor name reads merged sectors ms writes merged sectors ...
+  const char *end = buffer + n;
+  for (const char *line = buffer; line < end; line = nextLine(line, end)) {
+    quint64 devMajor = 0, devMinor = 0;
+    const char *p = parseU64(line, end, &devMajor);
+    p = parseU64(p, end, &devMinor);
+    const quint64 device = devMajor << 32 | devMinor;
+
+    Mount *mount = nullptr;
+    for (Mount &candidate : m_mounts) {
+      if (candidate.device == device) {
+        mount = &candidate;
+        break;
+      }
+    }
+    if (!mount)
+      continue;
+
+    quint64 reads = 0, sectorsRead = 0, writes = 0, sectorsWritten = 0;
+    p = skipField(p, end); // name
+    p = parseU64(p, end, &reads);
+    p = skipField(p, end); // reads merged
+    p = parseU64(p, end, &sectorsRead);
+    p = skipField(p, end); // ms reading
+    p = parseU64(p, end, &writes);
+    p = skipField(p, end); // writes merged
+    parseU64(p, end, &sectorsWritten);
+
+    DiskInfo &info = mount->info;
+    if (mount->haveCounters && elapsedSec > 0.001) {
+      auto rate = [elapsedSec](quint64 now, quint64 prev) {
+        return now >= prev ? (now - prev) / elapsedSec : 0.0;
+      };
+      info.readOpsPerSec = rate(reads, mount->reads);
+      info.writeOpsPerSec = rate(writes, mount->writes);
+      info.readBytesPerSec = rate(sectorsRead, mount->sectorsRead) * SectorSize;
+      info.writeBytesPerSec =
+          rate(sectorsWritten, mount->sectorsWritten) * SectorSize;
+    }
+    mount->reads = reads;
+    mount->writes = writes;
+    mount->sectorsRead = sectorsRead;
+    mount->sectorsWritten = sectorsWritten;
+    mount->haveCounters = true;
+  }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "ProcFile.h"
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <memory>
+
+class QSocketNotifier;
+
+// One mounted filesystem as shown by the disk model
+struct DiskInfo {
+  QString mountPoint;
+  QString device; // Mount source, e.g. /dev/nvme0n1p2 or server:/export
+  QString fsType;
+  quint64 totalBytes = 0;
+  quint64 availableBytes = 0; // For unprivileged users, as df shows
+  bool hasUsage = false;      // False until the first statvfs returns
+  bool responsive = true;     // False while statvfs has hung past the timeout
+  double readBytesPerSec = 0.0;
+  double writeBytesPerSec = 0.0;
+  double readOpsPerSec = 0.0;
+  double writeOpsPerSec = 0.0;
+
+  double usage() const {
+    return totalBytes > 0
+               ? double(totalBytes - qMin(availableBytes, totalBytes)) /
+                     totalBytes
+               : 0.0;
+  }
+};
+
+// Mounted filesystems with their usage and I/O rates, for the monitor thread.
+//
+// The mount list comes from /proc/self/mountinfo and is only re-read when
+// the kernel flags a change on it (POLLPRI, via a QSocketNotifier), not on
+// every sample. Only block-backed and network filesystems are kept, plus
+// "/". Throughput and IOPS are /proc/diskstats deltas matched to each mount
+// by device number.
+//
+// statvfs() can block indefinitely on a dead network mount, so it runs on a
+// small pool of its own: each sample reports the last finished result, and a
+// mount whose call is still outstanding after StatTimeoutMs is reported as
+// unresponsive instead of holding up the other metrics.
+class DiskSampler : public QObject {
+  Q_OBJECT
+
+public:
+  static constexpr int StatTimeoutMs = 2000;
+
+  explicit DiskSampler(const QByteArray &procRoot = "/proc",
+                       QObject *parent = nullptr);
+  ~DiskSampler() override;
+
+  // Watches the mount table while active
+  void setActive(bool active);
+
+  // Reads I/O counters and starts new statvfs calls. Returns false while a
+  // mount still has no usage and is not yet overdue, or there is no rate
+  // baseline yet; `disks` is filled either way.
+  bool sample(QVector<DiskInfo> *disks);
+
+signals:
+  // Mounts were added or removed
+  void mountsChanged();
+
+private:
+  struct StatProbe;
+
+  struct Mount {
+    DiskInfo info;
+    QByteArray path;
+    quint64 device = 0; // major << 32 | minor, 0 = no block device
+    quint64 reads = 0, writes = 0, sectorsRead = 0, sectorsWritten = 0;
+    bool haveCounters = false;
+    std::shared_ptr<StatProbe> probe;
+    qint64 probeStartMs = -1; // m_clock ms of the outstanding call, -1 = idle
+  };
+
+  void readMounts();
+  void readCounters(double elapsedSec);
+  void probe(Mount &mount);
+
+  ProcFile m_mountinfo;
+  ProcFile m_diskstats;
+  QSocketNotifier *m_notifier = nullptr;
+  QByteArray m_mountBuffer; // Grows to fit mountinfo; only read on changes
+  QByteArray m_statsBuffer;
+  QVector<Mount> m_mounts;
+  QElapsedTimer m_clock;
+  qint64 m_lastCountersMs = -1;
+};
@@ -0,0 +1,164 @@
+#include "HwmonSampler.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+#include <algorithm>
+
+namespace {
+
+// Chips that measure the CPU package, and the labels that mean "package"
+const char *const CpuChips[] = {"coretemp", "k10temp", "zenpower",
+                                "cpu_thermal", "soc_thermal"};
+const char *const PackageLabels[] = {"Package id 0", "Tctl", "Tdie"};
+
+QString readSmallFile(const QString &path) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly))
+    return {};
+  return QString::fromUtf8(file.readAll()).trimmed();
+}
+
+bool isCpuChip(const QString &chip) {
+  for (const char *name : CpuChips) {
+    if (chip == QLatin1String(name))
+      return true;
+  }
+  return false;
+}
+
+} // namespace
+
+HwmonSampler::HwmonSampler(const QByteArray &sysRoot) : m_sysRoot(sysRoot) {}
+
+void HwmonSampler::discover() {
+  m_discovered = true;
+  m_sensors.clear();
+  m_inputs.clear();
+  m_frequencies.clear();
+  m_maxFrequency = 0.0;
+
+  const QString sysRoot = QString::fromLocal8Bit(m_sysRoot);
+  static const QRegularExpression inputPattern("^(temp|fan)(\\d+)_input$");
+
+  QDir hwmonDir(sysRoot + "/class/hwmon");
+  const QStringList chips =
+      hwmonDir.entryList({"hwmon*"}, QDir::Dirs | QDir::NoDotAndDotDot,
+                         QDir::Name);
+  for (const QString &entry : chips) {
+    QString dir = hwmonDir.filePath(entry);
+    // Drivers from before 3.x keep the attributes under device/
+    if (!QFile::exists(dir + "/name") && QFile::exists(dir + "/device/name"))
+      dir += "/device";
+
+    const QString chip = readSmallFile(dir + "/name");
+    const bool cpuChip = isCpuChip(chip);
+    const int firstOfChip = m_sensors.size();
+    bool havePackage = false;
+
+    const QStringList files =
+        QDir(dir).entryList({"temp*_input", "fan*_input"}, QDir::Files,
+                            QDir::Name);
+    for (const QString &file : files) {
+      const QRegularExpressionMatch match = inputPattern.match(file);
+      if (!match.hasMatch())
+        continue;
+
+      Input input;
+      if (!input.file.open(QFile::encodeName(dir + "/" + file)))
+        continue;
+
+      SensorInfo sensor;
+      sensor.chip = chip;
+      sensor.kind = match.captured(1) == QLatin1String("temp")
+                        ? SensorInfo::Temperature
+                        : SensorInfo::Fan;
+      sensor.label = readSmallFile(dir + "/" + match.captured(1) +
+                                   match.captured(2) + "_label");
+      if (sensor.label.isEmpty())
+        sensor.label = match.captured(1) + match.captured(2);
+      input.scale = sensor.kind == SensorInfo::Temperature ? 0.001 : 1.0;
+
+      if (cpuChip && sensor.kind == SensorInfo::Temperature) {
+        for (const char *label : PackageLabels)
+          havePackage = havePackage || sensor.label == QLatin1String(label);
+      }
+      m_sensors.append(sensor);
+      m_inputs.push_back(std::move(input));
+    }
+
+    // The package sensor if the chip has one, else all its temperatures
+    for (int i = firstOfChip; cpuChip && i < m_sensors.size(); ++i) {
+      SensorInfo &sensor = m_sensors[i];
+      if (sensor.kind != SensorInfo::Temperature)
+        continue;
+      bool package = false;
+      for (const char *label : PackageLabels)
+        package = package || sensor.label == QLatin1String(label);
+      sensor.cpu = package || !havePackage;
+    }
+  }
+
+  QDir cpuDir(sysRoot + "/devices/system/cpu");
+  const QStringList cpus = cpuDir.entryList({"cpu[0-9]*"}, QDir::Dirs);
+  for (const QString &cpu : cpus) {
+    const QString dir = cpuDir.filePath(cpu) + "/cpufreq";
+    ProcFile file;
+    if (!file.open(QFile::encodeName(dir + "/scaling_cur_freq")))
+      continue;
+    m_frequencies.push_back(std::move(file));
+    m_maxFrequency =
+        std::max(m_maxFrequency,
+                 readSmallFile(dir + "/cpuinfo_max_freq").toDouble() / 1000.0);
+  }
+
+  qDebug() << "[HwmonSampler] Found" << m_sensors.size() << "sensors and"
+           << m_frequencies.size() << "CPU clocks";
+}
+
+bool HwmonSampler::read(QVector<SensorInfo> *sensors, double *cpuTemperature,
+                        double *cpuFrequency, double *cpuMaxFrequency) {
+  if (!m_discovered)
+    discover();
+  if (m_inputs.empty() && m_frequencies.empty())
+    return false;
+
+  *cpuTemperature = 0.0;
+  for (size_t i = 0; i < m_inputs.size(); ++i) {
+    SensorInfo &sensor = m_sensors[int(i)];
+    double raw = 0.0;
+    if (readNumber(m_inputs[i].file, &raw))
+      sensor.value = raw * m_inputs[i].scale;
+    if (sensor.cpu)
+      *cpuTemperature = std::max(*cpuTemperature, sensor.value);
+  }
+  // Implicitly shared: no copy unless the caller writes to it
+  *sensors = m_sensors;
+
+  double sum = 0.0;
+  int count = 0;
+  for (ProcFile &file : m_frequencies) {
+    double khz = 0.0;
+    if (readNumber(file, &khz)) {
+      sum += khz;
+      ++count;
+    }
+  }
+  *cpuFrequency = count > 0 ? sum / count / 1000.0 : 0.0;
+  *cpuMaxFrequency = m_maxFrequency;
+  return true;
+}
+
+bool HwmonSampler::readNumber(ProcFile &file, double *value) {
+  // A sensor that is asleep or gone returns an error; keep its last value
+  const qsizetype n = file.read(m_buffer, sizeof(m_buffer));
+  if (n <= 0)
+    return false;
+  bool ok = false;
+  const char *p = m_buffer;
+  const bool negative = *p == '-'; // Sub-zero temperatures exist
+  quint64 magnitude = 0;
+  ProcParse::parseU64(p + (negative ? 1 : 0), m_buffer + n, &magnitude, &ok);
+  *value = negative ? -double(magnitude) : double(magnitude);
+  return ok;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "ProcFile.h"
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <vector>
+
+// One hwmon input
+struct SensorInfo {
+  enum Kind { Temperature, Fan };
+
+  QString chip;  // hwmon "name", e.g. coretemp, k10temp, nvme
+  QString label; // tempN_label / fanN_label, else "tempN" / "fanN"
+  Kind kind = Temperature;
+  double value = 0.0; // °C or RPM
+  bool cpu = false;   // Counts towards the CPU temperature
+
+  bool operator==(const SensorInfo &other) const = default;
+};
+
+// Temperatures, fan speeds (<sys>/class/hwmon) and CPU clocks
+// (<sys>/devices/system/cpu/cpuN/cpufreq).
+//
+// The tree is walked once, on the first read; every *_input and
+// scaling_cur_freq file found then stays open and is pread into a small
+// fixed buffer on each sample. Sensors that appear later (a hot-plugged
+// drive) are not picked up until rediscover().
+class HwmonSampler {
+public:
+  explicit HwmonSampler(const QByteArray &sysRoot = "/sys");
+
+  void rediscover() { m_discovered = false; }
+
+  // `sensors` is rebuilt only when discovery changes it; otherwise values
+  // are updated in place. Frequencies are MHz; 0 when cpufreq is missing.
+  bool read(QVector<SensorInfo> *sensors, double *cpuTemperature,
+            double *cpuFrequency, double *cpuMaxFrequency);
+
+private:
+  struct Input {
+    ProcFile file;
+    double scale; // Raw value to °C (millidegrees) or RPM
+  };
+
+  void discover();
+  bool readNumber(ProcFile &file, double *value);
+
+  QByteArray m_sysRoot;
+  bool m_discovered = false;
+  QVector<SensorInfo> m_sensors; // Parallel to m_inputs
+  std::vector<Input> m_inputs;
+  std::vector<ProcFile> m_frequencies; // kHz
+  double m_maxFrequency = 0.0;         // MHz, read once
+  char m_buffer[64];
+};
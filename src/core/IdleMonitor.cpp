@@ -0,0 +1,35 @@
+#include "IdleMonitor.h"
+#include <QDebug>
+#include <X11/Xlib.h>
+#include <X11/extensions/scrnsaver.h>
+
+IdleMonitor::IdleMonitor() {
+  // Own connection: the window manager's is busy with its event loop
+  Display *display = XOpenDisplay(nullptr);
+  if (!display)
+    return;
+  int eventBase = 0;
+  int errorBase = 0;
+  if (!XScreenSaverQueryExtension(display, &eventBase, &errorBase)) {
+    qInfo() << "[IdleMonitor] No MIT-SCREEN-SAVER extension; idle state "
+               "unknown";
+    XCloseDisplay(display);
+    return;
+  }
+  m_display = display;
+}
+
+IdleMonitor::~IdleMonitor() {
+  if (m_display)
+    XCloseDisplay(m_display);
+}
+
+bool IdleMonitor::isIdle(qint64 thresholdMs) const {
+  if (!m_display)
+    return false;
+  XScreenSaverInfo info;
+  if (!XScreenSaverQueryInfo(m_display, DefaultRootWindow(m_display), &info))
+    return false;
+  return info.state == ScreenSaverOn ||
+         (thresholdMs > 0 && qint64(info.idle) >= thresholdMs);
+}
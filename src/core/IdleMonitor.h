@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QtGlobal>
+
+struct _XDisplay;
+
+// Whether anyone is looking at the screen, from the X server's
+// MIT-SCREEN-SAVER extension: the time since the last input event and whether
+// the server screen saver is active. Screen lockers driven by it (xss-lock,
+// light-locker, xautolock) and DPMS blanking both show up as active. Without
+// an X display or the extension, the screen always reads as attended.
+class IdleMonitor {
+public:
+  IdleMonitor();
+  ~IdleMonitor();
+  IdleMonitor(const IdleMonitor &) = delete;
+  IdleMonitor &operator=(const IdleMonitor &) = delete;
+
+  bool isAvailable() const { return m_display != nullptr; }
+
+  // Screen saver or locker on, or no input for `thresholdMs`. One round trip.
+  bool isIdle(qint64 thresholdMs) const;
+
+private:
+  _XDisplay *m_display = nullptr;
+};
@@ -0,0 +1,80 @@
+#include "LayoutClient.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalSocket>
+
+static const int RetryIntervalMs = 100;
+static const int MaxRetries = 50; // ~5s for the runtime to come up
+
+LayoutClient::LayoutClient(QObject *parent) : QObject(parent) {
+  m_socket = new QLocalSocket(this);
+  connect(m_socket, &QLocalSocket::connected, this, [this]() {
+    qInfo() << "[LayoutClient] Connected to runtime at" << m_socketName;
+    m_retryTimer.stop();
+    emit connectedChanged();
+  });
+  connect(m_socket, &QLocalSocket::disconnected, this, [this]() {
+    qInfo() << "[LayoutClient] Runtime disconnected";
+    emit connectedChanged();
+  });
+  connect(m_socket, &QLocalSocket::errorOccurred, this,
+          [this](QLocalSocket::LocalSocketError) {
+            // Runtime not listening yet
+            if (m_retriesLeft > 0 && !m_retryTimer.isActive())
+              m_retryTimer.start();
+          });
+  connect(m_socket, &QLocalSocket::readyRead, this,
+          &LayoutClient::readMessages);
+
+  m_retryTimer.setSingleShot(true);
+  m_retryTimer.setInterval(RetryIntervalMs);
+  connect(&m_retryTimer, &QTimer::timeout, this, &LayoutClient::tryConnect);
+}
+
+void LayoutClient::connectToRuntime(const QString &socketName) {
+  m_socketName = socketName;
+  m_retriesLeft = MaxRetries;
+  m_socket->abort();
+  tryConnect();
+}
+
+bool LayoutClient::isConnected() const {
+  return m_socket->state() == QLocalSocket::ConnectedState;
+}
+
+void LayoutClient::sendLayout(const QVariantMap &layout) {
+  send({{"op", "layout"}, {"layout", QJsonObject::fromVariantMap(layout)}});
+}
+
+void LayoutClient::sendPatches(const QVariantList &patches) {
+  send({{"op", "patches"}, {"patches", QJsonArray::fromVariantList(patches)}});
+}
+
+void LayoutClient::tryConnect() {
+  if (isConnected() || m_socketName.isEmpty())
+    return;
+  m_retriesLeft--;
+  m_socket->abort();
+  m_socket->connectToServer(m_socketName);
+}
+
+void LayoutClient::send(QJsonObject message) {
+  if (!isConnected())
+    return;
+  message["sentAt"] = double(QDateTime::currentMSecsSinceEpoch());
+  m_socket->write(QJsonDocument(message).toJson(QJsonDocument::Compact) +
+                  '\n');
+  m_socket->flush();
+}
+
+void LayoutClient::readMessages() {
+  while (m_socket->canReadLine()) {
+    const QJsonObject message =
+        QJsonDocument::fromJson(m_socket->readLine().trimmed()).object();
+    if (message.value("op").toString() == "resync")
+      emit resyncRequested();
+  }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVariantList>
+#include <QVariantMap>
+
+class QJsonObject;
+class QLocalSocket;
+
+// Editor side of the live layout channel (see LayoutServer for the protocol).
+// Retries the connection for a while so it can be started right after the
+// runtime process is launched.
+class LayoutClient : public QObject {
+  Q_OBJECT
+
+public:
+  explicit LayoutClient(QObject *parent = nullptr);
+
+  void connectToRuntime(const QString &socketName);
+  bool isConnected() const;
+
+  void sendLayout(const QVariantMap &layout);
+  void sendPatches(const QVariantList &patches);
+
+signals:
+  void connectedChanged();
+  void resyncRequested();
+
+private:
+  void tryConnect();
+  void send(QJsonObject message);
+  void readMessages();
+
+  QLocalSocket *m_socket = nullptr;
+  QTimer m_retryTimer;
+  QString m_socketName;
+  int m_retriesLeft = 0;
+};
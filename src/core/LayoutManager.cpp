@@ -1,30 +1,91 @@
 #include "LayoutManager.h"
+#include "ComponentDiff.h"
+#include "LayoutClient.h"
+#include "PersistenceService.h"
+#include "SceneModel.h"
 #include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 #include <QProcess>
 #include <QProcessEnvironment>
 #include <QTextStream>
 
-LayoutManager::LayoutManager(QObject *parent) : QObject(parent) {}
+LayoutManager::LayoutManager(QObject *parent) : QObject(parent) {
+  m_client = new LayoutClient(this);
+  connect(m_client, &LayoutClient::connectedChanged, this, [this]() {
+    // The runtime may have started from an older file; sync it up front
+    if (m_client->isConnected())
+      sendFullLayout();
+    emit runtimeConnectedChanged();
+  });
+  connect(m_client, &LayoutClient::resyncRequested, this,
+          &LayoutManager::sendFullLayout);
+  connect(PersistenceService::instance(), &PersistenceService::writeFinished,
+          this, &LayoutManager::onWriteFinished);
+}
+
+bool LayoutManager::runtimeConnected() const {
+  return m_client->isConnected();
+}
+
+void LayoutManager::pushLayout(const QString &jsonContent) {
+  QElapsedTimer timer;
+  timer.start();
+
+  Component *next =
+      SceneModel::buildTree(SceneModel::toLayoutMap(jsonContent), this);
+  QList<ComponentPatch> patches = ComponentDiff::diff(m_pushedScene, next);
+  delete m_pushedScene;
+  m_pushedScene = next;
+
+  if (!m_client->isConnected() || patches.isEmpty())
+    return;
+
+  m_client->sendPatches(ComponentDiff::toVariantList(patches));
+  qDebug() << "[LayoutManager] Pushed" << patches.size() << "patches in"
+           << timer.nsecsElapsed() / 1000 << "us";
+}
+
+void LayoutManager::sendFullLayout() {
+  m_client->sendLayout(SceneModel::toLayout(m_pushedScene));
+}
 
 bool LayoutManager::saveLayout(const QString &path,
                                const QString &jsonContent) {
-  QFile file(path);
-  if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+  QFileInfo info(path);
+  QFileInfo dirInfo(info.absolutePath());
+  if (!dirInfo.isDir() || !dirInfo.isWritable()) {
     qWarning() << "Failed to open file for writing:" << path;
     return false;
   }
 
-  QTextStream out(&file);
-  out << jsonContent;
-  file.close();
+  // Written asynchronously (debounced, atomic replace)
+  m_savedPaths.insert(info.absoluteFilePath());
+  PersistenceService::instance()->scheduleWrite(info.absoluteFilePath(),
+                                                jsonContent.toUtf8());
   return true;
 }
 
+void LayoutManager::onWriteFinished(const QString &path, bool ok) {
+  if (!m_savedPaths.contains(path))
+    return; // Someone else's file
+  if (ok)
+    emit layoutSaved(path);
+  else
+    emit saveFailed(path);
+}
+
 QString LayoutManager::loadLayout(const QString &path) {
+  // A save that hasn't hit the disk yet wins over the file contents
+  QByteArray pending;
+  if (PersistenceService::instance()->pendingContents(
+          QFileInfo(path).absoluteFilePath(), &pending)) {
+    return QString::fromUtf8(pending);
+  }
+
   QFile file(path);
   if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
     qWarning() << "Failed to open file for reading:" << path;
@@ -36,7 +97,11 @@ QString LayoutManager::loadLayout(const QString &path) {
 }
 
 void LayoutManager::runProject(const QString &path) {
-  Q_UNUSED(path); // For now, runtime always loads layout.json from current dir
+  // Runtime still attached: update it in place instead of starting another
+  if (m_client->isConnected()) {
+    pushLayout(loadLayout(path));
+    return;
+  }
 
   // Find the runtime executable relative to the editor
   QString runtimePath;
@@ -57,6 +122,13 @@ void LayoutManager::runProject(const QString &path) {
 
   qDebug() << "Launching runtime:" << runtimePath;
 
+  // Make sure the runtime reads the latest layout
+  // (for now, runtime always loads layout.json from its working directory)
+  PersistenceService::instance()->flush();
+  delete m_pushedScene;
+  m_pushedScene =
+      SceneModel::buildTree(SceneModel::toLayoutMap(loadLayout(path)), this);
+
   // Set working directory to build root so runtime finds layout.json
   // Runtime is at: build/src/app/canvasdesk-runtime
   // We need to go to: build/
@@ -91,6 +163,11 @@ void LayoutManager::runProject(const QString &path) {
   }
   env.insert("QML2_IMPORT_PATH", qmlPath);
 
+  // Channel for live layout updates (see LayoutServer)
+  const QString socketName = QString("canvasdesk-layout-%1")
+                                 .arg(QCoreApplication::applicationPid());
+  env.insert("CANVASDESK_LAYOUT_SOCKET", socketName);
+
   process->setProcessEnvironment(env);
 
   process->start(runtimePath, QStringList());
@@ -101,5 +178,6 @@ void LayoutManager::runProject(const QString &path) {
   } else {
     qDebug() << "Runtime started successfully";
     // Don't delete process - let it run independently
+    m_client->connectToRuntime(socketName);
   }
 }
@@ -2,16 +2,42 @@
 
 #include <QObject>
 #include <QQmlEngine>
+#include <QSet>
 #include <QString>
 
+class Component;
+class LayoutClient;
+
 class LayoutManager : public QObject {
   Q_OBJECT
   QML_ELEMENT
+  Q_PROPERTY(bool runtimeConnected READ runtimeConnected NOTIFY
+                 runtimeConnectedChanged)
 
 public:
   explicit LayoutManager(QObject *parent = nullptr);
 
+  // Queues a debounced, atomic write; true means queued, not written. The
+  // outcome arrives later as layoutSaved() or saveFailed().
   Q_INVOKABLE bool saveLayout(const QString &path, const QString &jsonContent);
   Q_INVOKABLE QString loadLayout(const QString &path);
+  // Launches the runtime, or pushes the layout live if one is already attached
   Q_INVOKABLE void runProject(const QString &path);
+  // Send the changes since the last push to the attached runtime
+  Q_INVOKABLE void pushLayout(const QString &jsonContent);
+
+  bool runtimeConnected() const;
+
+signals:
+  void runtimeConnectedChanged();
+  void layoutSaved(const QString &path);
+  void saveFailed(const QString &path);
+
+private:
+  void sendFullLayout();
+  void onWriteFinished(const QString &path, bool ok);
+
+  LayoutClient *m_client = nullptr;
+  QSet<QString> m_savedPaths; // Whose write results are ours to report
+  Component *m_pushedScene = nullptr; // What the runtime is showing
 };
@@ -0,0 +1,107 @@
+#include "LayoutServer.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+LayoutServer::LayoutServer(QObject *parent) : QObject(parent) {
+  m_server = new QLocalServer(this);
+  m_server->setSocketOptions(QLocalServer::UserAccessOption);
+  connect(m_server, &QLocalServer::newConnection, this,
+          &LayoutServer::onNewConnection);
+
+  // Launched from the editor's Run button
+  setSocketName(qEnvironmentVariable("CANVASDESK_LAYOUT_SOCKET"));
+}
+
+LayoutServer::~LayoutServer() {
+  if (m_server->isListening())
+    m_server->close();
+}
+
+void LayoutServer::setSocketName(const QString &name) {
+  if (m_socketName == name)
+    return;
+  m_socketName = name;
+  emit socketNameChanged();
+  listen();
+}
+
+bool LayoutServer::isListening() const { return m_server->isListening(); }
+
+void LayoutServer::listen() {
+  if (m_server->isListening())
+    m_server->close();
+
+  if (!m_socketName.isEmpty()) {
+    // Clean up a stale socket left by a crashed runtime
+    QLocalServer::removeServer(m_socketName);
+    if (m_server->listen(m_socketName)) {
+      qInfo() << "[LayoutServer] Listening for live layout updates on"
+              << m_server->fullServerName();
+    } else {
+      qWarning() << "[LayoutServer] Failed to listen on" << m_socketName << ":"
+                 << m_server->errorString();
+    }
+  }
+
+  emit listeningChanged();
+}
+
+void LayoutServer::requestResync() {
+  const QByteArray message =
+      QJsonDocument(QJsonObject{{"op", "resync"}}).toJson(QJsonDocument::Compact) +
+      '\n';
+  for (QLocalSocket *socket : m_clients)
+    socket->write(message);
+}
+
+void LayoutServer::onNewConnection() {
+  while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+    qInfo() << "[LayoutServer] Editor connected";
+    m_clients.append(socket);
+
+    connect(socket, &QLocalSocket::readyRead, this,
+            [this, socket]() { readMessages(socket); });
+    connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+      qInfo() << "[LayoutServer] Editor disconnected";
+      m_clients.removeOne(socket);
+      socket->deleteLater();
+    });
+  }
+}
+
+void LayoutServer::readMessages(QLocalSocket *socket) {
+  while (socket->canReadLine()) {
+    const QByteArray line = socket->readLine().trimmed();
+    if (line.isEmpty())
+      continue;
+
+    QJsonParseError error;
+    const QJsonObject message = QJsonDocument::fromJson(line, &error).object();
+    if (error.error != QJsonParseError::NoError) {
+      qWarning() << "[LayoutServer] Dropping malformed message:"
+                 << error.errorString();
+      continue;
+    }
+
+    const QString op = message.value("op").toString();
+    const qint64 latency =
+        QDateTime::currentMSecsSinceEpoch() -
+        qint64(message.value("sentAt").toDouble());
+
+    if (op == "layout") {
+      qDebug() << "[LayoutServer] Full layout received after" << latency
+               << "ms";
+      emit layoutReceived(message.value("layout").toObject().toVariantMap());
+    } else if (op == "patches") {
+      const QVariantList patches =
+          message.value("patches").toArray().toVariantList();
+      qDebug() << "[LayoutServer]" << patches.size()
+               << "patches received after" << latency << "ms";
+      emit patchesReceived(patches);
+    }
+  }
+}
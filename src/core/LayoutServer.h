@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QQmlEngine>
+#include <QVariantList>
+#include <QVariantMap>
+
+class QLocalServer;
+class QLocalSocket;
+
+// Runtime side of the editor -> runtime live layout channel.
+//
+// Listens on a local (Unix domain) socket, by default the one named by
+// $CANVASDESK_LAYOUT_SOCKET. Messages are compact JSON objects, one per line:
+//   {"op":"layout","layout":{...}}   full layout (diff it against the scene)
+//   {"op":"patches","patches":[...]} ComponentDiff patches
+// The runtime can answer {"op":"resync"} when patches don't match its scene.
+class LayoutServer : public QObject {
+  Q_OBJECT
+  QML_ELEMENT
+  Q_PROPERTY(QString socketName READ socketName WRITE setSocketName NOTIFY
+                 socketNameChanged)
+  Q_PROPERTY(bool listening READ isListening NOTIFY listeningChanged)
+
+public:
+  explicit LayoutServer(QObject *parent = nullptr);
+  ~LayoutServer();
+
+  QString socketName() const { return m_socketName; }
+  void setSocketName(const QString &name);
+  bool isListening() const;
+
+  // Ask connected editors to send their full layout again
+  Q_INVOKABLE void requestResync();
+
+signals:
+  void socketNameChanged();
+  void listeningChanged();
+  void layoutReceived(const QVariantMap &layout);
+  void patchesReceived(const QVariantList &patches);
+
+private:
+  void listen();
+  void onNewConnection();
+  void readMessages(QLocalSocket *socket);
+
+  QLocalServer *m_server = nullptr;
+  QList<QLocalSocket *> m_clients;
+  QString m_socketName;
+};
@@ -0,0 +1,213 @@
+#include "MetricArchive.h"
+#include <QDebug>
+#include <QFile>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+struct TierSpec {
+  int period;
+  int capacity;
+};
+
+const TierSpec Tiers[MetricArchive::TierCount] = {
+    {1, 3600},   // 1 hour
+    {60, 1440},  // 1 day
+    {3600, 720}, // 30 days
+};
+
+const char Magic[8] = {'C', 'D', 'M', 'E', 'T', 'R', 'I', 'C'};
+constexpr quint32 Version = 1;
+
+struct FileHeader {
+  char magic[8];
+  quint32 version;
+  quint32 tierCount;
+};
+
+// Native byte order: the file never leaves this machine
+struct TierHeader {
+  quint32 period;
+  quint32 capacity;
+  quint32 head;  // Oldest slot
+  quint32 count; // Slots in use
+  qint64 bucket; // Of the newest slot
+  double sum;    // Samples folded into the newest slot
+  quint32 samples;
+  quint32 reserved;
+};
+
+constexpr qsizetype HeadersSize =
+    sizeof(FileHeader) + MetricArchive::TierCount * sizeof(TierHeader);
+
+constexpr qsizetype dataOffset(int tierIndex) {
+  qsizetype offset = HeadersSize;
+  for (int i = 0; i < tierIndex; ++i)
+    offset += Tiers[i].capacity * qsizetype(sizeof(float));
+  return offset;
+}
+
+constexpr qsizetype FileSize = dataOffset(MetricArchive::TierCount);
+
+TierHeader *tierHeader(unsigned char *map, int index) {
+  return reinterpret_cast<TierHeader *>(map + sizeof(FileHeader)) + index;
+}
+
+float *tierData(unsigned char *map, int index) {
+  return reinterpret_cast<float *>(map + dataOffset(index));
+}
+
+} // namespace
+
+int MetricArchive::period(Tier tier) { return Tiers[tier].period; }
+
+int MetricArchive::capacity(Tier tier) { return Tiers[tier].capacity; }
+
+MetricArchive::MetricArchive(const QString &path) {
+  const QByteArray file = QFile::encodeName(path);
+  m_fd = ::open(file.constData(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (m_fd < 0) {
+    const int error = errno;
+    qWarning() << "[MetricArchive] Cannot open" << path << strerror(error);
+    return;
+  }
+
+  // Another instance already records here: watch its file instead
+  m_writable = ::flock(m_fd, LOCK_EX | LOCK_NB) == 0;
+
+  struct stat info;
+  const bool sized = ::fstat(m_fd, &info) == 0 && info.st_size == FileSize;
+  if (!sized && (!m_writable || ::ftruncate(m_fd, 0) < 0 ||
+                 ::ftruncate(m_fd, FileSize) < 0)) {
+    ::close(m_fd);
+    m_fd = -1;
+    return;
+  }
+
+  void *map = ::mmap(nullptr, FileSize,
+                     PROT_READ | (m_writable ? PROT_WRITE : 0), MAP_SHARED,
+                     m_fd, 0);
+  if (map == MAP_FAILED) {
+    const int error = errno;
+    qWarning() << "[MetricArchive] Cannot map" << path << strerror(error);
+    ::close(m_fd);
+    m_fd = -1;
+    return;
+  }
+  m_map = static_cast<unsigned char *>(map);
+
+  if (!isValid()) {
+    if (!m_writable) {
+      ::munmap(m_map, FileSize);
+      m_map = nullptr;
+      ::close(m_fd);
+      m_fd = -1;
+      return;
+    }
+    if (sized)
+      qInfo() << "[MetricArchive] Resetting" << path;
+    initialize();
+  }
+}
+
+MetricArchive::~MetricArchive() {
+  // Dirty pages are written back by the kernel; no msync() needed
+  if (m_map)
+    ::munmap(m_map, FileSize);
+  if (m_fd >= 0)
+    ::close(m_fd); // Releases the lock
+}
+
+bool MetricArchive::isValid() const {
+  const auto *header = reinterpret_cast<const FileHeader *>(m_map);
+  if (std::memcmp(header->magic, Magic, sizeof(Magic)) != 0 ||
+      header->version != Version || header->tierCount != TierCount)
+    return false;
+  for (int i = 0; i < TierCount; ++i) {
+    const TierHeader *t = tierHeader(m_map, i);
+    if (t->period != quint32(Tiers[i].period) ||
+        t->capacity != quint32(Tiers[i].capacity) ||
+        t->head >= t->capacity || t->count > t->capacity)
+      return false;
+  }
+  return true;
+}
+
+void MetricArchive::initialize() {
+  std::memset(m_map, 0, HeadersSize);
+  auto *header = reinterpret_cast<FileHeader *>(m_map);
+  std::memcpy(header->magic, Magic, sizeof(Magic));
+  header->version = Version;
+  header->tierCount = TierCount;
+  for (int i = 0; i < TierCount; ++i) {
+    TierHeader *t = tierHeader(m_map, i);
+    t->period = Tiers[i].period;
+    t->capacity = Tiers[i].capacity;
+    t->bucket = -1;
+  }
+}
+
+void MetricArchive::append(double value, qint64 time) {
+  if (!m_writable || !m_map || time < 0)
+    return;
+
+  for (int i = 0; i < TierCount; ++i) {
+    TierHeader *t = tierHeader(m_map, i);
+    float *slots = tierData(m_map, i);
+    const qint64 bucket = time / t->period;
+
+    if (t->count == 0 || bucket > t->bucket) {
+      // Buckets skipped since the last sample become gaps, then one new slot
+      const qint64 gaps =
+          t->count == 0 ? 0
+                        : qMin<qint64>(bucket - t->bucket - 1, t->capacity);
+      for (qint64 n = 0; n <= gaps; ++n) {
+        if (t->count < t->capacity) {
+          ++t->count;
+        } else {
+          t->head = (t->head + 1) % t->capacity;
+        }
+        slots[(t->head + t->count - 1) % t->capacity] = NAN;
+      }
+      t->bucket = bucket;
+      t->sum = 0.0;
+      t->samples = 0;
+    }
+
+    t->sum += value;
+    ++t->samples;
+    slots[(t->head + t->count - 1) % t->capacity] = float(t->sum / t->samples);
+  }
+}
+
+QVector<float> MetricArchive::values(Tier index) const {
+  QVector<float> result;
+  if (!m_map)
+    return result;
+  const TierHeader *t = tierHeader(m_map, index);
+  const float *slots = tierData(m_map, index);
+  result.resize(t->count);
+  for (quint32 i = 0; i < t->count; ++i)
+    result[i] = slots[(t->head + i) % t->capacity];
+  return result;
+}
+
+float MetricArchive::latest(Tier index) const {
+  if (!m_map || tierHeader(m_map, index)->count == 0)
+    return NAN;
+  const TierHeader *t = tierHeader(m_map, index);
+  return tierData(m_map, index)[(t->head + t->count - 1) % t->capacity];
+}
+
+qint64 MetricArchive::latestBucket(Tier index) const {
+  if (!m_map || tierHeader(m_map, index)->count == 0)
+    return -1;
+  return tierHeader(m_map, index)->bucket;
+}
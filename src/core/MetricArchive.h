@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+// Fixed-size on-disk time series of one metric, memory-mapped.
+//
+// The file holds one ring per tier: 1 s buckets for an hour, 1 min buckets
+// for a day and 1 h buckets for a month (about 23 KiB in all; it never
+// grows). Every sample is folded into all tiers at once: the newest slot of
+// each tier holds the running mean of its current bucket, so coarser tiers
+// are downsampled as samples arrive rather than by a separate pass. Buckets
+// in which nothing was recorded (the shell was not running) are stored as
+// NaN.
+//
+// Only one process records into a file; it holds an exclusive flock() and
+// others map it read-only.
+class MetricArchive {
+public:
+  enum Tier { Seconds, Minutes, Hours, TierCount };
+
+  explicit MetricArchive(const QString &path);
+  ~MetricArchive();
+  MetricArchive(const MetricArchive &) = delete;
+  MetricArchive &operator=(const MetricArchive &) = delete;
+
+  static int period(Tier tier);   // Seconds per bucket
+  static int capacity(Tier tier); // Buckets kept
+
+  bool isOpen() const { return m_map != nullptr; }
+  bool isWritable() const { return m_writable; }
+
+  // `time` is seconds since the epoch. A clock that goes backwards folds into
+  // the newest bucket instead of rewriting older ones.
+  void append(double value, qint64 time);
+
+  // Oldest first, NaN for gaps
+  QVector<float> values(Tier tier) const;
+  float latest(Tier tier) const;
+  // Bucket number (time / period) of the newest slot; -1 when empty
+  qint64 latestBucket(Tier tier) const;
+
+private:
+  bool isValid() const;
+  void initialize();
+
+  int m_fd = -1;
+  unsigned char *m_map = nullptr;
+  bool m_writable = false;
+};
@@ -0,0 +1,51 @@
+#include "MetricHistory.h"
+#include <cmath>
+
+MetricHistory::MetricHistory(int capacity, QObject *parent)
+    : QObject(parent), m_values(qMax(2, capacity), 0.0f) {}
+
+double MetricHistory::maximum() const {
+  float max = 0.0f;
+  for (int i = 0; i < m_count; ++i)
+    max = qMax(max, m_values[(m_head + i) % m_values.size()]);
+  return max;
+}
+
+void MetricHistory::append(double value) {
+  const int size = m_values.size();
+  if (m_count < size) {
+    m_values[(m_head + m_count) % size] = float(value);
+    ++m_count;
+  } else {
+    m_values[m_head] = float(value);
+    m_head = (m_head + 1) % size;
+  }
+  emit changed();
+}
+
+void MetricHistory::replaceLatest(double value) {
+  if (m_count == 0) {
+    append(value);
+    return;
+  }
+  m_values[(m_head + m_count - 1) % m_values.size()] = float(value);
+  emit changed();
+}
+
+void MetricHistory::assign(const QVector<float> &values) {
+  const int size = m_values.size();
+  const int first = qMax(0, int(values.size()) - size);
+  m_head = 0;
+  m_count = int(values.size()) - first;
+  for (int i = 0; i < m_count; ++i) {
+    const float value = values[first + i];
+    m_values[i] = std::isnan(value) ? 0.0f : value;
+  }
+  emit changed();
+}
+
+void MetricHistory::clear() {
+  m_head = 0;
+  m_count = 0;
+  emit changed();
+}
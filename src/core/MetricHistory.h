@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QObject>
+#include <QQmlEngine>
+#include <QVector>
+
+// Fixed-capacity ring of recent samples for one metric. Storage is allocated
+// once; append() overwrites the oldest value when full. Graphs draw straight
+// from the ring (see Sparkline) instead of copying it into JS arrays.
+class MetricHistory : public QObject {
+  Q_OBJECT
+  QML_ELEMENT
+  QML_UNCREATABLE("Provided by SystemMonitor")
+  Q_PROPERTY(int capacity READ capacity CONSTANT)
+  Q_PROPERTY(int count READ count NOTIFY changed)
+  Q_PROPERTY(double latest READ latest NOTIFY changed)
+  Q_PROPERTY(double maximum READ maximum NOTIFY changed)
+
+public:
+  static constexpr int DefaultCapacity = 120; // 2 minutes at 1 Hz
+
+  explicit MetricHistory(int capacity = DefaultCapacity,
+                         QObject *parent = nullptr);
+
+  int capacity() const { return m_values.size(); }
+  int count() const { return m_count; }
+  double latest() const { return m_count ? at(m_count - 1) : 0.0; }
+  double maximum() const;
+
+  // 0 = oldest sample still in the ring
+  Q_INVOKABLE double at(int index) const {
+    return m_values[(m_head + index) % m_values.size()];
+  }
+
+  void append(double value);
+  // Overwrites the newest sample, e.g. while a downsampled bucket fills
+  void replaceLatest(double value);
+  // Replaces the contents with `values`, oldest first; NaN gaps read as 0
+  void assign(const QVector<float> &values);
+  void clear();
+
+signals:
+  void changed();
+
+private:
+  QVector<float> m_values;
+  int m_head = 0; // Index of the oldest sample
+  int m_count = 0;
+};
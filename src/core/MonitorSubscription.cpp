@@ -0,0 +1,52 @@
+#include "MonitorSubscription.h"
+#include "SystemMonitor.h"
+
+MonitorSubscription::MonitorSubscription(QObject *parent) : QObject(parent) {}
+
+MonitorSubscription::~MonitorSubscription() {
+  if (m_token)
+    SystemMonitor::instance()->unsubscribe(m_token);
+}
+
+void MonitorSubscription::setMetrics(int metrics) {
+  if (m_metrics == metrics)
+    return;
+  m_metrics = metrics;
+  emit metricsChanged();
+  resubscribe();
+}
+
+void MonitorSubscription::setInterval(int interval) {
+  if (m_interval == interval)
+    return;
+  m_interval = interval;
+  emit intervalChanged();
+  resubscribe();
+}
+
+void MonitorSubscription::setActive(bool active) {
+  if (m_active == active)
+    return;
+  m_active = active;
+  emit activeChanged();
+  resubscribe();
+}
+
+void MonitorSubscription::componentComplete() {
+  m_complete = true;
+  resubscribe();
+}
+
+void MonitorSubscription::resubscribe() {
+  if (!m_complete)
+    return;
+
+  SystemMonitor *monitor = SystemMonitor::instance();
+  const int previous = m_token;
+  m_token = 0;
+  if (m_active && m_metrics)
+    m_token = monitor->subscribe(m_metrics, m_interval);
+  // Subscribe before unsubscribing so a rate change doesn't pause sampling
+  if (previous)
+    monitor->unsubscribe(previous);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QObject>
+#include <QQmlEngine>
+#include <QQmlParserStatus>
+
+// Declarative SystemMonitor subscription. Bind `active` to the consumer's
+// visibility so sampling stops while nothing shows the data:
+//
+//   MonitorSubscription {
+//       metrics: SystemMonitor.Cpu | SystemMonitor.Memory
+//       interval: 1000
+//       active: root.visible && root.Window.window && root.Window.window.visible
+//   }
+class MonitorSubscription : public QObject, public QQmlParserStatus {
+  Q_OBJECT
+  QML_ELEMENT
+  Q_INTERFACES(QQmlParserStatus)
+  Q_PROPERTY(int metrics READ metrics WRITE setMetrics NOTIFY metricsChanged)
+  Q_PROPERTY(int interval READ interval WRITE setInterval NOTIFY intervalChanged)
+  Q_PROPERTY(bool active READ active WRITE setActive NOTIFY activeChanged)
+
+public:
+  explicit MonitorSubscription(QObject *parent = nullptr);
+  ~MonitorSubscription() override;
+
+  int metrics() const { return m_metrics; }
+  void setMetrics(int metrics);
+  int interval() const { return m_interval; }
+  void setInterval(int interval);
+  bool active() const { return m_active; }
+  void setActive(bool active);
+
+  void classBegin() override {}
+  void componentComplete() override;
+
+signals:
+  void metricsChanged();
+  void intervalChanged();
+  void activeChanged();
+
+private:
+  void resubscribe();
+
+  int m_metrics = 0;
+  int m_interval = 1000;
+  bool m_active = true;
+  bool m_complete = false;
+  int m_token = 0;
+};
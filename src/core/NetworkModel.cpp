@@ -0,0 +1,130 @@
+#include "NetworkModel.h"
+#include <QSet>
+
+NetworkModel::NetworkModel(QObject *parent) : QAbstractListModel(parent) {}
+
+int NetworkModel::rowCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant NetworkModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid() || index.row() >= m_rows.size())
+    return {};
+
+  const int row = index.row();
+  const NetworkInfo &info = m_rows.at(row);
+  switch (role) {
+  case Qt::DisplayRole:
+  case NameRole:
+    return info.name;
+  case RxRateRole:
+    return info.rxBytesPerSec;
+  case TxRateRole:
+    return info.txBytesPerSec;
+  case RxPacketRateRole:
+    return info.rxPacketsPerSec;
+  case TxPacketRateRole:
+    return info.txPacketsPerSec;
+  case RxHistoryRole:
+    return QVariant::fromValue(m_rxHistories.at(row));
+  case TxHistoryRole:
+    return QVariant::fromValue(m_txHistories.at(row));
+  }
+  return {};
+}
+
+QHash<int, QByteArray> NetworkModel::roleNames() const {
+  return {{NameRole, "name"},
+          {RxRateRole, "rxRate"},
+          {TxRateRole, "txRate"},
+          {RxPacketRateRole, "rxPacketRate"},
+          {TxPacketRateRole, "txPacketRate"},
+          {RxHistoryRole, "rxHistory"},
+          {TxHistoryRole, "txHistory"}};
+}
+
+void NetworkModel::setInterfaces(const QVector<NetworkInfo> &interfaces) {
+  const int oldCount = m_rows.size();
+
+  QSet<QString> names;
+  names.reserve(interfaces.size());
+  for (const NetworkInfo &info : interfaces)
+    names.insert(info.name);
+
+  // Drop interfaces that went away (bottom-up so row numbers stay valid)
+  for (int row = m_rows.size() - 1; row >= 0; --row) {
+    if (!names.contains(m_rows.at(row).name)) {
+      beginRemoveRows(QModelIndex(), row, row);
+      m_rows.removeAt(row);
+      delete m_rxHistories.takeAt(row);
+      delete m_txHistories.takeAt(row);
+      endRemoveRows();
+    }
+  }
+
+  for (int i = 0; i < interfaces.size(); ++i) {
+    const NetworkInfo &info = interfaces.at(i);
+    if (i < m_rows.size() && m_rows.at(i).name == info.name) {
+      updateRow(i, info);
+      continue;
+    }
+
+    int existing = -1;
+    for (int row = i + 1; row < m_rows.size() && existing == -1; ++row) {
+      if (m_rows.at(row).name == info.name)
+        existing = row;
+    }
+    if (existing != -1) {
+      beginMoveRows(QModelIndex(), existing, existing, QModelIndex(), i);
+      m_rows.move(existing, i);
+      m_rxHistories.move(existing, i);
+      m_txHistories.move(existing, i);
+      endMoveRows();
+      updateRow(i, info);
+    } else {
+      beginInsertRows(QModelIndex(), i, i);
+      m_rows.insert(i, info);
+      m_rxHistories.insert(
+          i, new MetricHistory(MetricHistory::DefaultCapacity, this));
+      m_txHistories.insert(
+          i, new MetricHistory(MetricHistory::DefaultCapacity, this));
+      m_rxHistories[i]->append(info.rxBytesPerSec);
+      m_txHistories[i]->append(info.txBytesPerSec);
+      endInsertRows();
+    }
+  }
+
+  if (m_rows.size() != oldCount)
+    emit countChanged();
+}
+
+int NetworkModel::indexOf(const QString &name) const {
+  for (int row = 0; row < m_rows.size(); ++row) {
+    if (m_rows.at(row).name == name)
+      return row;
+  }
+  return -1;
+}
+
+void NetworkModel::updateRow(int row, const NetworkInfo &info) {
+  NetworkInfo &current = m_rows[row];
+  QList<int> roles;
+  if (current.rxBytesPerSec != info.rxBytesPerSec)
+    roles << RxRateRole;
+  if (current.txBytesPerSec != info.txBytesPerSec)
+    roles << TxRateRole;
+  if (current.rxPacketsPerSec != info.rxPacketsPerSec)
+    roles << RxPacketRateRole;
+  if (current.txPacketsPerSec != info.txPacketsPerSec)
+    roles << TxPacketRateRole;
+
+  // Histories advance every sample, even when the rate is unchanged
+  m_rxHistories[row]->append(info.rxBytesPerSec);
+  m_txHistories[row]->append(info.txBytesPerSec);
+
+  current = info;
+  if (!roles.isEmpty()) {
+    const QModelIndex idx = index(row);
+    emit dataChanged(idx, idx, roles);
+  }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "MetricHistory.h"
+#include <QAbstractListModel>
+#include <QQmlEngine>
+
+// Rates of one physical interface between two samples
+struct NetworkInfo {
+  QString name;
+  double rxBytesPerSec = 0.0;
+  double txBytesPerSec = 0.0;
+  double rxPacketsPerSec = 0.0;
+  double txPacketsPerSec = 0.0;
+};
+
+// Physical network interfaces as a list model (SystemMonitor.networks),
+// updated while SystemMonitor.Network is subscribed. Each row keeps a
+// receive and a transmit MetricHistory for Sparkline; rows are matched by
+// interface name so histories survive interfaces coming and going.
+class NetworkModel : public QAbstractListModel {
+  Q_OBJECT
+  QML_ELEMENT
+  QML_UNCREATABLE("Use SystemMonitor.networks")
+  Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+  enum Roles {
+    NameRole = Qt::UserRole + 1,
+    RxRateRole,
+    TxRateRole,
+    RxPacketRateRole,
+    TxPacketRateRole,
+    RxHistoryRole,
+    TxHistoryRole
+  };
+
+  explicit NetworkModel(QObject *parent = nullptr);
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index, int role) const override;
+  QHash<int, QByteArray> roleNames() const override;
+
+  // Order follows `interfaces` (kernel order)
+  void setInterfaces(const QVector<NetworkInfo> &interfaces);
+
+  Q_INVOKABLE int indexOf(const QString &name) const;
+
+signals:
+  void countChanged();
+
+private:
+  void updateRow(int row, const NetworkInfo &info);
+
+  QVector<NetworkInfo> m_rows;
+  QList<MetricHistory *> m_rxHistories;
+  QList<MetricHistory *> m_txHistories;
+};
@@ -0,0 +1,137 @@
+#include "PersistenceService.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QPointer>
+#include <QSaveFile>
+
+void PersistenceWorker::write(const QString &path, const QByteArray &data,
+                              quint64 generation) {
+  QElapsedTimer timer;
+  timer.start();
+
+  QSaveFile file(path);
+  bool ok = file.open(QIODevice::WriteOnly) &&
+            file.write(data) == data.size() && file.commit();
+  if (!ok) {
+    qWarning() << "[Persistence] Failed to write" << path << ":"
+               << file.errorString();
+  }
+
+  emit written(path, generation, ok, timer.nsecsElapsed());
+}
+
+PersistenceService *PersistenceService::instance() {
+  static QPointer<PersistenceService> s_instance;
+  if (!s_instance) {
+    s_instance = new PersistenceService(QCoreApplication::instance());
+  }
+  return s_instance;
+}
+
+PersistenceService::PersistenceService(QObject *parent) : QObject(parent) {
+  m_debounceTimer.setSingleShot(true);
+  connect(&m_debounceTimer, &QTimer::timeout, this,
+          [this]() { dispatchPending(Qt::QueuedConnection); });
+
+  m_worker = new PersistenceWorker();
+  m_worker->moveToThread(&m_thread);
+  connect(m_worker, &PersistenceWorker::written, this,
+          &PersistenceService::onWritten);
+  m_thread.setObjectName("CanvasDeskPersistence");
+  m_thread.start(QThread::LowPriority);
+
+  // Never lose the last edit on exit
+  if (auto *app = QCoreApplication::instance()) {
+    connect(app, &QCoreApplication::aboutToQuit, this,
+            &PersistenceService::flush);
+  }
+}
+
+PersistenceService::~PersistenceService() {
+  flush();
+  m_thread.quit();
+  m_thread.wait();
+  delete m_worker;
+}
+
+void PersistenceService::scheduleWrite(const QString &path,
+                                       const QByteArray &data, int delayMs) {
+  if (m_pending.isEmpty()) {
+    m_firstPending.start();
+  }
+
+  PendingWrite &pending = m_pending[path];
+  pending.data = data;
+  pending.generation = ++m_generation;
+
+  // Debounce, but don't let a continuous stream of saves (e.g. dragging a
+  // color picker) postpone the write forever
+  if (m_firstPending.elapsed() + delayMs <= MaxDelayMs ||
+      !m_debounceTimer.isActive()) {
+    m_debounceTimer.start(delayMs);
+  }
+}
+
+bool PersistenceService::pendingContents(const QString &path,
+                                         QByteArray *data) const {
+  auto it = m_pending.constFind(path);
+  if (it == m_pending.constEnd()) {
+    it = m_inFlight.constFind(path);
+    if (it == m_inFlight.constEnd())
+      return false;
+  }
+
+  if (data)
+    *data = it->data;
+  return true;
+}
+
+void PersistenceService::flush() {
+  m_debounceTimer.stop();
+  dispatchPending(Qt::BlockingQueuedConnection);
+}
+
+double PersistenceService::averageWriteLatency() const {
+  if (m_writeCount == 0)
+    return 0.0;
+  return (m_totalLatencyNs / m_writeCount) / 1e6;
+}
+
+void PersistenceService::dispatchPending(Qt::ConnectionType type) {
+  if (m_pending.isEmpty())
+    return;
+
+  for (auto it = m_pending.cbegin(); it != m_pending.cend(); ++it) {
+    const QString path = it.key();
+    const PendingWrite write = it.value();
+    m_inFlight.insert(path, write);
+
+    QMetaObject::invokeMethod(
+        m_worker,
+        [worker = m_worker, path, write]() {
+          worker->write(path, write.data, write.generation);
+        },
+        type);
+  }
+  m_pending.clear();
+}
+
+void PersistenceService::onWritten(const QString &path, quint64 generation,
+                                   bool ok, qint64 latencyNs) {
+  // A newer write for the same path may already be in flight; keep it
+  auto it = m_inFlight.find(path);
+  if (it != m_inFlight.end() && it->generation == generation) {
+    m_inFlight.erase(it);
+  }
+
+  if (ok) {
+    m_writeCount++;
+    m_lastLatencyNs = latencyNs;
+    m_totalLatencyNs += latencyNs;
+    qDebug() << "[Persistence] Wrote" << path << "in" << lastWriteLatency()
+             << "ms (total writes:" << m_writeCount << ")";
+    emit statsChanged();
+  }
+
+  emit writeFinished(path, ok);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include <QTimer>
+
+// Runs on the persistence thread. Each write goes through QSaveFile so the
+// target is replaced atomically (write to temp file + rename).
+class PersistenceWorker : public QObject {
+  Q_OBJECT
+
+public slots:
+  void write(const QString &path, const QByteArray &data, quint64 generation);
+
+signals:
+  void written(const QString &path, quint64 generation, bool ok,
+               qint64 latencyNs);
+};
+
+// Shared debounced writer for layout and config files.
+//
+// scheduleWrite() only records the latest contents for a path; repeated saves
+// of the same path inside the debounce window coalesce into a single write on
+// the worker thread. Readers can ask for contents that are not on disk yet via
+// pendingContents(), so a save followed by an immediate load stays consistent.
+class PersistenceService : public QObject {
+  Q_OBJECT
+  Q_PROPERTY(int writeCount READ writeCount NOTIFY statsChanged)
+  Q_PROPERTY(double lastWriteLatency READ lastWriteLatency NOTIFY statsChanged)
+  Q_PROPERTY(
+      double averageWriteLatency READ averageWriteLatency NOTIFY statsChanged)
+
+public:
+  static constexpr int DefaultDelayMs = 250;
+  static constexpr int MaxDelayMs = 2000; // Upper bound while saves keep coming
+
+  static PersistenceService *instance();
+  ~PersistenceService();
+
+  void scheduleWrite(const QString &path, const QByteArray &data,
+                     int delayMs = DefaultDelayMs);
+  bool pendingContents(const QString &path, QByteArray *data) const;
+
+  // Hand every pending write to the worker and block until all are on disk
+  void flush();
+
+  int writeCount() const { return m_writeCount; }
+  double lastWriteLatency() const { return m_lastLatencyNs / 1e6; }  // ms
+  double averageWriteLatency() const;                                 // ms
+
+signals:
+  void writeFinished(const QString &path, bool ok);
+  void statsChanged();
+
+private:
+  explicit PersistenceService(QObject *parent = nullptr);
+
+  struct PendingWrite {
+    QByteArray data;
+    quint64 generation = 0;
+  };
+
+  void dispatchPending(Qt::ConnectionType type);
+  void onWritten(const QString &path, quint64 generation, bool ok,
+                 qint64 latencyNs);
+
+  QHash<QString, PendingWrite> m_pending;  // Waiting for the debounce timer
+  QHash<QString, PendingWrite> m_inFlight; // Handed to the worker
+
+  QTimer m_debounceTimer;
+  QElapsedTimer m_firstPending; // Started when m_pending becomes non-empty
+  QThread m_thread;
+  PersistenceWorker *m_worker = nullptr;
+
+  quint64 m_generation = 0;
+  int m_writeCount = 0;
+  qint64 m_lastLatencyNs = 0;
+  qint64 m_totalLatencyNs = 0;
+};
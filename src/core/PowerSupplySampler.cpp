@@ -0,0 +1,214 @@
+#include "PowerSupplySampler.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSocketNotifier>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+QString readSmallFile(const QString &path) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly))
+    return {};
+  return QString::fromUtf8(file.readAll()).trimmed();
+}
+
+// Attributes differ between drivers; only keep the ones that exist so that
+// missing ones are not re-opened on every read
+void openIfExists(ProcFile &file, const QString &path) {
+  if (QFile::exists(path))
+    file.open(QFile::encodeName(path));
+}
+
+} // namespace
+
+PowerSupplySampler::PowerSupplySampler(const QByteArray &sysRoot,
+                                       QObject *parent)
+    : QObject(parent), m_sysRoot(sysRoot) {}
+
+PowerSupplySampler::~PowerSupplySampler() { setActive(false); }
+
+void PowerSupplySampler::discover() {
+  m_discovered = true;
+  m_batteries.clear();
+  m_adapters.clear();
+
+  QDir dir(QString::fromLocal8Bit(m_sysRoot) + "/class/power_supply");
+  const QStringList supplies =
+      dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+  for (const QString &name : supplies) {
+    const QString path = dir.filePath(name);
+    const QString type = readSmallFile(path + "/type");
+    if (type == QLatin1String("Mains")) {
+      ProcFile online;
+      openIfExists(online, path + "/online");
+      if (online.isOpen())
+        m_adapters.push_back(std::move(online));
+      continue;
+    }
+    if (type != QLatin1String("Battery") ||
+        readSmallFile(path + "/scope") == QLatin1String("Device"))
+      continue;
+
+    Battery battery;
+    openIfExists(battery.status, path + "/status");
+    openIfExists(battery.capacity, path + "/capacity");
+    openIfExists(battery.energyNow, path + "/energy_now");
+    openIfExists(battery.energyFull, path + "/energy_full");
+    openIfExists(battery.powerNow, path + "/power_now");
+    openIfExists(battery.chargeNow, path + "/charge_now");
+    openIfExists(battery.chargeFull, path + "/charge_full");
+    openIfExists(battery.currentNow, path + "/current_now");
+    openIfExists(battery.voltageNow, path + "/voltage_now");
+    m_batteries.push_back(std::move(battery));
+  }
+
+  qDebug() << "[PowerSupplySampler] Found" << m_batteries.size()
+           << "batteries and" << m_adapters.size() << "adapters";
+}
+
+void PowerSupplySampler::setActive(bool active) {
+  if (active == (m_ueventFd >= 0))
+    return;
+
+  if (!active) {
+    delete m_notifier;
+    m_notifier = nullptr;
+    ::close(m_ueventFd);
+    m_ueventFd = -1;
+    return;
+  }
+
+  m_ueventFd = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                        NETLINK_KOBJECT_UEVENT);
+  sockaddr_nl address = {};
+  address.nl_family = AF_NETLINK;
+  address.nl_groups = 1; // Kernel uevents
+  if (m_ueventFd < 0 ||
+      ::bind(m_ueventFd, reinterpret_cast<sockaddr *>(&address),
+             sizeof(address)) < 0) {
+    const int error = errno;
+    if (m_ueventFd >= 0)
+      ::close(m_ueventFd);
+    qInfo() << "[PowerSupplySampler] No uevents:" << strerror(error)
+            << "- battery is polled";
+    m_ueventFd = -1;
+    return;
+  }
+
+  m_notifier = new QSocketNotifier(m_ueventFd, QSocketNotifier::Read, this);
+  connect(m_notifier, &QSocketNotifier::activated, this,
+          &PowerSupplySampler::readUevents);
+}
+
+void PowerSupplySampler::readUevents() {
+  // "action@devpath\0KEY=value\0KEY=value\0..."
+  static const char Subsystem[] = "SUBSYSTEM=power_supply";
+  bool relevant = false;
+  for (;;) {
+    const ssize_t n = ::recv(m_ueventFd, m_buffer, sizeof(m_buffer), 0);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      break; // EAGAIN: drained
+    relevant = relevant || memmem(m_buffer, size_t(n), Subsystem,
+                                  sizeof(Subsystem)) != nullptr;
+  }
+  if (relevant)
+    emit changed();
+}
+
+qint64 PowerSupplySampler::readNumber(ProcFile &file) {
+  if (!file.isOpen())
+    return -1;
+  const qsizetype n = file.read(m_buffer, sizeof(m_buffer));
+  if (n <= 0)
+    return -1;
+  // Some drivers report discharge current as negative
+  const bool negative = m_buffer[0] == '-';
+  quint64 value = 0;
+  bool ok = false;
+  ProcParse::parseU64(m_buffer + (negative ? 1 : 0), m_buffer + n, &value,
+                      &ok);
+  return ok ? qint64(value) : -1;
+}
+
+bool PowerSupplySampler::read(BatteryState *state) {
+  if (!m_discovered)
+    discover();
+
+  *state = BatteryState();
+  for (ProcFile &online : m_adapters)
+    state->acOnline = state->acOnline || readNumber(online) == 1;
+  if (m_batteries.empty())
+    return true; // Desktop: present stays false
+
+  // Energy in µWh and power in µW; charge-based drivers are converted with
+  // the current voltage
+  double energyNow = 0.0, energyFull = 0.0, power = 0.0, capacity = 0.0;
+  int capacities = 0;
+  bool anyCharging = false, anyDischarging = false;
+  QString firstStatus;
+  for (Battery &battery : m_batteries) {
+    const double volts =
+        std::max<qint64>(readNumber(battery.voltageNow), 0) / 1e6;
+    qint64 now = readNumber(battery.energyNow);
+    qint64 full = readNumber(battery.energyFull);
+    qint64 rate = readNumber(battery.powerNow);
+    if (now < 0 && volts > 0) {
+      const qint64 chargeNow = readNumber(battery.chargeNow);
+      const qint64 chargeFull = readNumber(battery.chargeFull);
+      now = chargeNow >= 0 ? qint64(chargeNow * volts) : -1;
+      full = chargeFull >= 0 ? qint64(chargeFull * volts) : -1;
+    }
+    if (rate < 0 && volts > 0) {
+      const qint64 current = readNumber(battery.currentNow);
+      rate = current >= 0 ? qint64(current * volts) : -1;
+    }
+    if (now >= 0 && full > 0) {
+      energyNow += now;
+      energyFull += full;
+    }
+    if (rate > 0)
+      power += rate;
+
+    const qint64 percent = readNumber(battery.capacity);
+    if (percent >= 0) {
+      capacity += percent;
+      ++capacities;
+    }
+
+    if (battery.status.isOpen()) {
+      const qsizetype n = battery.status.read(m_buffer, sizeof(m_buffer));
+      const QString status =
+          n > 0 ? QString::fromLatin1(m_buffer, int(n)).trimmed() : QString();
+      anyCharging = anyCharging || status == QLatin1String("Charging");
+      anyDischarging =
+          anyDischarging || status == QLatin1String("Discharging");
+      if (firstStatus.isEmpty())
+        firstStatus = status;
+    }
+  }
+
+  state->present = true;
+  state->percent = energyFull > 0 ? 100.0 * energyNow / energyFull
+                   : capacities > 0 ? capacity / capacities
+                                    : 0.0;
+  state->status = anyCharging      ? QStringLiteral("Charging")
+                  : anyDischarging ? QStringLiteral("Discharging")
+                                   : firstStatus;
+  state->charging = anyCharging;
+  state->powerWatts = power / 1e6;
+  if (power > 0 && energyFull > 0 && (anyCharging || anyDischarging)) {
+    const double hours = anyCharging ? (energyFull - energyNow) / power
+                                     : energyNow / power;
+    state->secondsRemaining = int(std::lround(hours * 3600));
+  }
+  return true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ProcFile.h"
+#include <QObject>
+#include <QQmlEngine>
+#include <QString>
+#include <vector>
+
+class QSocketNotifier;
+
+// Combined state of the system batteries
+struct BatteryState {
+  Q_GADGET
+  QML_VALUE_TYPE(batteryState)
+  Q_PROPERTY(bool present MEMBER present)
+  Q_PROPERTY(double percent MEMBER percent)
+  Q_PROPERTY(QString status MEMBER status)
+  Q_PROPERTY(bool charging MEMBER charging)
+  Q_PROPERTY(bool acOnline MEMBER acOnline)
+  Q_PROPERTY(double powerWatts MEMBER powerWatts)
+  Q_PROPERTY(int secondsRemaining MEMBER secondsRemaining)
+
+public:
+  bool present = false;
+  double percent = 0.0;
+  QString status; // Kernel wording: Charging, Discharging, Full, ...
+  bool charging = false;
+  bool acOnline = false;
+  double powerWatts = 0.0;
+  int secondsRemaining = -1; // To empty or full; -1 when unknown
+
+  bool operator==(const BatteryState &other) const = default;
+};
+
+// Batteries and mains adapters from <sys>/class/power_supply.
+//
+// Supplies are found once and their attribute files stay open for pread.
+// While active, a NETLINK_KOBJECT_UEVENT socket reports power_supply change
+// events (plugging in, status changes, the driver's periodic capacity
+// updates), so battery state can be sampled on events instead of a fast
+// timer. Peripheral batteries (scope "Device", e.g. a mouse) are ignored.
+class PowerSupplySampler : public QObject {
+  Q_OBJECT
+
+public:
+  explicit PowerSupplySampler(const QByteArray &sysRoot = "/sys",
+                              QObject *parent = nullptr);
+  ~PowerSupplySampler() override;
+
+  void setActive(bool active);
+  bool read(BatteryState *state);
+
+signals:
+  // A power_supply uevent arrived
+  void changed();
+
+private:
+  struct Battery {
+    ProcFile status;
+    ProcFile capacity;
+    ProcFile energyNow, energyFull, powerNow;   // µWh, µW
+    ProcFile chargeNow, chargeFull, currentNow; // µAh, µA
+    ProcFile voltageNow;                        // µV
+  };
+
+  void discover();
+  void readUevents();
+  qint64 readNumber(ProcFile &file); // -1 when missing
+
+  QByteArray m_sysRoot;
+  bool m_discovered = false;
+  std::vector<Battery> m_batteries;
+  std::vector<ProcFile> m_adapters; // Mains "online"
+  int m_ueventFd = -1;
+  QSocketNotifier *m_notifier = nullptr;
+  char m_buffer[8192]; // One uevent message, or one attribute
+};
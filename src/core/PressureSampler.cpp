@@ -0,0 +1,130 @@
+#include "PressureSampler.h"
+#include <QDebug>
+#include <QSocketNotifier>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/magic.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+
+using namespace ProcParse;
+
+namespace {
+
+struct TriggerSpec {
+  const char *file;
+  // "some <stall us> <window us>"; unprivileged triggers need a window that
+  // is a multiple of 2 s
+  const char *trigger;
+};
+
+const TriggerSpec Specs[PressureSampler::ResourceCount] = {
+    {"/pressure/cpu", "some 500000 2000000"},    // 25% of 2 s
+    {"/pressure/memory", "some 100000 2000000"}, // 5%
+    {"/pressure/io", "some 200000 2000000"},     // 10%
+};
+
+// "some avg10=1.23 avg60=4.56 avg300=7.89 total=123"
+void parseLine(const char *p, const char *end, double *avg10, double *avg60) {
+  p = skipField(p, end); // some/full
+  while (p < end && *p != '\n') {
+    p = skipSpaces(p, end);
+    if (startsWith(p, end, "avg10="))
+      p = parseDouble(p + 6, end, avg10);
+    else if (startsWith(p, end, "avg60="))
+      p = parseDouble(p + 6, end, avg60);
+    else
+      p = skipField(p, end);
+  }
+}
+
+} // namespace
+
+PressureSampler::PressureSampler(const QByteArray &procRoot, QObject *parent)
+    : QObject(parent) {
+  for (int i = 0; i < ResourceCount; ++i)
+    m_files[i].open(procRoot + Specs[i].file);
+}
+
+PressureSampler::~PressureSampler() { setActive(false); }
+
+bool PressureSampler::isAvailable() const {
+  // Memory and io are the useful ones; cpu alone is not enough
+  return m_files[Memory].isOpen();
+}
+
+void PressureSampler::setActive(bool active) {
+  for (int i = 0; i < ResourceCount; ++i) {
+    if (active && m_triggerFds[i] < 0 && m_files[i].isOpen()) {
+      openTrigger(i);
+    } else if (!active && m_triggerFds[i] >= 0) {
+      delete m_notifiers[i];
+      m_notifiers[i] = nullptr;
+      ::close(m_triggerFds[i]); // Closing removes the trigger
+      m_triggerFds[i] = -1;
+    }
+  }
+}
+
+void PressureSampler::openTrigger(int resource) {
+  if (m_triggersRefused)
+    return;
+
+  const QByteArray path = m_files[resource].path();
+  const int fd = ::open(path.constData(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+
+  // Writing the trigger to a regular file (a CANVASDESK_PROC_ROOT fixture)
+  // would overwrite it: only register on procfs itself
+  struct statfs fs;
+  if (fd >= 0 && (::fstatfs(fd, &fs) < 0 || fs.f_type != PROC_SUPER_MAGIC)) {
+    ::close(fd);
+    qInfo() << "[PressureSampler]" << path
+            << "is not on procfs - polling averages only";
+    m_triggersRefused = true;
+    return;
+  }
+
+  const char *trigger = Specs[resource].trigger;
+  if (fd < 0 || ::write(fd, trigger, std::strlen(trigger) + 1) < 0) {
+    const int error = errno;
+    if (fd >= 0)
+      ::close(fd);
+    qInfo() << "[PressureSampler] Stall triggers unavailable:"
+            << strerror(error) << "- polling averages only";
+    m_triggersRefused = true;
+    return;
+  }
+
+  m_triggerFds[resource] = fd;
+  m_notifiers[resource] =
+      new QSocketNotifier(fd, QSocketNotifier::Exception, this);
+  connect(m_notifiers[resource], &QSocketNotifier::activated, this,
+          [this, resource]() {
+            m_stalled[resource] = true;
+            emit stalled(1 << resource);
+          });
+}
+
+bool PressureSampler::read(PressureValues values[ResourceCount]) {
+  bool any = false;
+  for (int i = 0; i < ResourceCount; ++i) {
+    PressureValues &value = values[i];
+    value = PressureValues();
+    value.stalled = m_stalled[i];
+    m_stalled[i] = false;
+
+    const qsizetype n = m_files[i].read(m_buffer, sizeof(m_buffer));
+    if (n <= 0)
+      continue;
+    const char *end = m_buffer + n;
+    for (const char *line = m_buffer; line < end; line = nextLine(line, end)) {
+      if (startsWith(line, end, "some "))
+        parseLine(line, end, &value.some10, &value.some60);
+      else if (startsWith(line, end, "full "))
+        parseLine(line, end, &value.full10, &value.full60);
+    }
+    any = true;
+  }
+  return any;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "ProcFile.h"
+#include <QByteArray>
+#include <QObject>
+#include <QQmlEngine>
+
+class QSocketNotifier;
+
+// Pressure stall averages of one resource, in percent of wall time
+struct PressureValues {
+  Q_GADGET
+  QML_VALUE_TYPE(pressureValues)
+  Q_PROPERTY(double some10 MEMBER some10)
+  Q_PROPERTY(double some60 MEMBER some60)
+  Q_PROPERTY(double full10 MEMBER full10)
+  Q_PROPERTY(double full60 MEMBER full60)
+  Q_PROPERTY(bool stalled MEMBER stalled)
+
+public:
+  double some10 = 0.0; // Some task stalled, last 10 s
+  double some60 = 0.0;
+  double full10 = 0.0; // All non-idle tasks stalled (not for cpu before 5.13)
+  double full60 = 0.0;
+  bool stalled = false; // A stall trigger fired since the previous sample
+
+  bool operator==(const PressureValues &other) const = default;
+};
+
+// Linux pressure stall information (/proc/pressure/{cpu,memory,io}).
+//
+// While active, a PSI trigger is registered per resource ("some <stall>
+// <window>", written to the file and then polled for POLLPRI through a
+// QSocketNotifier), so a stall wakes the monitor thread at once and
+// averages can be polled slowly. Without PSI (kernel < 4.20 or
+// psi=0) isAvailable() is false. Triggers are only written to files on
+// procfs, never to fixture files under another proc root; there, and where
+// the kernel refuses them, the averages are read at the polling interval.
+class PressureSampler : public QObject {
+  Q_OBJECT
+
+public:
+  enum Resource { Cpu, Memory, Io, ResourceCount };
+
+  explicit PressureSampler(const QByteArray &procRoot = "/proc",
+                           QObject *parent = nullptr);
+  ~PressureSampler() override;
+
+  bool isAvailable() const;
+  void setActive(bool active);
+
+  // Averages per Resource; clears the stalled flags
+  bool read(PressureValues values[ResourceCount]);
+
+signals:
+  // Bit per Resource that crossed its trigger threshold
+  void stalled(int resources);
+
+private:
+  void openTrigger(int resource);
+
+  ProcFile m_files[ResourceCount];
+  int m_triggerFds[ResourceCount] = {-1, -1, -1};
+  QSocketNotifier *m_notifiers[ResourceCount] = {};
+  bool m_stalled[ResourceCount] = {};
+  bool m_triggersRefused = false; // Logged once, then not retried
+  char m_buffer[512];
+};
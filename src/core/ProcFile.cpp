@@ -0,0 +1,66 @@
+#include "ProcFile.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+QByteArray ProcFile::procRoot() {
+  const QByteArray root = qgetenv("CANVASDESK_PROC_ROOT");
+  return root.isEmpty() ? QByteArrayLiteral("/proc") : root;
+}
+
+QByteArray ProcFile::sysRoot() {
+  const QByteArray root = qgetenv("CANVASDESK_SYS_ROOT");
+  return root.isEmpty() ? QByteArrayLiteral("/sys") : root;
+}
+
+ProcFile &ProcFile::operator=(ProcFile &&other) noexcept {
+  if (this != &other) {
+    close();
+    m_fd = other.m_fd;
+    m_path = std::move(other.m_path);
+    other.m_fd = -1;
+  }
+  return *this;
+}
+
+bool ProcFile::open(const QByteArray &path) {
+  close();
+  m_path = path;
+  m_fd = ::open(path.constData(), O_RDONLY | O_CLOEXEC);
+  return m_fd >= 0;
+}
+
+void ProcFile::close() {
+  if (m_fd >= 0)
+    ::close(m_fd);
+  m_fd = -1;
+}
+
+qsizetype ProcFile::read(char *buffer, qsizetype capacity) {
+  if (capacity <= 0)
+    return -1;
+  if (m_fd < 0 && (m_path.isEmpty() || !open(m_path)))
+    return -1;
+
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    // seq_file-backed files may hand out one page per call
+    qsizetype total = 0;
+    ssize_t n = 0;
+    while (total < capacity - 1) {
+      n = ::pread(m_fd, buffer + total, size_t(capacity - 1 - total),
+                  off_t(total));
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        break;
+      total += n;
+    }
+    if (n >= 0) {
+      buffer[total] = '\0';
+      return total;
+    }
+    if (attempt == 0 && !open(m_path))
+      break;
+  }
+  return -1;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QByteArray>
+#include <QtGlobal>
+#include <cstring>
+
+// A /proc or /sys file kept open between samples. read() preads the current
+// contents from offset 0 into a caller-owned buffer, so sampling needs no
+// open/close and no allocation.
+class ProcFile {
+public:
+  ProcFile() = default;
+  explicit ProcFile(const QByteArray &path) { open(path); }
+  ~ProcFile() { close(); }
+
+  ProcFile(const ProcFile &) = delete;
+  ProcFile &operator=(const ProcFile &) = delete;
+  ProcFile(ProcFile &&other) noexcept
+      : m_fd(other.m_fd), m_path(std::move(other.m_path)) {
+    other.m_fd = -1;
+  }
+  ProcFile &operator=(ProcFile &&other) noexcept;
+
+  bool open(const QByteArray &path);
+  void close();
+  bool isOpen() const { return m_fd >= 0; }
+  int fd() const { return m_fd; }
+  const QByteArray &path() const { return m_path; }
+
+  // Where samplers look for proc and sys files by default:
+  // $CANVASDESK_PROC_ROOT / $CANVASDESK_SYS_ROOT, else /proc and /sys. Lets
+  // the monitors run against a directory of fixture files.
+  static QByteArray procRoot();
+  static QByteArray sysRoot();
+
+  // Bytes read (NUL-terminated, capacity includes the terminator), or -1.
+  // Reopens once if the file went away (e.g. a hot-unplugged sysfs node).
+  qsizetype read(char *buffer, qsizetype capacity);
+
+private:
+  int m_fd = -1;
+  QByteArray m_path;
+};
+
+// Allocation-free scanners for /proc and /sys text. Each takes a [p, end)
+// range and returns the position after what it consumed.
+namespace ProcParse {
+
+inline const char *skipSpaces(const char *p, const char *end) {
+  while (p < end && (*p == ' ' || *p == '\t'))
+    ++p;
+  return p;
+}
+
+inline const char *skipField(const char *p, const char *end) {
+  p = skipSpaces(p, end);
+  while (p < end && *p != ' ' && *p != '\t' && *p != '\n')
+    ++p;
+  return p;
+}
+
+inline const char *nextLine(const char *p, const char *end) {
+  const void *nl = std::memchr(p, '\n', size_t(end - p));
+  return nl ? static_cast<const char *>(nl) + 1 : end;
+}
+
+inline bool startsWith(const char *p, const char *end, const char *prefix) {
+  const size_t len = std::strlen(prefix);
+  return size_t(end - p) >= len && std::memcmp(p, prefix, len) == 0;
+}
+
+// Unsigned decimal after optional blanks; `ok` is false if there were no
+// digits (the value is then left at 0)
+inline const char *parseU64(const char *p, const char *end, quint64 *value,
+                            bool *ok = nullptr) {
+  p = skipSpaces(p, end);
+  quint64 v = 0;
+  const char *start = p;
+  while (p < end && *p >= '0' && *p <= '9') {
+    v = v * 10 + quint64(*p - '0');
+    ++p;
+  }
+  *value = v;
+  if (ok)
+    *ok = p != start;
+  return p;
+}
+
+// Non-negative decimal such as "12.34"; same conventions as parseU64
+inline const char *parseDouble(const char *p, const char *end, double *value,
+                               bool *ok = nullptr) {
+  quint64 whole = 0;
+  bool haveDigits = false;
+  p = parseU64(p, end, &whole, &haveDigits);
+  double v = double(whole);
+  if (p < end && *p == '.') {
+    double scale = 0.1;
+    for (++p; p < end && *p >= '0' && *p <= '9'; ++p, scale /= 10) {
+      v += (*p - '0') * scale;
+      haveDigits = true;
+    }
+  }
+  *value = v;
+  if (ok)
+    *ok = haveDigits;
+  return p;
+}
+
+} // namespace ProcParse
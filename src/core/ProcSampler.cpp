@@ -0,0 +1,168 @@
+#include "ProcSampler.h"
+#include <unistd.h>
+
+using namespace ProcParse;
+
+namespace {
+
+// Interface names seen before; bounds the cache under veth churn
+const int MaxInterfaceKinds = 256;
+
+const char *parseCpuTimes(const char *p, const char *end, CpuTimes *t) {
+  p = parseU64(p, end, &t->user);
+  p = parseU64(p, end, &t->nice);
+  p = parseU64(p, end, &t->system);
+  p = parseU64(p, end, &t->idle);
+  // Fields added by later kernels read as 0 when missing
+  p = parseU64(p, end, &t->iowait);
+  p = parseU64(p, end, &t->irq);
+  p = parseU64(p, end, &t->softirq);
+  p = parseU64(p, end, &t->steal);
+  return p;
+}
+
+} // namespace
+
+double CpuTimes::usage(const CpuTimes &prev, const CpuTimes &now) {
+  const quint64 total = now.total();
+  const quint64 prevTotal = prev.total();
+  if (prevTotal == 0 || total <= prevTotal)
+    return 0.0;
+
+  const quint64 totalDelta = total - prevTotal;
+  const quint64 idleDelta =
+      now.idleTime() >= prev.idleTime() ? now.idleTime() - prev.idleTime() : 0;
+  return double(totalDelta - qMin(idleDelta, totalDelta)) / totalDelta;
+}
+
+ProcSampler::ProcSampler(const QByteArray &procRoot,
+                         const QByteArray &sysRoot)
+    : m_stat(procRoot + "/stat"), m_meminfo(procRoot + "/meminfo"),
+      m_netDev(procRoot + "/net/dev"), m_sysRoot(sysRoot),
+      m_buffer(BufferSize, Qt::Uninitialized) {}
+
+bool ProcSampler::readCpu(CpuTimes *total, QVector<CpuTimes> *cores) {
+  char *buffer = m_buffer.data();
+  const qsizetype n = m_stat.read(buffer, BufferSize);
+  if (n <= 0 || !startsWith(buffer, buffer + n, "cpu "))
+    return false;
+
+  const char *end = buffer + n;
+  const char *line = buffer;
+  parseCpuTimes(line + 4, end, total);
+  if (!cores)
+    return true;
+
+  // "cpuN ..." lines follow the aggregate line
+  for (line = nextLine(line, end); startsWith(line, end, "cpu");
+       line = nextLine(line, end)) {
+    quint64 index = 0;
+    bool ok = false;
+    const char *p = parseU64(line + 3, end, &index, &ok);
+    if (!ok || index > 4096)
+      continue;
+    if (index >= quint64(cores->size()))
+      cores->resize(int(index) + 1);
+    parseCpuTimes(p, end, &(*cores)[int(index)]);
+  }
+  return true;
+}
+
+bool ProcSampler::readMemory(MemoryInfo *info) {
+  char *buffer = m_buffer.data();
+  const qsizetype n = m_meminfo.read(buffer, BufferSize);
+  if (n <= 0)
+    return false;
+
+  struct Field {
+    const char *key;
+    quint64 *value;
+  };
+  const Field fields[] = {
+      {"MemTotal:", &info->total},
+      {"MemFree:", &info->free},
+      {"MemAvailable:", &info->available},
+      {"Buffers:", &info->buffers},
+      {"Cached:", &info->cached},
+      {"SwapTotal:", &info->swapTotal},
+      {"SwapFree:", &info->swapFree},
+  };
+  const int fieldCount = int(sizeof(fields) / sizeof(fields[0]));
+
+  const char *end = buffer + n;
+  int found = 0;
+  for (const char *line = buffer; line < end && found < fieldCount;
+       line = nextLine(line, end)) {
+    for (const Field &field : fields) {
+      if (startsWith(line, end, field.key)) {
+        parseU64(line + std::strlen(field.key), end, field.value);
+        ++found;
+        break;
+      }
+    }
+  }
+  return info->total > 0;
+}
+
+bool ProcSampler::readNetwork(QVector<NetworkCounters> *interfaces) {
+  char *buffer = m_buffer.data();
+  const qsizetype n = m_netDev.read(buffer, BufferSize);
+  if (n <= 0)
+    return false;
+
+  // Two header lines, then "  name: rx-bytes rx-packets errs drop fifo frame
+  // compressed multicast tx-bytes tx-packets ..."
+  const char *end = buffer + n;
+  const char *line = nextLine(nextLine(buffer, end), end);
+  int count = 0;
+  for (; line < end; line = nextLine(line, end)) {
+    const char *name = skipSpaces(line, end);
+    const char *colon = name;
+    while (colon < end && *colon != ':' && *colon != '\n')
+      ++colon;
+    const size_t length = size_t(colon - name);
+    if (colon >= end || *colon != ':' || length == 0 ||
+        length >= sizeof(NetworkCounters::name))
+      continue;
+
+    char ifname[sizeof(NetworkCounters::name)];
+    std::memcpy(ifname, name, length);
+    ifname[length] = '\0';
+    if (!isPhysical(ifname))
+      continue;
+
+    if (count >= interfaces->size())
+      interfaces->resize(count + 1);
+    NetworkCounters &counters = (*interfaces)[count++];
+    std::memcpy(counters.name, ifname, length + 1);
+
+    const char *p = parseU64(colon + 1, end, &counters.rxBytes);
+    p = parseU64(p, end, &counters.rxPackets);
+    for (int field = 0; field < 6; ++field)
+      p = skipField(p, end);
+    p = parseU64(p, end, &counters.txBytes);
+    parseU64(p, end, &counters.txPackets);
+  }
+
+  if (count != interfaces->size())
+    interfaces->resize(count);
+  return true;
+}
+
+bool ProcSampler::isPhysical(const char *name) {
+  for (const InterfaceKind &kind : std::as_const(m_interfaceKinds)) {
+    if (std::strcmp(kind.name, name) == 0)
+      return kind.physical;
+  }
+
+  if (m_interfaceKinds.size() >= MaxInterfaceKinds)
+    m_interfaceKinds.clear();
+
+  // Only looked up the first time a name appears
+  const QByteArray device = m_sysRoot + "/class/net/" + name + "/device";
+  InterfaceKind kind;
+  std::memcpy(kind.name, name, std::strlen(name) + 1);
+  kind.physical = ::access(device.constData(), F_OK) == 0;
+  m_interfaceKinds.append(kind);
+  return kind.physical;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "ProcFile.h"
+#include <QByteArray>
+#include <QVector>
+
+// Cumulative jiffies from a "cpu" line of /proc/stat. guest/guest_nice are
+// already counted in user/nice by the kernel and are left out.
+struct CpuTimes {
+  quint64 user = 0;
+  quint64 nice = 0;
+  quint64 system = 0;
+  quint64 idle = 0;
+  quint64 iowait = 0;
+  quint64 irq = 0;
+  quint64 softirq = 0;
+  quint64 steal = 0;
+
+  quint64 idleTime() const { return idle + iowait; }
+  quint64 total() const {
+    return user + nice + system + idle + iowait + irq + softirq + steal;
+  }
+
+  // Busy fraction between two samples (0..1)
+  static double usage(const CpuTimes &prev, const CpuTimes &now);
+};
+
+struct MemoryInfo { // KiB, as in /proc/meminfo
+  quint64 total = 0;
+  quint64 available = 0;
+  quint64 free = 0;
+  quint64 buffers = 0;
+  quint64 cached = 0;
+  quint64 swapTotal = 0;
+  quint64 swapFree = 0;
+
+  double usage() const {
+    return total > 0 ? double(total - qMin(available, total)) / total : 0.0;
+  }
+};
+
+// Cumulative counters of one interface from /proc/net/dev
+struct NetworkCounters {
+  char name[16] = {}; // IFNAMSIZ, NUL-terminated
+  quint64 rxBytes = 0;
+  quint64 rxPackets = 0;
+  quint64 txBytes = 0;
+  quint64 txPackets = 0;
+};
+
+// Reads /proc/stat, /proc/meminfo and /proc/net/dev without allocating: the
+// files stay open and are pread into one buffer allocated up front, then
+// scanned in place.
+class ProcSampler {
+public:
+  static constexpr qsizetype BufferSize = 64 * 1024; // /proc/stat on ~900 CPUs
+
+  explicit ProcSampler(const QByteArray &procRoot = "/proc",
+                       const QByteArray &sysRoot = "/sys");
+
+  // `cores` (optional) is indexed by CPU number; it is only resized when the
+  // number of CPUs changes. Offline CPUs keep their last times.
+  bool readCpu(CpuTimes *total, QVector<CpuTimes> *cores = nullptr);
+  bool readMemory(MemoryInfo *info);
+  // Physical interfaces only, in kernel order; `interfaces` is only resized
+  // when that set changes. Loopback, bridges, veth, tun and other virtual
+  // devices have no <sys>/class/net/<name>/device and are skipped.
+  bool readNetwork(QVector<NetworkCounters> *interfaces);
+
+private:
+  struct InterfaceKind {
+    char name[16];
+    bool physical;
+  };
+
+  bool isPhysical(const char *name);
+
+  ProcFile m_stat;
+  ProcFile m_meminfo;
+  ProcFile m_netDev;
+  QByteArray m_sysRoot;
+  QByteArray m_buffer;
+  QVector<InterfaceKind> m_interfaceKinds; // Checked once per name
+};
@@ -0,0 +1,151 @@
+#include "ProcessLauncher.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSocketNotifier>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <spawn.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+extern char **environ;
+
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 29)
+#define HAVE_SPAWN_ADDCHDIR 1
+#endif
+#endif
+
+ProcessLauncher::ProcessLauncher(QObject *parent) : QObject(parent) {
+  m_reapTimer.setInterval(2000);
+  connect(&m_reapTimer, &QTimer::timeout, this, &ProcessLauncher::reapPolled);
+}
+
+qint64 ProcessLauncher::start(const QStringList &arguments,
+                              const Options &options) {
+  if (arguments.isEmpty())
+    return -1;
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // Build argv/envp up front; the child only execs
+  QList<QByteArray> args;
+  args.reserve(arguments.size());
+  for (const QString &arg : arguments)
+    args << QFile::encodeName(arg);
+  std::vector<char *> argv;
+  argv.reserve(args.size() + 1);
+  for (QByteArray &arg : args)
+    argv.push_back(arg.data());
+  argv.push_back(nullptr);
+
+  QList<QByteArray> env = options.environment;
+  std::vector<char *> envp;
+  for (char **var = environ; *var; ++var) {
+    const QByteArrayView entry(*var);
+    const QByteArrayView key =
+        entry.first(qMax<qsizetype>(entry.indexOf('='), 0));
+    bool overridden = false;
+    for (const QByteArray &extra : env) {
+      if (extra.startsWith(key) && extra.size() > key.size() &&
+          extra.at(key.size()) == '=') {
+        overridden = true;
+        break;
+      }
+    }
+    if (!overridden)
+      envp.push_back(*var);
+  }
+  for (QByteArray &extra : env)
+    envp.push_back(extra.data());
+  envp.push_back(nullptr);
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  QByteArray workingDir = QFile::encodeName(options.workingDir);
+#ifdef HAVE_SPAWN_ADDCHDIR
+  if (!workingDir.isEmpty())
+    posix_spawn_file_actions_addchdir_np(&actions, workingDir.constData());
+#else
+  if (!workingDir.isEmpty())
+    qWarning() << "[ProcessLauncher] Working directory not supported here:"
+               << options.workingDir;
+#endif
+
+  // New session (detached from ours), default signal handlers and an empty
+  // signal mask regardless of what the GUI thread has blocked
+  posix_spawnattr_t attr;
+  posix_spawnattr_init(&attr);
+  short flags = POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF;
+#ifdef POSIX_SPAWN_SETSID
+  flags |= POSIX_SPAWN_SETSID;
+#endif
+  posix_spawnattr_setflags(&attr, flags);
+  sigset_t signals;
+  sigemptyset(&signals);
+  posix_spawnattr_setsigmask(&attr, &signals);
+  sigfillset(&signals);
+  sigdelset(&signals, SIGKILL);
+  sigdelset(&signals, SIGSTOP);
+  posix_spawnattr_setsigdefault(&attr, &signals);
+
+  pid_t pid = -1;
+  const int error = posix_spawnp(&pid, argv[0], &actions, &attr, argv.data(),
+                                 envp.data());
+  posix_spawnattr_destroy(&attr);
+  posix_spawn_file_actions_destroy(&actions);
+
+  m_lastLatencyNs = timer.nsecsElapsed();
+
+  if (error != 0) {
+    qWarning() << "[ProcessLauncher] Failed to start" << arguments.first()
+               << ":" << strerror(error);
+    return -1;
+  }
+
+  watchChild(pid);
+  return pid;
+}
+
+void ProcessLauncher::watchChild(qint64 pid) {
+  int fd = -1;
+#ifdef SYS_pidfd_open
+  fd = int(syscall(SYS_pidfd_open, pid_t(pid), 0));
+#endif
+  if (fd < 0) {
+    m_polled.append(pid);
+    if (!m_reapTimer.isActive())
+      m_reapTimer.start();
+    return;
+  }
+
+  // A pidfd becomes readable when the process exits
+  auto *notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+  connect(notifier, &QSocketNotifier::activated, this, [this, notifier, pid]() {
+    notifier->setEnabled(false);
+    int status = 0;
+    if (waitpid(pid_t(pid), &status, WNOHANG) > 0)
+      emit exited(pid, status);
+    close(int(notifier->socket()));
+    notifier->deleteLater();
+  });
+}
+
+void ProcessLauncher::reapPolled() {
+  for (int i = m_polled.size() - 1; i >= 0; --i) {
+    int status = 0;
+    const pid_t result = waitpid(pid_t(m_polled.at(i)), &status, WNOHANG);
+    if (result == 0)
+      continue; // Still running
+    const qint64 pid = m_polled.takeAt(i);
+    if (result > 0)
+      emit exited(pid, status);
+  }
+  if (m_polled.isEmpty())
+    m_reapTimer.stop();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+// Starts detached applications with posix_spawnp (vfork-style on glibc) and
+// no intermediate shell. Children are reaped when they exit via a pidfd, or
+// by polling on kernels without pidfd_open.
+class ProcessLauncher : public QObject {
+  Q_OBJECT
+
+public:
+  struct Options {
+    QString workingDir;
+    QList<QByteArray> environment; // "KEY=value", added or overridden
+  };
+
+  explicit ProcessLauncher(QObject *parent = nullptr);
+
+  // Returns the pid, or -1 if the program couldn't be started
+  qint64 start(const QStringList &arguments, const Options &options = {});
+
+  qint64 lastLatencyNs() const { return m_lastLatencyNs; }
+
+signals:
+  void exited(qint64 pid, int status);
+
+private:
+  void watchChild(qint64 pid);
+  void reapPolled();
+
+  QList<qint64> m_polled; // Children without a pidfd
+  QTimer m_reapTimer;
+  qint64 m_lastLatencyNs = 0;
+};
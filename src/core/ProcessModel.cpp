@@ -0,0 +1,127 @@
+#include "ProcessModel.h"
+#include <QSet>
+
+ProcessModel::ProcessModel(QObject *parent) : QAbstractListModel(parent) {}
+
+int ProcessModel::rowCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant ProcessModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid() || index.row() >= m_rows.size())
+    return {};
+
+  const ProcessInfo &info = m_rows.at(index.row());
+  switch (role) {
+  case PidRole:
+    return info.pid;
+  case Qt::DisplayRole:
+  case NameRole:
+    return info.name;
+  case CpuRole:
+    return info.cpu;
+  case MemoryRole:
+    return double(info.rssBytes); // QML numbers are doubles anyway
+  case StateRole:
+    return QString(QLatin1Char(info.state));
+  case ParentPidRole:
+    return info.ppid;
+  }
+  return {};
+}
+
+QHash<int, QByteArray> ProcessModel::roleNames() const {
+  return {{PidRole, "pid"},     {NameRole, "name"},
+          {CpuRole, "cpu"},     {MemoryRole, "memory"},
+          {StateRole, "state"}, {ParentPidRole, "ppid"}};
+}
+
+void ProcessModel::setSortBy(SortKey key) {
+  if (m_sortBy == key)
+    return;
+  m_sortBy = key;
+  emit queryChanged();
+}
+
+void ProcessModel::setLimit(int limit) {
+  limit = qMax(0, limit);
+  if (m_limit == limit)
+    return;
+  m_limit = limit;
+  emit queryChanged();
+}
+
+void ProcessModel::setProcesses(const QVector<ProcessInfo> &processes,
+                                int totalCount) {
+  const int oldCount = m_rows.size();
+
+  QSet<int> pids;
+  pids.reserve(processes.size());
+  for (const ProcessInfo &info : processes)
+    pids.insert(info.pid);
+
+  // Drop rows that left the top N (bottom-up so row numbers stay valid)
+  for (int row = m_rows.size() - 1; row >= 0; --row) {
+    if (!pids.contains(m_rows.at(row).pid)) {
+      beginRemoveRows(QModelIndex(), row, row);
+      m_rows.removeAt(row);
+      endRemoveRows();
+    }
+  }
+
+  for (int i = 0; i < processes.size(); ++i) {
+    const ProcessInfo &info = processes.at(i);
+    if (i < m_rows.size() && m_rows.at(i).pid == info.pid) {
+      updateRow(i, info);
+      continue;
+    }
+
+    const int existing = rowOf(info.pid, i + 1);
+    if (existing != -1) {
+      beginMoveRows(QModelIndex(), existing, existing, QModelIndex(), i);
+      m_rows.move(existing, i);
+      endMoveRows();
+      updateRow(i, info);
+    } else {
+      beginInsertRows(QModelIndex(), i, i);
+      m_rows.insert(i, info);
+      endInsertRows();
+    }
+  }
+
+  if (m_rows.size() != oldCount)
+    emit countChanged();
+  if (m_totalCount != totalCount) {
+    m_totalCount = totalCount;
+    emit totalCountChanged();
+  }
+}
+
+int ProcessModel::rowOf(int pid, int from) const {
+  for (int row = from; row < m_rows.size(); ++row) {
+    if (m_rows.at(row).pid == pid)
+      return row;
+  }
+  return -1;
+}
+
+void ProcessModel::updateRow(int row, const ProcessInfo &info) {
+  ProcessInfo &current = m_rows[row];
+  QList<int> roles;
+  if (current.name != info.name)
+    roles << NameRole << Qt::DisplayRole;
+  if (current.cpu != info.cpu)
+    roles << CpuRole;
+  if (current.rssBytes != info.rssBytes)
+    roles << MemoryRole;
+  if (current.state != info.state)
+    roles << StateRole;
+  if (current.ppid != info.ppid)
+    roles << ParentPidRole;
+
+  if (!roles.isEmpty()) {
+    current = info;
+    const QModelIndex idx = index(row);
+    emit dataChanged(idx, idx, roles);
+  }
+}
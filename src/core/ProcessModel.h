@@ -0,0 +1,67 @@
+#pragma once
+
+#include "ProcessScanner.h"
+#include <QAbstractListModel>
+#include <QQmlEngine>
+
+// Top processes as a list model (SystemMonitor.processes, or one per table
+// from SystemMonitor.createProcessModel()).
+//
+// sortBy and limit are this model's query; the sampling thread ranks each
+// sort key once for all models. setProcesses() reconciles each result by pid,
+// so a delegate survives re-sorting and only rows whose numbers changed are
+// refreshed.
+class ProcessModel : public QAbstractListModel {
+  Q_OBJECT
+  QML_ELEMENT
+  QML_UNCREATABLE("Use SystemMonitor.createProcessModel()")
+  Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+  Q_PROPERTY(SortKey sortBy READ sortBy WRITE setSortBy NOTIFY queryChanged)
+  Q_PROPERTY(int limit READ limit WRITE setLimit NOTIFY queryChanged)
+  Q_PROPERTY(int totalCount READ totalCount NOTIFY totalCountChanged)
+
+public:
+  enum Roles {
+    PidRole = Qt::UserRole + 1,
+    NameRole,
+    CpuRole,
+    MemoryRole,
+    StateRole,
+    ParentPidRole
+  };
+
+  enum SortKey { Cpu = ProcessScanner::ByCpu, Memory = ProcessScanner::ByMemory };
+  Q_ENUM(SortKey)
+
+  static constexpr int DefaultLimit = 15;
+
+  explicit ProcessModel(QObject *parent = nullptr);
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index, int role) const override;
+  QHash<int, QByteArray> roleNames() const override;
+
+  SortKey sortBy() const { return m_sortBy; }
+  void setSortBy(SortKey key);
+  int limit() const { return m_limit; }
+  void setLimit(int limit);
+  // Processes on the system, not just the rows shown
+  int totalCount() const { return m_totalCount; }
+
+  // Rows are matched by pid; order follows `processes`
+  void setProcesses(const QVector<ProcessInfo> &processes, int totalCount);
+
+signals:
+  void countChanged();
+  void queryChanged();
+  void totalCountChanged();
+
+private:
+  int rowOf(int pid, int from) const;
+  void updateRow(int row, const ProcessInfo &info);
+
+  QVector<ProcessInfo> m_rows;
+  SortKey m_sortBy = Cpu;
+  int m_limit = DefaultLimit;
+  int m_totalCount = 0;
+};
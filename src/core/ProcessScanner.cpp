@@ -0,0 +1,191 @@
+#include "ProcessScanner.h"
+#include "ProcFile.h"
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace ProcParse;
+
+namespace {
+
+// Layout of the records returned by getdents64
+struct LinuxDirent64 {
+  quint64 d_ino;
+  qint64 d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[];
+};
+
+// "<pid>/stat" without snprintf
+void statPath(int pid, char *out) {
+  char digits[16];
+  int n = 0;
+  do {
+    digits[n++] = char('0' + pid % 10);
+    pid /= 10;
+  } while (pid > 0);
+  while (n > 0)
+    *out++ = digits[--n];
+  std::memcpy(out, "/stat", 6);
+}
+
+} // namespace
+
+ProcessScanner::ProcessScanner(const QByteArray &procRoot) {
+  m_procFd = ::open(procRoot.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  m_dirFd = ::open(procRoot.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (m_procFd < 0 || m_dirFd < 0)
+    qWarning() << "[ProcessScanner] Cannot open" << procRoot;
+
+  m_ticksPerSecond = qMax(1L, sysconf(_SC_CLK_TCK));
+  m_pageSize = qMax(1L, sysconf(_SC_PAGESIZE));
+  m_cpuCount = int(qMax(1L, sysconf(_SC_NPROCESSORS_ONLN)));
+}
+
+ProcessScanner::~ProcessScanner() {
+  if (m_procFd >= 0)
+    ::close(m_procFd);
+  if (m_dirFd >= 0)
+    ::close(m_dirFd);
+}
+
+void ProcessScanner::scan() {
+  if (m_procFd < 0 || m_dirFd < 0)
+    return;
+
+  // CPU capacity between scans, in ticks; 0 on the first scan
+  const double elapsedTicks =
+      m_sinceLastScan.isValid()
+          ? m_sinceLastScan.nsecsElapsed() / 1e9 * m_ticksPerSecond * m_cpuCount
+          : 0.0;
+  m_sinceLastScan.start();
+  ++m_generation;
+
+  ::lseek(m_dirFd, 0, SEEK_SET);
+  for (;;) {
+    const long n =
+        syscall(SYS_getdents64, m_dirFd, m_dirBuffer, sizeof(m_dirBuffer));
+    if (n <= 0)
+      break;
+    for (long offset = 0; offset < n;) {
+      const auto *entry =
+          reinterpret_cast<const LinuxDirent64 *>(m_dirBuffer + offset);
+      offset += entry->d_reclen;
+
+      // Only numeric directories are processes
+      const char *name = entry->d_name;
+      if (*name < '1' || *name > '9')
+        continue;
+      int pid = 0;
+      for (; *name >= '0' && *name <= '9'; ++name)
+        pid = pid * 10 + (*name - '0');
+      if (*name == '\0')
+        readProcess(pid, elapsedTicks);
+    }
+  }
+
+  // Drop processes that exited
+  for (auto it = m_records.begin(); it != m_records.end();) {
+    if (it->generation != m_generation)
+      it = m_records.erase(it);
+    else
+      ++it;
+  }
+}
+
+QVector<ProcessInfo> ProcessScanner::top(SortKey key, int limit) const {
+  m_order.clear(); // Keeps its capacity between scans
+  for (const Record &record : m_records)
+    m_order.append(&record);
+
+  const int count = qBound(0, limit, int(m_order.size()));
+  auto larger = [key](const Record *a, const Record *b) {
+    if (key == ByMemory)
+      return a->rssPages != b->rssPages ? a->rssPages > b->rssPages
+                                        : a->cpu > b->cpu;
+    return a->cpu != b->cpu ? a->cpu > b->cpu : a->rssPages > b->rssPages;
+  };
+  std::partial_sort(m_order.begin(), m_order.begin() + count, m_order.end(),
+                    larger);
+
+  QVector<ProcessInfo> top;
+  top.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    const Record *record = m_order[i];
+    ProcessInfo info;
+    info.pid = record->pid;
+    info.ppid = record->ppid;
+    info.name = record->name; // Implicitly shared, no copy
+    info.state = record->state;
+    info.cpu = record->cpu;
+    info.rssBytes = record->rssPages * quint64(m_pageSize);
+    top.append(info);
+  }
+  return top;
+}
+
+bool ProcessScanner::readProcess(int pid, double elapsedTicks) {
+  char path[24];
+  statPath(pid, path);
+  const int fd = ::openat(m_procFd, path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false; // Exited between getdents and open
+  const ssize_t n = ::read(fd, m_statBuffer, sizeof(m_statBuffer) - 1);
+  ::close(fd);
+  if (n <= 0)
+    return false;
+
+  // "pid (comm) state ppid ..." -- comm may itself contain ") "
+  const char *begin = m_statBuffer;
+  const char *end = m_statBuffer + n;
+  const char *open = static_cast<const char *>(std::memchr(begin, '(', n));
+  const char *close = static_cast<const char *>(memrchr(begin, ')', n));
+  if (!open || !close || close < open || close + 2 >= end)
+    return false;
+
+  const char *p = close + 2;
+  const char state = *p++;
+  quint64 ppid = 0;
+  p = parseU64(p, end, &ppid); // field 4
+  for (int field = 5; field < 14; ++field)
+    p = skipField(p, end);
+  quint64 utime = 0, stime = 0;
+  p = parseU64(p, end, &utime); // 14
+  p = parseU64(p, end, &stime); // 15
+  for (int field = 16; field < 22; ++field)
+    p = skipField(p, end);
+  quint64 startTime = 0;
+  p = parseU64(p, end, &startTime); // 22
+  p = skipField(p, end);            // 23 vsize
+  quint64 rss = 0;
+  parseU64(p, end, &rss); // 24
+
+  Record &record = m_records[pid];
+  const quint64 ticks = utime + stime;
+  const int commLength = qMin(int(close - open - 1), int(sizeof(record.comm)));
+  if (record.commLength != commLength ||
+      std::memcmp(record.comm, open + 1, size_t(commLength)) != 0) {
+    std::memcpy(record.comm, open + 1, size_t(commLength));
+    record.commLength = commLength;
+    record.name = QString::fromUtf8(open + 1, commLength);
+  }
+
+  if (record.generation == 0 || record.startTime != startTime) {
+    // New process (or a reused pid): no CPU delta yet
+    record.pid = pid;
+    record.startTime = startTime;
+    record.cpu = 0.0;
+  } else if (elapsedTicks > 0 && ticks >= record.ticks) {
+    record.cpu = qMin(1.0, (ticks - record.ticks) / elapsedTicks);
+  }
+  record.ticks = ticks;
+  record.rssPages = rss;
+  record.ppid = int(ppid);
+  record.state = state;
+  record.generation = m_generation;
+  return true;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+// One row of the process table
+struct ProcessInfo {
+  int pid = 0;
+  int ppid = 0;
+  QString name;
+  char state = '?';
+  double cpu = 0.0;     // Share of total CPU capacity since the last scan (0..1)
+  quint64 rssBytes = 0; // Resident set size
+
+  bool operator==(const ProcessInfo &other) const {
+    return pid == other.pid && ppid == other.ppid && name == other.name &&
+           state == other.state && cpu == other.cpu &&
+           rssBytes == other.rssBytes;
+  }
+};
+
+// Incremental /proc scanner for the top-N process table.
+//
+// /proc stays open as a directory fd; each scan lists it with getdents64 into
+// a fixed buffer and reads every <pid>/stat through openat() into another, so
+// nothing is allocated per process except a record the first time a pid is
+// seen. Records keep the previous CPU ticks (CPU % is the delta) and the name
+// as a QString built once. A pid reused by a new process is detected by its
+// start time. RSS comes from the rss field of stat, which makes a second read
+// of statm unnecessary.
+class ProcessScanner {
+public:
+  enum SortKey { ByCpu, ByMemory, SortKeyCount };
+
+  explicit ProcessScanner(const QByteArray &procRoot = "/proc");
+  ~ProcessScanner();
+
+  ProcessScanner(const ProcessScanner &) = delete;
+  ProcessScanner &operator=(const ProcessScanner &) = delete;
+
+  // Re-reads every process
+  void scan();
+  // The `limit` largest processes of the last scan by `key`, descending
+  QVector<ProcessInfo> top(SortKey key, int limit) const;
+
+  int processCount() const { return m_records.size(); }
+
+  // CPU shares need a previous scan; after a pause, start over so the first
+  // values do not average over the whole pause
+  bool hasBaseline() const { return m_sinceLastScan.isValid(); }
+  void resetBaseline() { m_sinceLastScan.invalidate(); }
+
+private:
+  struct Record {
+    int pid = 0;
+    quint64 startTime = 0;
+    quint64 ticks = 0; // utime + stime
+    quint64 rssPages = 0;
+    int ppid = 0;
+    char state = '?';
+    double cpu = 0.0;
+    quint32 generation = 0;
+    char comm[16] = {}; // Raw name, to notice renames without a QString
+    int commLength = 0;
+    QString name;
+  };
+
+  bool readProcess(int pid, double elapsedTicks);
+
+  int m_procFd = -1;
+  int m_dirFd = -1; // Separate fd for getdents64 (rewound each scan)
+  QHash<int, Record> m_records;
+  mutable QVector<const Record *> m_order; // Reused for the top-N selection
+  quint32 m_generation = 0;
+  QElapsedTimer m_sinceLastScan;
+
+  long m_ticksPerSecond = 100;
+  long m_pageSize = 4096;
+  int m_cpuCount = 1;
+
+  char m_dirBuffer[32 * 1024];
+  char m_statBuffer[1024];
+};
@@ -0,0 +1,98 @@
+#include "SceneModel.h"
+#include "ComponentDiff.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QJSValue>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QUuid>
+
+SceneModel::SceneModel(QObject *parent) : QObject(parent) {
+  m_root = buildTree(QVariantMap(), this);
+}
+
+Component *SceneModel::buildTree(const QVariantMap &layout, QObject *parent) {
+  auto *root = new Component(parent);
+  root->setType("Desktop");
+
+  const QVariantList components = layout.value("components").toList();
+  for (int i = 0; i < components.size(); ++i) {
+    QVariantMap data = components.at(i).toMap();
+    QString fallbackUid =
+        QString("%1#%2").arg(data.value("type").toString()).arg(i);
+    root->insertChild(i, Component::fromVariant(data, fallbackUid, root));
+  }
+  return root;
+}
+
+QVariantMap SceneModel::toLayoutMap(const QVariant &layout) {
+  if (layout.typeId() == QMetaType::QString) {
+    QJsonParseError error;
+    QJsonDocument doc =
+        QJsonDocument::fromJson(layout.toString().toUtf8(), &error);
+    if (error.error != QJsonParseError::NoError) {
+      qWarning() << "[SceneModel] Invalid layout JSON:" << error.errorString();
+      return {};
+    }
+    return doc.object().toVariantMap();
+  }
+  if (layout.userType() == qMetaTypeId<QJSValue>())
+    return layout.value<QJSValue>().toVariant().toMap();
+  return layout.toMap();
+}
+
+void SceneModel::reset(const QVariant &layout) {
+  replaceRoot(buildTree(toLayoutMap(layout), this));
+}
+
+QVariantList SceneModel::update(const QVariant &layout) {
+  QElapsedTimer timer;
+  timer.start();
+
+  Component *next = buildTree(toLayoutMap(layout), this);
+  QList<ComponentPatch> patches = ComponentDiff::diff(m_root, next);
+  replaceRoot(next);
+
+  qDebug() << "[SceneModel] Layout diff:" << patches.size() << "patches in"
+           << timer.nsecsElapsed() / 1000 << "us";
+  return ComponentDiff::toVariantList(patches);
+}
+
+bool SceneModel::applyPatches(const QVariantList &patches) {
+  bool ok =
+      ComponentDiff::apply(m_root, ComponentDiff::fromVariantList(patches));
+  emit sceneChanged();
+  return ok;
+}
+
+QVariantMap SceneModel::toLayout(const Component *root) {
+  QVariantList components;
+  if (root) {
+    for (const Component *child : root->childrenList())
+      components.append(child->toVariant());
+  }
+
+  QVariantMap layout;
+  layout["components"] = components;
+  return layout;
+}
+
+QVariantMap SceneModel::layout() const { return toLayout(m_root); }
+
+QVariantMap SceneModel::componentData(const QString &uid) const {
+  const Component *node = m_root->findByUid(uid);
+  return node && node != m_root ? node->toVariant() : QVariantMap();
+}
+
+QString SceneModel::createUid(const QString &type) const {
+  return type + "-" + QUuid::createUuid().toString(QUuid::Id128).left(12);
+}
+
+void SceneModel::replaceRoot(Component *root) {
+  if (m_root == root)
+    return;
+  Component *old = m_root;
+  m_root = root;
+  delete old;
+  emit sceneChanged();
+}
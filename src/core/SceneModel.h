@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Component.h"
+#include <QObject>
+#include <QQmlEngine>
+#include <QVariant>
+#include <QVariantList>
+
+// Canonical desktop scene: a Component tree mirroring what is on screen.
+// QML hosts feed it layouts (JSON string or object) and get back the minimal
+// patch list to apply to their live items instead of rebuilding everything.
+class SceneModel : public QObject {
+  Q_OBJECT
+  QML_ELEMENT
+  Q_PROPERTY(Component *root READ root NOTIFY sceneChanged)
+
+public:
+  explicit SceneModel(QObject *parent = nullptr);
+
+  Component *root() const { return m_root; }
+
+  // Adopt a layout without producing patches (resync with live items)
+  Q_INVOKABLE void reset(const QVariant &layout);
+  // Adopt a layout and return the patches that turn the old scene into it
+  Q_INVOKABLE QVariantList update(const QVariant &layout);
+  // Apply patches produced elsewhere (e.g. by the editor) to this scene
+  Q_INVOKABLE bool applyPatches(const QVariantList &patches);
+  // Current scene as a layout.json object
+  Q_INVOKABLE QVariantMap layout() const;
+  // One node (with its docked children) as layout data; empty if unknown
+  Q_INVOKABLE QVariantMap componentData(const QString &uid) const;
+  Q_INVOKABLE QString createUid(const QString &type) const;
+
+  static Component *buildTree(const QVariantMap &layout,
+                              QObject *parent = nullptr);
+  static QVariantMap toLayoutMap(const QVariant &layout);
+  static QVariantMap toLayout(const Component *root);
+
+signals:
+  void sceneChanged();
+
+private:
+  void replaceRoot(Component *root);
+
+  Component *m_root = nullptr;
+};
@@ -0,0 +1,64 @@
+#include "SensorModel.h"
+
+SensorModel::SensorModel(QObject *parent) : QAbstractListModel(parent) {}
+
+int SensorModel::rowCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant SensorModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid() || index.row() >= m_rows.size())
+    return {};
+
+  const SensorInfo &sensor = m_rows.at(index.row());
+  switch (role) {
+  case ChipRole:
+    return sensor.chip;
+  case Qt::DisplayRole:
+  case LabelRole:
+    return sensor.label;
+  case KindRole:
+    return sensor.kind == SensorInfo::Fan ? QStringLiteral("fan")
+                                          : QStringLiteral("temperature");
+  case ValueRole:
+    return sensor.value;
+  case CpuRole:
+    return sensor.cpu;
+  }
+  return {};
+}
+
+QHash<int, QByteArray> SensorModel::roleNames() const {
+  return {{ChipRole, "chip"},
+          {LabelRole, "label"},
+          {KindRole, "kind"},
+          {ValueRole, "value"},
+          {CpuRole, "cpu"}};
+}
+
+void SensorModel::setSensors(const QVector<SensorInfo> &sensors) {
+  bool sameSet = sensors.size() == m_rows.size();
+  for (int i = 0; sameSet && i < sensors.size(); ++i) {
+    sameSet = sensors[i].chip == m_rows[i].chip &&
+              sensors[i].label == m_rows[i].label &&
+              sensors[i].kind == m_rows[i].kind;
+  }
+
+  if (!sameSet) {
+    const int oldCount = m_rows.size();
+    beginResetModel();
+    m_rows = sensors;
+    endResetModel();
+    if (m_rows.size() != oldCount)
+      emit countChanged();
+    return;
+  }
+
+  for (int i = 0; i < sensors.size(); ++i) {
+    if (m_rows[i].value != sensors[i].value) {
+      m_rows[i].value = sensors[i].value;
+      const QModelIndex idx = index(i);
+      emit dataChanged(idx, idx, {ValueRole});
+    }
+  }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "HwmonSampler.h"
+#include <QAbstractListModel>
+#include <QQmlEngine>
+
+// hwmon temperatures and fans as a list model (SystemMonitor.sensors),
+// updated while SystemMonitor.Sensors is subscribed. The set of sensors only
+// changes on rediscovery, so updates are normally value changes only.
+class SensorModel : public QAbstractListModel {
+  Q_OBJECT
+  QML_ELEMENT
+  QML_UNCREATABLE("Use SystemMonitor.sensors")
+  Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+  enum Roles {
+    ChipRole = Qt::UserRole + 1,
+    LabelRole,
+    KindRole, // "temperature" or "fan"
+    ValueRole,
+    CpuRole
+  };
+
+  explicit SensorModel(QObject *parent = nullptr);
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index, int role) const override;
+  QHash<int, QByteArray> roleNames() const override;
+
+  void setSensors(const QVector<SensorInfo> &sensors);
+
+signals:
+  void countChanged();
+
+private:
+  QVector<SensorInfo> m_rows;
+};
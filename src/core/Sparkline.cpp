@@ -0,0 +1,109 @@
+#include "Sparkline.h"
+#include "MetricHistory.h"
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+
+Sparkline::Sparkline(QQuickItem *parent) : QQuickItem(parent) {
+  setFlag(ItemHasContents, true);
+}
+
+void Sparkline::setHistory(MetricHistory *history) {
+  if (m_history == history)
+    return;
+  disconnect(m_historyConnection);
+  m_history = history;
+  if (history) {
+    m_historyConnection =
+        connect(history, &MetricHistory::changed, this, &QQuickItem::update);
+  }
+  emit historyChanged();
+  update();
+}
+
+void Sparkline::setColor(const QColor &color) {
+  if (m_color == color)
+    return;
+  m_color = color;
+  m_colorDirty = true;
+  emit colorChanged();
+  update();
+}
+
+void Sparkline::setMinimum(double minimum) {
+  if (qFuzzyCompare(m_minimum, minimum))
+    return;
+  m_minimum = minimum;
+  emit rangeChanged();
+  update();
+}
+
+void Sparkline::setMaximum(double maximum) {
+  if (qFuzzyCompare(m_maximum, maximum))
+    return;
+  m_maximum = maximum;
+  emit rangeChanged();
+  update();
+}
+
+void Sparkline::setAutoScale(bool autoScale) {
+  if (m_autoScale == autoScale)
+    return;
+  m_autoScale = autoScale;
+  emit rangeChanged();
+  update();
+}
+
+void Sparkline::geometryChange(const QRectF &newGeometry,
+                               const QRectF &oldGeometry) {
+  QQuickItem::geometryChange(newGeometry, oldGeometry);
+  if (newGeometry.size() != oldGeometry.size())
+    update();
+}
+
+QSGNode *Sparkline::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *) {
+  const int count = m_history ? m_history->count() : 0;
+  if (count < 2 || width() <= 0 || height() <= 0) {
+    delete oldNode;
+    return nullptr;
+  }
+
+  auto *node = static_cast<QSGGeometryNode *>(oldNode);
+  if (!node) {
+    node = new QSGGeometryNode;
+    auto *geometry =
+        new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), count);
+    geometry->setDrawingMode(QSGGeometry::DrawLineStrip);
+    geometry->setLineWidth(1.5f);
+    node->setGeometry(geometry);
+    node->setFlag(QSGNode::OwnsGeometry);
+    node->setMaterial(new QSGFlatColorMaterial);
+    node->setFlag(QSGNode::OwnsMaterial);
+    m_colorDirty = true;
+  }
+
+  QSGGeometry *geometry = node->geometry();
+  if (geometry->vertexCount() != count)
+    geometry->allocate(count); // Only while the ring is still filling up
+
+  double low = m_minimum;
+  double high = m_autoScale ? qMax(m_history->maximum(), low + 1e-9)
+                            : m_maximum;
+  if (high <= low)
+    high = low + 1.0;
+
+  const double step = width() / (m_history->capacity() - 1);
+  const double x0 = width() - step * (count - 1);
+  QSGGeometry::Point2D *points = geometry->vertexDataAsPoint2D();
+  for (int i = 0; i < count; ++i) {
+    const double v = qBound(0.0, (m_history->at(i) - low) / (high - low), 1.0);
+    points[i].set(float(x0 + i * step), float(height() * (1.0 - v)));
+  }
+  node->markDirty(QSGNode::DirtyGeometry);
+
+  if (m_colorDirty) {
+    static_cast<QSGFlatColorMaterial *>(node->material())->setColor(m_color);
+    node->markDirty(QSGNode::DirtyMaterial);
+    m_colorDirty = false;
+  }
+  return node;
+}
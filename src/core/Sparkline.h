@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QColor>
+#include <QPointer>
+#include <QQuickItem>
+
+class MetricHistory;
+
+// Line graph of a MetricHistory, drawn as one scene graph line strip whose
+// vertices are rewritten in place from the ring on every sample. The newest
+// sample is at the right edge; the x scale is the ring's capacity.
+class Sparkline : public QQuickItem {
+  Q_OBJECT
+  QML_ELEMENT
+  Q_PROPERTY(MetricHistory *history READ history WRITE setHistory NOTIFY
+                 historyChanged)
+  Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+  Q_PROPERTY(double minimum READ minimum WRITE setMinimum NOTIFY rangeChanged)
+  Q_PROPERTY(double maximum READ maximum WRITE setMaximum NOTIFY rangeChanged)
+  // Scale to the largest sample in view instead of `maximum`
+  Q_PROPERTY(bool autoScale READ autoScale WRITE setAutoScale NOTIFY
+                 rangeChanged)
+
+public:
+  explicit Sparkline(QQuickItem *parent = nullptr);
+
+  MetricHistory *history() const { return m_history; }
+  void setHistory(MetricHistory *history);
+  QColor color() const { return m_color; }
+  void setColor(const QColor &color);
+  double minimum() const { return m_minimum; }
+  void setMinimum(double minimum);
+  double maximum() const { return m_maximum; }
+  void setMaximum(double maximum);
+  bool autoScale() const { return m_autoScale; }
+  void setAutoScale(bool autoScale);
+
+signals:
+  void historyChanged();
+  void colorChanged();
+  void rangeChanged();
+
+protected:
+  QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *) override;
+  void geometryChange(const QRectF &newGeometry,
+                      const QRectF &oldGeometry) override;
+
+private:
+  QPointer<MetricHistory> m_history;
+  QMetaObject::Connection m_historyConnection;
+  QColor m_color = Qt::white;
+  double m_minimum = 0.0;
+  double m_maximum = 1.0;
+  bool m_autoScale = false;
+  bool m_colorDirty = true;
+};
@@ -0,0 +1,237 @@
+#include "StartupTracker.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFileInfo>
+#include <QPointer>
+
+namespace {
+
+// `new: ID="foo bar" NAME=App` -> type "new", {ID: "foo bar", NAME: "App"}
+QString parseStartupMessage(const QString &message,
+                            QHash<QString, QString> *values) {
+  const qsizetype colon = message.indexOf(':');
+  if (colon < 0)
+    return {};
+
+  qsizetype i = colon + 1;
+  while (i < message.size()) {
+    while (i < message.size() && message.at(i) == ' ')
+      ++i;
+    const qsizetype eq = message.indexOf('=', i);
+    if (eq < 0)
+      break;
+    const QString key = message.mid(i, eq - i);
+
+    QString value;
+    bool quoted = false;
+    for (i = eq + 1; i < message.size(); ++i) {
+      const QChar c = message.at(i);
+      if (c == '\\' && i + 1 < message.size()) {
+        value += message.at(++i);
+      } else if (c == '"') {
+        quoted = !quoted;
+      } else if (c == ' ' && !quoted) {
+        break;
+      } else {
+        value += c;
+      }
+    }
+    values->insert(key, value);
+  }
+  return message.left(colon);
+}
+
+} // namespace
+
+StartupTracker *StartupTracker::instance() {
+  static QPointer<StartupTracker> s_instance;
+  if (!s_instance) {
+    s_instance = new StartupTracker(QCoreApplication::instance());
+  }
+  return s_instance;
+}
+
+StartupTracker::StartupTracker(QObject *parent) : QObject(parent) {
+  m_timeoutTimer.setInterval(1000);
+  connect(&m_timeoutTimer, &QTimer::timeout, this,
+          &StartupTracker::checkTimeouts);
+}
+
+bool StartupTracker::busy() const {
+  for (const Launch &launch : m_pending) {
+    if (launch.feedback)
+      return true;
+  }
+  return false;
+}
+
+QVariantList StartupTracker::pending() const {
+  QVariantList list;
+  for (const Launch &launch : m_pending) {
+    if (!launch.feedback)
+      continue;
+    list.append(QVariantMap{{"startupId", launch.startupId},
+                            {"appId", launch.appId},
+                            {"name", launch.name},
+                            {"icon", launch.icon},
+                            {"elapsed", double(launch.timer.elapsed())}});
+  }
+  return list;
+}
+
+QVariantMap StartupTracker::latencies() const {
+  QVariantMap map;
+  for (auto it = m_stats.cbegin(); it != m_stats.cend(); ++it) {
+    const Stats &stats = it.value();
+    map.insert(it.key(),
+               QVariantMap{{"count", stats.count},
+                           {"lastMs", stats.lastMs},
+                           {"averageMs",
+                            stats.count ? stats.totalMs / stats.count : 0.0},
+                           {"maxMs", stats.maxMs},
+                           {"timeouts", stats.timeouts}});
+  }
+  return map;
+}
+
+void StartupTracker::launchStarted(const QString &startupId,
+                                   const QString &appId, const QString &name,
+                                   const QString &icon, const QString &wmClass,
+                                   qint64 pid, bool feedback) {
+  Launch launch;
+  launch.startupId = startupId;
+  launch.appId = appId;
+  launch.name = name;
+  launch.icon = icon;
+  // Without StartupWMClass, WM_CLASS usually matches the desktop file name
+  launch.wmClass = (wmClass.isEmpty() ? QFileInfo(appId).completeBaseName()
+                                      : wmClass)
+                       .toLower();
+  launch.pid = pid;
+  launch.feedback = feedback;
+  launch.timer.start();
+  m_pending.append(launch);
+
+  if (!m_timeoutTimer.isActive())
+    m_timeoutTimer.start();
+  if (feedback)
+    emit pendingChanged();
+}
+
+void StartupTracker::processExited(qint64 pid, int status) {
+  // A clean exit may just be a launcher script or a hand-off to a running
+  // instance; keep waiting for a window. Failures end the launch.
+  if (status == 0)
+    return;
+  for (int i = 0; i < m_pending.size(); ++i) {
+    if (m_pending.at(i).pid == pid) {
+      qDebug() << "[StartupTracker]" << m_pending.at(i).appId
+               << "exited before mapping a window";
+      const bool feedback = m_pending.at(i).feedback;
+      m_pending.removeAt(i);
+      if (feedback)
+        emit pendingChanged();
+      return;
+    }
+  }
+}
+
+void StartupTracker::windowMapped(const QString &startupId, qint64 pid,
+                                  const QString &wmClass) {
+  if (m_pending.isEmpty())
+    return;
+
+  // Best evidence first: startup id, then pid, then WM_CLASS
+  int match = -1;
+  if (!startupId.isEmpty()) {
+    for (int i = 0; i < m_pending.size() && match < 0; ++i) {
+      if (m_pending.at(i).startupId == startupId)
+        match = i;
+    }
+  }
+  if (match < 0 && pid > 0) {
+    for (int i = 0; i < m_pending.size() && match < 0; ++i) {
+      if (m_pending.at(i).pid == pid)
+        match = i;
+    }
+  }
+  if (match < 0 && !wmClass.isEmpty()) {
+    const QString lower = wmClass.toLower();
+    for (int i = 0; i < m_pending.size() && match < 0; ++i) {
+      if (m_pending.at(i).wmClass == lower)
+        match = i;
+    }
+  }
+
+  if (match >= 0)
+    finish(match, false);
+}
+
+void StartupTracker::handleStartupMessage(const QString &message) {
+  QHash<QString, QString> values;
+  const QString type = parseStartupMessage(message, &values);
+  const QString id = values.value("ID");
+  if (id.isEmpty())
+    return;
+
+  if (type == "remove") {
+    for (int i = 0; i < m_pending.size(); ++i) {
+      if (m_pending.at(i).startupId == id) {
+        finish(i, false);
+        return;
+      }
+    }
+  } else if (type == "new") {
+    // Launched by someone else (e.g. a terminal running gtk-launch)
+    for (const Launch &launch : m_pending) {
+      if (launch.startupId == id)
+        return;
+    }
+    launchStarted(id, values.value("APPLICATION_ID", values.value("BIN")),
+                  values.value("NAME"), values.value("ICON"),
+                  values.value("WMCLASS"), values.value("PID").toLongLong(),
+                  true);
+  }
+}
+
+void StartupTracker::finish(int index, bool timedOut) {
+  const Launch launch = m_pending.takeAt(index);
+  const double latencyMs = launch.timer.nsecsElapsed() / 1e6;
+
+  Stats &stats = m_stats[launch.appId];
+  if (timedOut) {
+    stats.timeouts++;
+    qDebug() << "[StartupTracker]" << launch.appId << "timed out after"
+             << latencyMs << "ms";
+  } else {
+    stats.count++;
+    stats.lastMs = latencyMs;
+    stats.totalMs += latencyMs;
+    stats.maxMs = qMax(stats.maxMs, latencyMs);
+    qDebug() << "[StartupTracker]" << launch.appId << "mapped after"
+             << latencyMs << "ms";
+  }
+
+  if (m_pending.isEmpty())
+    m_timeoutTimer.stop();
+
+  emit launchFinished(launch.appId, latencyMs, timedOut);
+  emit latenciesChanged();
+  if (launch.feedback)
+    emit pendingChanged();
+}
+
+void StartupTracker::checkTimeouts() {
+  for (int i = m_pending.size() - 1; i >= 0; --i) {
+    if (m_pending.at(i).timer.hasExpired(TimeoutMs)) {
+      if (m_pending.at(i).feedback) {
+        finish(i, true);
+      } else {
+        // Nothing was promised; don't count it against the app
+        m_pending.removeAt(i);
+      }
+    }
+  }
+  if (m_pending.isEmpty())
+    m_timeoutTimer.stop();
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QQmlEngine>
+#include <QString>
+#include <QTimer>
+#include <QVariantList>
+#include <QVariantMap>
+
+// Startup notification (freedesktop startup-notification spec) for apps we
+// launch: each launch gets a DESKTOP_STARTUP_ID and stays pending until a
+// window carrying that id (_NET_STARTUP_ID), or failing that the same pid or
+// WM_CLASS, is mapped, the app sends "remove:", or it times out.
+//
+// Launch-to-first-map latency is recorded per app.
+class StartupTracker : public QObject {
+  Q_OBJECT
+  QML_ELEMENT
+  QML_UNCREATABLE("Use AppManager.startup")
+  // Launches that asked for feedback (StartupNotify / StartupWMClass)
+  Q_PROPERTY(bool busy READ busy NOTIFY pendingChanged)
+  Q_PROPERTY(QVariantList pending READ pending NOTIFY pendingChanged)
+  // appId -> { count, lastMs, averageMs, maxMs, timeouts }
+  Q_PROPERTY(QVariantMap latencies READ latencies NOTIFY latenciesChanged)
+
+public:
+  static constexpr int TimeoutMs = 15000;
+
+  static StartupTracker *instance();
+
+  bool busy() const;
+  QVariantList pending() const;
+  QVariantMap latencies() const;
+
+  void launchStarted(const QString &startupId, const QString &appId,
+                     const QString &name, const QString &icon,
+                     const QString &wmClass, qint64 pid, bool feedback);
+  void processExited(qint64 pid, int status);
+
+  // Called by the window manager for every new top-level window
+  void windowMapped(const QString &startupId, qint64 pid,
+                    const QString &wmClass);
+  // Startup info messages on the root window ("new:", "remove:", ...)
+  void handleStartupMessage(const QString &message);
+
+signals:
+  void pendingChanged();
+  void latenciesChanged();
+  void launchFinished(const QString &appId, double latencyMs, bool timedOut);
+
+private:
+  explicit StartupTracker(QObject *parent = nullptr);
+
+  struct Launch {
+    QString startupId;
+    QString appId;
+    QString name;
+    QString icon;
+    QString wmClass; // Lower-case WM_CLASS to match, if known
+    qint64 pid = -1;
+    bool feedback = false;
+    QElapsedTimer timer;
+  };
+
+  struct Stats {
+    int count = 0;
+    int timeouts = 0;
+    double lastMs = 0;
+    double totalMs = 0;
+    double maxMs = 0;
+  };
+
+  void finish(int index, bool timedOut);
+  void checkTimeouts();
+
+  QList<Launch> m_pending;
+  QHash<QString, Stats> m_stats;
+  QTimer m_timeoutTimer;
+};
@@ -1,102 +1,620 @@
 #include "SystemMonitor.h"
+#include "IdleMonitor.h"
+#include <QCoreApplication>
+#include <QDateTime>
 #include <QDebug>
-#include <QFile>
-#include <QRegularExpression>
-#include <QTextStream>
-#include <sys/statvfs.h>
+#include <QDir>
+#include <QPointer>
+#include <QStandardPaths>
+#include <cmath>
+#include <cstring>
 
-SystemMonitor::SystemMonitor(QObject *parent) : QObject(parent) {
+namespace {
+
+// Metrics due within this window of each other are read in one wakeup
+const int CoalesceMs = 50;
+// After CPU sampling (re)starts, the first delta needs a second read
+const int FirstCpuDelayMs = 250;
+
+const int CpuIndex = 0;       // Bit index of SystemMonitor::Cpu
+const int DiskIndex = 2;      // Bit index of SystemMonitor::Disk
+const int ProcessesIndex = 3; // Bit index of SystemMonitor::Processes
+const int NetworkIndex = 4;   // Bit index of SystemMonitor::Network
+const int PressureIndex = 5;  // Bit index of SystemMonitor::Pressure
+const int SensorsIndex = 6;   // Bit index of SystemMonitor::Sensors
+const int BatteryIndex = 7;   // Bit index of SystemMonitor::Battery
+
+int metricBit(int index) { return 1 << index; }
+
+// File names under <data>/canvasdesk/metrics, by SystemMonitor::ArchivedMetric
+const char *const ArchiveNames[] = {"cpu", "memory", "disk", "networkRx",
+                                    "networkTx"};
+
+} // namespace
+
+SystemMonitorWorker::SystemMonitorWorker(QObject *parent)
+    : QObject(parent), m_intervals(MetricCount, 0), m_due(MetricCount, -1),
+      m_sampler(ProcFile::procRoot(), ProcFile::sysRoot()),
+      m_hwmon(ProcFile::sysRoot()), m_processes(ProcFile::procRoot()) {
   m_timer = new QTimer(this);
-  connect(m_timer, &QTimer::timeout, this, &SystemMonitor::updateStats);
-  m_timer->start(1000); // Update every second
+  m_timer->setSingleShot(true);
+  m_timer->setTimerType(Qt::CoarseTimer);
+  connect(m_timer, &QTimer::timeout, this, [this]() {
+    const qint64 now = m_clock.elapsed();
+    int due = 0;
+    for (int i = 0; i < MetricCount; ++i) {
+      if (m_due[i] >= 0 && m_due[i] <= now + CoalesceMs) {
+        due |= metricBit(i);
+        m_due[i] = now + m_intervals[i];
+      }
+    }
+    if (due)
+      sample(due);
+    schedule();
+  });
+  m_clock.start();
 
-  // Initial update
-  updateStats();
+  // A mount change or a pressure stall is worth a sample right away
+  m_disks = new DiskSampler(ProcFile::procRoot(), this);
+  connect(m_disks, &DiskSampler::mountsChanged, this,
+          [this]() { sampleSoon(DiskIndex); });
+  m_pressure = new PressureSampler(ProcFile::procRoot(), this);
+  connect(m_pressure, &PressureSampler::stalled, this,
+          [this]() { sampleSoon(PressureIndex); });
+  m_power = new PowerSupplySampler(ProcFile::sysRoot(), this);
+  connect(m_power, &PowerSupplySampler::changed, this,
+          [this]() { sampleSoon(BatteryIndex); });
 }
 
-SystemMonitor::~SystemMonitor() {}
+void SystemMonitorWorker::setIntervals(const QVector<int> &intervals) {
+  const qint64 now = m_clock.elapsed();
+  for (int i = 0; i < MetricCount; ++i) {
+    const int interval = intervals.value(i);
+    if (interval <= 0) {
+      m_due[i] = -1;
+    } else if (m_intervals[i] <= 0) {
+      // Newly subscribed: read right away. Counters from before a pause
+      // would average over the whole pause, so CPU starts a new baseline.
+      m_due[i] = now;
+      if (i == CpuIndex) {
+        m_prevCpu = CpuTimes();
+        m_prevCores.clear();
+      } else if (i == ProcessesIndex) {
+        m_processes.resetBaseline();
+      } else if (i == NetworkIndex) {
+        m_sinceNetwork.invalidate();
+      } else if (i == SensorsIndex) {
+        m_hwmon.rediscover(); // Pick up hot-plugged sensors
+      }
+    } else {
+      m_due[i] = qMin(m_due[i], now + interval);
+    }
+    m_intervals[i] = qMax(0, interval);
+  }
+  m_disks->setActive(m_intervals[DiskIndex] > 0);
+  m_pressure->setActive(m_intervals[PressureIndex] > 0);
+  m_power->setActive(m_intervals[BatteryIndex] > 0);
+  schedule();
+}
 
-void SystemMonitor::updateStats() {
-  readCpuUsage();
-  readMemoryUsage();
-  readDiskUsage();
-  emit statsChanged();
+void SystemMonitorWorker::sampleNow(int metrics) { sample(metrics); }
+
+void SystemMonitorWorker::setProcessQuery(const QVector<int> &limits) {
+  m_processLimits = limits;
+  if (m_intervals[ProcessesIndex] <= 0 || !m_processes.hasBaseline())
+    return;
+
+  // Re-rank the last scan; rescanning now would measure a tiny window
+  SystemSample sample;
+  sample.metrics = SystemMonitor::Processes;
+  rankProcesses(sample);
+  emit sampled(sample);
+}
+
+bool SystemMonitorWorker::pressureAvailable() const {
+  return m_pressure->isAvailable();
+}
+
+void SystemMonitorWorker::sampleSoon(int index) {
+  if (m_intervals[index] > 0) {
+    m_due[index] = m_clock.elapsed();
+    schedule();
+  }
 }
 
-void SystemMonitor::readCpuUsage() {
-  QFile file("/proc/stat");
-  if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+void SystemMonitorWorker::schedule() {
+  qint64 next = -1;
+  for (qint64 due : std::as_const(m_due)) {
+    if (due >= 0 && (next < 0 || due < next))
+      next = due;
+  }
+
+  if (next < 0) {
+    m_timer->stop(); // Nothing subscribed: no wakeups at all
     return;
+  }
+  m_timer->start(int(qMax<qint64>(0, next - m_clock.elapsed())));
+}
 
-  QTextStream in(&file);
-  QString line = in.readLine();
-  if (line.startsWith("cpu ")) {
-    QStringList parts =
-        line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-    if (parts.size() >= 5) {
-      unsigned long long user = parts[1].toULongLong();
-      unsigned long long nice = parts[2].toULongLong();
-      unsigned long long system = parts[3].toULongLong();
-      unsigned long long idle = parts[4].toULongLong();
-
-      unsigned long long total = user + nice + system + idle;
-
-      if (m_prevTotal > 0) {
-        unsigned long long totalDelta = total - m_prevTotal;
-        unsigned long long idleDelta = idle - m_prevIdle;
-
-        if (totalDelta > 0) {
-          m_cpuUsage = (double)(totalDelta - idleDelta) / totalDelta;
+void SystemMonitorWorker::sample(int metrics) {
+  QElapsedTimer timer;
+  timer.start();
+
+  SystemSample sample;
+  if (metrics & SystemMonitor::Cpu) {
+    if (readCpu(sample)) {
+      sample.metrics |= SystemMonitor::Cpu;
+    } else if (m_intervals[CpuIndex] > 0) {
+      // Baseline only; come back soon for the first real value
+      m_due[CpuIndex] =
+          m_clock.elapsed() + qMin(m_intervals[CpuIndex], FirstCpuDelayMs);
+    }
+  }
+  if (metrics & SystemMonitor::Memory) {
+    MemoryInfo info;
+    if (m_sampler.readMemory(&info)) {
+      sample.memory = info.usage();
+      sample.metrics |= SystemMonitor::Memory;
+    }
+  }
+  if (metrics & SystemMonitor::Disk) {
+    if (readDisk(sample)) {
+      sample.metrics |= SystemMonitor::Disk;
+    } else if (m_intervals[DiskIndex] > 0) {
+      // Rate baseline only, or statvfs still running
+      m_due[DiskIndex] =
+          m_clock.elapsed() + qMin(m_intervals[DiskIndex], FirstCpuDelayMs);
+    }
+  }
+  if (metrics & SystemMonitor::Network) {
+    if (readNetwork(sample)) {
+      sample.metrics |= SystemMonitor::Network;
+    } else if (m_intervals[NetworkIndex] > 0) {
+      m_due[NetworkIndex] = m_clock.elapsed() +
+                            qMin(m_intervals[NetworkIndex], FirstCpuDelayMs);
+    }
+  }
+  if ((metrics & SystemMonitor::Pressure) && m_pressure->read(sample.pressure))
+    sample.metrics |= SystemMonitor::Pressure;
+  if ((metrics & SystemMonitor::Sensors) &&
+      m_hwmon.read(&sample.sensors, &sample.cpuTemperature,
+                   &sample.cpuFrequency, &sample.cpuMaxFrequency))
+    sample.metrics |= SystemMonitor::Sensors;
+  if ((metrics & SystemMonitor::Battery) && m_power->read(&sample.battery))
+    sample.metrics |= SystemMonitor::Battery;
+  if (metrics & SystemMonitor::Processes) {
+    if (readProcesses(sample)) {
+      sample.metrics |= SystemMonitor::Processes;
+    } else if (m_intervals[ProcessesIndex] > 0) {
+      m_due[ProcessesIndex] = m_clock.elapsed() +
+                              qMin(m_intervals[ProcessesIndex], FirstCpuDelayMs);
+    }
+  }
+
+  sample.sampleNs = timer.nsecsElapsed();
+  if (sample.metrics)
+    emit sampled(sample);
+}
+
+bool SystemMonitorWorker::readCpu(SystemSample &sample) {
+  CpuTimes now;
+  if (!m_sampler.readCpu(&now, &m_cores))
+    return false;
+
+  const bool haveDelta = m_prevCpu.total() > 0;
+  // iowait counts as idle; irq, softirq and steal as busy
+  sample.cpu = CpuTimes::usage(m_prevCpu, now);
+  m_prevCpu = now;
+
+  const int cores = m_cores.size();
+  if (m_prevCores.size() != cores)
+    m_prevCores.resize(cores);
+  sample.cores.resize(cores);
+  for (int i = 0; i < cores; ++i) {
+    sample.cores[i] = CpuTimes::usage(m_prevCores[i], m_cores[i]);
+    m_prevCores[i] = m_cores[i];
+  }
+  return haveDelta;
+}
+
+bool SystemMonitorWorker::readDisk(SystemSample &sample) {
+  const bool complete = m_disks->sample(&sample.disks);
+  for (const DiskInfo &disk : std::as_const(sample.disks)) {
+    if (disk.mountPoint == QLatin1String("/")) {
+      sample.disk = disk.usage();
+      break;
+    }
+  }
+  return complete;
+}
+
+bool SystemMonitorWorker::readNetwork(SystemSample &sample) {
+  if (!m_sampler.readNetwork(&m_network))
+    return false;
+
+  const bool haveDelta = m_sinceNetwork.isValid();
+  const double elapsedSec =
+      haveDelta ? m_sinceNetwork.nsecsElapsed() / 1e9 : 0.0;
+  m_sinceNetwork.start();
+
+  const int count = m_network.size();
+  if (m_networkRates.size() != count)
+    m_networkRates.resize(count);
+  for (int i = 0; i < count; ++i) {
+    const NetworkCounters &now = m_network[i];
+    NetworkInfo &rates = m_networkRates[i];
+    if (rates.name != QLatin1String(now.name))
+      rates.name = QString::fromLatin1(now.name);
+
+    // Same slot as last time unless interfaces came or went
+    const NetworkCounters *prev = nullptr;
+    if (i < m_prevNetwork.size() &&
+        std::strcmp(m_prevNetwork[i].name, now.name) == 0) {
+      prev = &m_prevNetwork[i];
+    } else {
+      for (const NetworkCounters &candidate : std::as_const(m_prevNetwork)) {
+        if (std::strcmp(candidate.name, now.name) == 0) {
+          prev = &candidate;
+          break;
         }
       }
+    }
 
-      m_prevTotal = total;
-      m_prevIdle = idle;
+    auto rate = [elapsedSec](quint64 current, quint64 previous) {
+      return current >= previous ? (current - previous) / elapsedSec : 0.0;
+    };
+    if (prev && elapsedSec > 0.0) {
+      rates.rxBytesPerSec = rate(now.rxBytes, prev->rxBytes);
+      rates.txBytesPerSec = rate(now.txBytes, prev->txBytes);
+      rates.rxPacketsPerSec = rate(now.rxPackets, prev->rxPackets);
+      rates.txPacketsPerSec = rate(now.txPackets, prev->txPackets);
+    } else {
+      rates.rxBytesPerSec = rates.txBytesPerSec = 0.0;
+      rates.rxPacketsPerSec = rates.txPacketsPerSec = 0.0;
     }
   }
+
+  // Copy in place; plain assignment would share and detach every sample
+  if (m_prevNetwork.size() != count)
+    m_prevNetwork.resize(count);
+  std::copy(m_network.cbegin(), m_network.cend(), m_prevNetwork.begin());
+
+  sample.networks = m_networkRates;
+  return haveDelta;
+}
+
+bool SystemMonitorWorker::readProcesses(SystemSample &sample) {
+  // Without a previous scan every CPU share would read 0
+  const bool haveDelta = m_processes.hasBaseline();
+  m_processes.scan();
+  rankProcesses(sample);
+  return haveDelta;
+}
+
+void SystemMonitorWorker::rankProcesses(SystemSample &sample) const {
+  for (int key = 0; key < ProcessScanner::SortKeyCount; ++key) {
+    if (m_processLimits.value(key) > 0)
+      sample.processes[key] =
+          m_processes.top(ProcessScanner::SortKey(key), m_processLimits[key]);
+  }
+  sample.processCount = m_processes.processCount();
 }
 
-void SystemMonitor::readMemoryUsage() {
-  QFile file("/proc/meminfo");
-  if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+SystemMonitor *SystemMonitor::instance() {
+  static QPointer<SystemMonitor> s_instance;
+  if (!s_instance) {
+    s_instance = new SystemMonitor(QCoreApplication::instance());
+  }
+  return s_instance;
+}
+
+SystemMonitor::SystemMonitor(QObject *parent)
+    : QObject(parent),
+      m_cpuHistory(new MetricHistory(MetricHistory::DefaultCapacity, this)),
+      m_memoryHistory(new MetricHistory(MetricHistory::DefaultCapacity, this)),
+      m_diskHistory(new MetricHistory(MetricHistory::DefaultCapacity, this)),
+      m_networkRxHistory(
+          new MetricHistory(MetricHistory::DefaultCapacity, this)),
+      m_networkTxHistory(
+          new MetricHistory(MetricHistory::DefaultCapacity, this)),
+      m_disks(new DiskModel(this)), m_networks(new NetworkModel(this)),
+      m_sensors(new SensorModel(this)), m_processes(new ProcessModel(this)) {
+  qRegisterMetaType<SystemSample>();
+
+  m_worker = new SystemMonitorWorker();
+  m_pressureAvailable = m_worker->pressureAvailable(); // Fixed at startup
+  m_worker->moveToThread(&m_thread);
+  connect(m_worker, &SystemMonitorWorker::sampled, this,
+          &SystemMonitor::applySample);
+  addProcessModel(m_processes);
+  m_thread.setObjectName("CanvasDeskMonitor");
+  m_thread.start(QThread::LowPriority);
+
+  m_lockPollTimer.setInterval(LockPollMs);
+  connect(&m_lockPollTimer, &QTimer::timeout, this,
+          &SystemMonitor::pollScreenLock);
+}
+
+SystemMonitor::~SystemMonitor() {
+  // The worker's timers and socket notifiers belong to m_thread: delete it
+  // there, after its event loop has stopped
+  connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+  m_thread.quit();
+  m_thread.wait();
+}
+
+int SystemMonitor::subscribe(int metrics, int intervalMs) {
+  const int token = m_nextToken++;
+  m_subscriptions.insert(
+      token, {metrics & AllMetrics, qMax(MinIntervalMs, intervalMs)});
+  updateIntervals();
+  return token;
+}
+
+void SystemMonitor::unsubscribe(int token) {
+  if (m_subscriptions.remove(token))
+    updateIntervals();
+}
+
+int SystemMonitor::activeMetrics() const {
+  int metrics = 0;
+  for (const Subscription &sub : m_subscriptions)
+    metrics |= sub.metrics;
+  return metrics;
+}
+
+void SystemMonitor::setRecordHistory(bool record) {
+  if (record == m_recordHistory)
     return;
+  m_recordHistory = record;
+  if (record) {
+    m_recordToken = subscribe(Cpu | Memory | Disk | Network, RecordIntervalMs);
+  } else {
+    unsubscribe(m_recordToken);
+    m_recordToken = 0;
+  }
+  emit recordHistoryChanged();
+}
 
-  QTextStream in(&file);
-  unsigned long totalMem = 0;
-  unsigned long availableMem = 0;
-
-  while (!in.atEnd()) {
-    QString line = in.readLine();
-    if (line.startsWith("MemTotal:")) {
-      QStringList parts =
-          line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-      if (parts.size() >= 2)
-        totalMem = parts[1].toULong();
-    } else if (line.startsWith("MemAvailable:")) {
-      QStringList parts =
-          line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-      if (parts.size() >= 2)
-        availableMem = parts[1].toULong();
-    }
-
-    if (totalMem > 0 && availableMem > 0)
-      break;
+MetricArchive *SystemMonitor::openArchive(int metric) {
+  Archived &archived = m_archived[metric];
+  if (!archived.file) {
+    const QString dir =
+        QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) +
+        "/canvasdesk/metrics";
+    QDir().mkpath(dir);
+    archived.file = std::make_unique<MetricArchive>(
+        dir + "/" + ArchiveNames[metric] + ".ring");
+    if (m_recordHistory && !archived.file->isWritable())
+      qInfo() << "[SystemMonitor] Another instance records"
+              << ArchiveNames[metric];
+  }
+  return archived.file.get();
+}
+
+MetricHistory *SystemMonitor::longHistory(const QString &metric, int span) {
+  int index = 0;
+  while (index < ArchiveCount && metric != QLatin1String(ArchiveNames[index]))
+    ++index;
+  if (index == ArchiveCount || span < Live || span > Month) {
+    qWarning() << "[SystemMonitor] No history for" << metric << span;
+    return nullptr;
+  }
+
+  if (span == Live) {
+    MetricHistory *const live[] = {m_cpuHistory, m_memoryHistory,
+                                   m_diskHistory, m_networkRxHistory,
+                                   m_networkTxHistory};
+    return live[index];
   }
 
-  if (totalMem > 0) {
-    m_memoryUsage = (double)(totalMem - availableMem) / totalMem;
+  const int tier = span - Hour;
+  Archived &archived = m_archived[index];
+  if (!archived.histories[tier]) {
+    MetricArchive *file = openArchive(index);
+    auto *history = new MetricHistory(
+        MetricArchive::capacity(MetricArchive::Tier(tier)), this);
+    history->assign(file->values(MetricArchive::Tier(tier)));
+    archived.histories[tier] = history;
+    archived.shownBuckets[tier] =
+        file->latestBucket(MetricArchive::Tier(tier));
   }
+  return archived.histories[tier];
 }
 
-void SystemMonitor::readDiskUsage() {
-  struct statvfs buffer;
-  if (statvfs("/", &buffer) == 0) {
-    unsigned long long total = buffer.f_blocks * buffer.f_frsize;
-    unsigned long long available = buffer.f_bavail * buffer.f_frsize;
-    unsigned long long used = total - available;
+void SystemMonitor::record(int metric, double value, qint64 time) {
+  Archived &archived = m_archived[metric];
+  if (m_recordHistory)
+    openArchive(metric)->append(value, time);
+  if (!archived.file)
+    return; // Nothing recorded or shown yet
 
-    if (total > 0) {
-      m_diskUsage = (double)used / total;
+  // Follow the archive: the newest point keeps changing until its bucket is
+  // complete. Anything else (gaps, another process recording) reloads.
+  for (int i = 0; i < MetricArchive::TierCount; ++i) {
+    MetricHistory *history = archived.histories[i];
+    if (!history)
+      continue;
+    const auto tier = MetricArchive::Tier(i);
+    const qint64 bucket = archived.file->latestBucket(tier);
+    const float latest = archived.file->latest(tier);
+    qint64 &shown = archived.shownBuckets[i];
+    if (bucket >= 0 && bucket == shown && !std::isnan(latest))
+      history->replaceLatest(latest);
+    else if (shown >= 0 && bucket == shown + 1 && !std::isnan(latest))
+      history->append(latest);
+    else
+      history->assign(archived.file->values(tier));
+    shown = bucket;
+  }
+}
+
+void SystemMonitor::updateStats() {
+  const int metrics = activeMetrics() ? activeMetrics() : int(AllMetrics);
+  QMetaObject::invokeMethod(
+      m_worker, [worker = m_worker, metrics]() { worker->sampleNow(metrics); },
+      Qt::QueuedConnection);
+}
+
+void SystemMonitor::updateIntervals() {
+  // Watch for the screen locking only while something samples
+  if (!m_subscriptions.isEmpty() && !m_lockPollTimer.isActive()) {
+    if (!m_idleMonitor)
+      m_idleMonitor = std::make_unique<IdleMonitor>();
+    if (m_idleMonitor->isAvailable())
+      m_lockPollTimer.start();
+  } else if (m_subscriptions.isEmpty()) {
+    m_lockPollTimer.stop();
+    if (m_screenLocked) {
+      m_screenLocked = false;
+      emit screenLockedChanged();
     }
   }
+
+  // Fastest requested interval per metric; while locked nothing on screen
+  // needs data, only the history recorder keeps going
+  QVector<int> intervals(SystemMonitorWorker::MetricCount, 0);
+  for (auto it = m_subscriptions.cbegin(); it != m_subscriptions.cend(); ++it) {
+    if (m_screenLocked && it.key() != m_recordToken)
+      continue;
+    const Subscription &sub = it.value();
+    for (int i = 0; i < intervals.size(); ++i) {
+      if (sub.metrics & metricBit(i) &&
+          (intervals[i] == 0 || sub.intervalMs < intervals[i]))
+        intervals[i] = sub.intervalMs;
+    }
+  }
+
+  QMetaObject::invokeMethod(
+      m_worker,
+      [worker = m_worker, intervals]() { worker->setIntervals(intervals); },
+      Qt::QueuedConnection);
+  emit subscriptionsChanged();
+}
+
+void SystemMonitor::pollScreenLock() {
+  // Threshold 0: only the screen saver state, never plain inactivity
+  const bool locked = m_idleMonitor && m_idleMonitor->isIdle(0);
+  if (locked == m_screenLocked)
+    return;
+  m_screenLocked = locked;
+  qInfo() << "[SystemMonitor] Screen" << (locked ? "locked" : "unlocked")
+          << "- sampling" << (locked ? "paused" : "resumed");
+  updateIntervals();
+  emit screenLockedChanged();
+}
+
+ProcessModel *SystemMonitor::createProcessModel(QObject *owner) {
+  auto *model = new ProcessModel(owner ? owner : this);
+  QJSEngine::setObjectOwnership(model, QJSEngine::CppOwnership);
+  addProcessModel(model);
+  return model;
+}
+
+void SystemMonitor::addProcessModel(ProcessModel *model) {
+  m_processModels.append(model);
+  connect(model, &ProcessModel::queryChanged, this,
+          &SystemMonitor::updateProcessQuery);
+  connect(model, &QObject::destroyed, this, [this]() {
+    m_processModels.removeAll(nullptr);
+    updateProcessQuery();
+  });
+  updateProcessQuery();
+}
+
+void SystemMonitor::updateProcessQuery() {
+  // One ranking per sort key in use, deep enough for every table
+  QVector<int> limits(ProcessScanner::SortKeyCount, 0);
+  for (const QPointer<ProcessModel> &model : std::as_const(m_processModels)) {
+    if (model)
+      limits[model->sortBy()] = qMax(limits[model->sortBy()], model->limit());
+  }
+  QMetaObject::invokeMethod(
+      m_worker,
+      [worker = m_worker, limits]() { worker->setProcessQuery(limits); },
+      Qt::QueuedConnection);
+}
+
+void SystemMonitor::applySample(const SystemSample &sample) {
+  m_lastSampleNs = sample.sampleNs;
+  const qint64 now = QDateTime::currentSecsSinceEpoch();
+
+  if (sample.metrics & Cpu) {
+    m_cpuUsage = sample.cpu;
+    m_cpuHistory->append(m_cpuUsage);
+    record(ArchiveCpu, m_cpuUsage, now);
+
+    const int cores = sample.cores.size();
+    if (cores != m_coreUsages.size()) {
+      m_coreUsages.resize(cores);
+      while (m_coreHistories.size() < cores)
+        m_coreHistories.append(
+            new MetricHistory(MetricHistory::DefaultCapacity, this));
+      while (m_coreHistories.size() > cores)
+        delete m_coreHistories.takeLast();
+      emit coreCountChanged();
+    }
+    for (int i = 0; i < cores; ++i) {
+      m_coreUsages[i] = sample.cores[i];
+      m_coreHistories[i]->append(sample.cores[i]);
+    }
+  }
+  if (sample.metrics & Memory) {
+    m_memoryUsage = sample.memory;
+    m_memoryHistory->append(m_memoryUsage);
+    record(ArchiveMemory, m_memoryUsage, now);
+  }
+  if (sample.metrics & Disk) {
+    m_diskUsage = sample.disk;
+    m_diskHistory->append(m_diskUsage);
+    record(ArchiveDisk, m_diskUsage, now);
+    m_disks->setDisks(sample.disks);
+  }
+  if (sample.metrics & Network) {
+    m_networkRxRate = 0.0;
+    m_networkTxRate = 0.0;
+    for (const NetworkInfo &info : sample.networks) {
+      m_networkRxRate += info.rxBytesPerSec;
+      m_networkTxRate += info.txBytesPerSec;
+    }
+    m_networkRxHistory->append(m_networkRxRate);
+    m_networkTxHistory->append(m_networkTxRate);
+    record(ArchiveNetworkRx, m_networkRxRate, now);
+    record(ArchiveNetworkTx, m_networkTxRate, now);
+    m_networks->setInterfaces(sample.networks);
+  }
+  if (sample.metrics & Pressure) {
+    // PressureSampler's resource order; SystemMonitor's Cpu/Memory differ
+    m_cpuPressure = sample.pressure[PressureSampler::Cpu];
+    m_memoryPressure = sample.pressure[PressureSampler::Memory];
+    m_ioPressure = sample.pressure[PressureSampler::Io];
+    const bool stalled = m_cpuPressure.stalled || m_memoryPressure.stalled ||
+                         m_ioPressure.stalled;
+    emit pressureChanged();
+    if (stalled)
+      emit pressureStalled();
+  }
+  if (sample.metrics & Sensors) {
+    m_cpuTemperature = sample.cpuTemperature;
+    m_cpuFrequency = sample.cpuFrequency;
+    m_cpuMaxFrequency = sample.cpuMaxFrequency;
+    m_sensors->setSensors(sample.sensors);
+  }
+  if ((sample.metrics & Battery) && sample.battery != m_battery) {
+    m_battery = sample.battery;
+    emit batteryChanged();
+  }
+  if (sample.metrics & Processes) {
+    for (const QPointer<ProcessModel> &model : std::as_const(m_processModels)) {
+      if (!model)
+        continue;
+      const QVector<ProcessInfo> &ranked = sample.processes[model->sortBy()];
+      // A sort key asked for since this was ranked comes with the next one
+      if (ranked.isEmpty() && model->limit() > 0)
+        continue;
+      model->setProcesses(ranked.mid(0, model->limit()), sample.processCount);
+    }
+  }
+
+  emit statsChanged();
 }
@@ -1,40 +1,353 @@
 #pragma once
 
+#include "DiskModel.h"
+#include "DiskSampler.h"
+#include "HwmonSampler.h"
+#include "MetricArchive.h"
+#include "MetricHistory.h"
+#include "NetworkModel.h"
+#include "PowerSupplySampler.h"
+#include "PressureSampler.h"
+#include "ProcSampler.h"
+#include "ProcessModel.h"
+#include "ProcessScanner.h"
+#include "SensorModel.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
 #include <QObject>
+#include <QPointer>
+#include <QQmlEngine>
+#include <QThread>
 #include <QTimer>
 #include <QVector>
+#include <memory>
 
+class IdleMonitor;
+
+// One round of readings from the sampling thread. Only the metrics in
+// `metrics` were read this time; the other fields are unset.
+struct SystemSample {
+  int metrics = 0;
+  double cpu = 0.0;
+  QVector<double> cores;
+  double memory = 0.0;
+  double disk = 0.0;              // Root filesystem
+  QVector<DiskInfo> disks;        // All real mounts
+  QVector<NetworkInfo> networks;  // Physical interfaces
+  PressureValues pressure[PressureSampler::ResourceCount];
+  QVector<SensorInfo> sensors;
+  double cpuTemperature = 0.0; // °C
+  double cpuFrequency = 0.0;   // MHz, average over CPUs
+  double cpuMaxFrequency = 0.0;
+  BatteryState battery;
+  // Top N per ProcessScanner::SortKey, already sorted; empty if not ranked
+  QVector<ProcessInfo> processes[ProcessScanner::SortKeyCount];
+  int processCount = 0;
+  qint64 sampleNs = 0;
+};
+Q_DECLARE_METATYPE(SystemSample)
+
+// Runs on the monitor thread: owns the /proc files and previous counters,
+// and wakes only when some subscribed metric is due.
+class SystemMonitorWorker : public QObject {
+  Q_OBJECT
+
+public:
+  static constexpr int MetricCount = 8;
+
+  explicit SystemMonitorWorker(QObject *parent = nullptr);
+
+  bool pressureAvailable() const;
+
+public slots:
+  // Sampling interval per metric bit, 0 = not subscribed
+  void setIntervals(const QVector<int> &intervals);
+  void sampleNow(int metrics);
+  // Rows to rank per ProcessScanner::SortKey, 0 = none
+  void setProcessQuery(const QVector<int> &limits);
+
+signals:
+  void sampled(const SystemSample &sample);
+
+private:
+  void sample(int metrics);
+  void schedule();
+  void sampleSoon(int index);
+  bool readCpu(SystemSample &sample);
+  bool readDisk(SystemSample &sample);
+  bool readProcesses(SystemSample &sample);
+  void rankProcesses(SystemSample &sample) const;
+  bool readNetwork(SystemSample &sample);
+
+  QTimer *m_timer = nullptr;
+  QElapsedTimer m_clock;
+  QVector<int> m_intervals;
+  QVector<qint64> m_due; // m_clock ms; -1 = off
+
+  ProcSampler m_sampler;
+  CpuTimes m_prevCpu;
+  QVector<CpuTimes> m_cores;
+  QVector<CpuTimes> m_prevCores;
+
+  DiskSampler *m_disks = nullptr;
+  PressureSampler *m_pressure = nullptr;
+  PowerSupplySampler *m_power = nullptr;
+  HwmonSampler m_hwmon;
+
+  QVector<NetworkCounters> m_network;
+  QVector<NetworkCounters> m_prevNetwork;
+  QVector<NetworkInfo> m_networkRates; // Names built once per interface
+  QElapsedTimer m_sinceNetwork;
+
+  ProcessScanner m_processes;
+  QVector<int> m_processLimits =
+      QVector<int>(ProcessScanner::SortKeyCount, 0);
+};
+
+// Shared system metrics (one instance per process).
+//
+// Sampling runs on a background thread and only for what is subscribed:
+// consumers call subscribe(metrics, interval) (or use MonitorSubscription in
+// QML) and each metric is read at the fastest interval any subscriber asked
+// for. With no subscribers the thread sleeps, so hidden panels cost nothing.
 class SystemMonitor : public QObject {
   Q_OBJECT
+  QML_ELEMENT
+  QML_SINGLETON
   Q_PROPERTY(double cpuUsage READ cpuUsage NOTIFY statsChanged)
   Q_PROPERTY(double memoryUsage READ memoryUsage NOTIFY statsChanged)
   Q_PROPERTY(double diskUsage READ diskUsage NOTIFY statsChanged)
+  Q_PROPERTY(double lastSampleTime READ lastSampleTime NOTIFY statsChanged)
+  Q_PROPERTY(int activeMetrics READ activeMetrics NOTIFY subscriptionsChanged)
+  // The X screen saver (blanking or a locker) is on, as polled while anything
+  // is subscribed: only recordHistory keeps sampling, the rest is paused
+  Q_PROPERTY(bool screenLocked READ screenLocked NOTIFY screenLockedChanged)
+
+  // Per-core CPU (0..1), indexed by CPU number
+  Q_PROPERTY(int coreCount READ coreCount NOTIFY coreCountChanged)
+  Q_PROPERTY(QList<qreal> coreUsages READ coreUsages NOTIFY statsChanged)
+
+  // Ring-buffer history of each metric, for Sparkline
+  Q_PROPERTY(MetricHistory *cpuHistory READ cpuHistory CONSTANT)
+  Q_PROPERTY(MetricHistory *memoryHistory READ memoryHistory CONSTANT)
+  Q_PROPERTY(MetricHistory *diskHistory READ diskHistory CONSTANT)
+
+  // While true, cpu, memory, disk and network are sampled every second and
+  // kept on disk for a month (see MetricArchive), for longHistory()
+  Q_PROPERTY(bool recordHistory READ recordHistory WRITE setRecordHistory
+                 NOTIFY recordHistoryChanged)
+
+  // Physical interfaces combined, bytes per second (subscribe to Network)
+  Q_PROPERTY(double networkRxRate READ networkRxRate NOTIFY statsChanged)
+  Q_PROPERTY(double networkTxRate READ networkTxRate NOTIFY statsChanged)
+  Q_PROPERTY(MetricHistory *networkRxHistory READ networkRxHistory CONSTANT)
+  Q_PROPERTY(MetricHistory *networkTxHistory READ networkTxHistory CONSTANT)
+  // Per interface, with their own histories
+  Q_PROPERTY(NetworkModel *networks READ networks CONSTANT)
+
+  // Every real mount with usage and I/O rates (subscribe to Disk)
+  Q_PROPERTY(DiskModel *disks READ disks CONSTANT)
+
+  // Pressure stall averages (subscribe to Pressure). Stalls past the
+  // trigger thresholds are pushed at once, so a slow interval is enough.
+  Q_PROPERTY(bool pressureAvailable READ pressureAvailable CONSTANT)
+  Q_PROPERTY(PressureValues cpuPressure READ cpuPressure NOTIFY pressureChanged)
+  Q_PROPERTY(PressureValues memoryPressure READ memoryPressure NOTIFY
+                 pressureChanged)
+  Q_PROPERTY(PressureValues ioPressure READ ioPressure NOTIFY pressureChanged)
+
+  // hwmon and cpufreq (subscribe to Sensors)
+  Q_PROPERTY(double cpuTemperature READ cpuTemperature NOTIFY statsChanged)
+  Q_PROPERTY(double cpuFrequency READ cpuFrequency NOTIFY statsChanged)
+  Q_PROPERTY(double cpuMaxFrequency READ cpuMaxFrequency NOTIFY statsChanged)
+  Q_PROPERTY(SensorModel *sensors READ sensors CONSTANT)
+
+  // Batteries combined (subscribe to Battery). Updates follow power_supply
+  // uevents, so a long interval is enough.
+  Q_PROPERTY(BatteryState battery READ battery NOTIFY batteryChanged)
+
+  // Top processes (subscribe to Processes); sortBy/limit set the query.
+  // Shared by everything that reads it: a table that sorts or sizes itself
+  // takes its own from createProcessModel()
+  Q_PROPERTY(ProcessModel *processes READ processes CONSTANT)
 
 public:
-  explicit SystemMonitor(QObject *parent = nullptr);
+  enum Metric {
+    Cpu = 0x1,
+    Memory = 0x2,
+    Disk = 0x4,
+    Processes = 0x8,
+    Network = 0x10,
+    Pressure = 0x20,
+    Sensors = 0x40,
+    Battery = 0x80,
+    AllMetrics =
+        Cpu | Memory | Disk | Processes | Network | Pressure | Sensors | Battery
+  };
+  Q_ENUM(Metric)
+
+  // Time range of longHistory(); Live is the in-memory ring
+  enum HistorySpan { Live, Hour, Day, Month };
+  Q_ENUM(HistorySpan)
+
+  static constexpr int DefaultIntervalMs = 1000;
+  static constexpr int RecordIntervalMs = 1000;
+  static constexpr int MinIntervalMs = 100;
+  static constexpr int LockPollMs = 2000;
+
+  static SystemMonitor *instance();
+  static SystemMonitor *create(QQmlEngine *qmlEngine, QJSEngine *jsEngine) {
+    Q_UNUSED(qmlEngine)
+    Q_UNUSED(jsEngine)
+    SystemMonitor *monitor = instance();
+    QJSEngine::setObjectOwnership(monitor, QJSEngine::CppOwnership);
+    return monitor;
+  }
   ~SystemMonitor();
 
+  // Returns a token for unsubscribe()
+  Q_INVOKABLE int subscribe(int metrics, int intervalMs = DefaultIntervalMs);
+  Q_INVOKABLE void unsubscribe(int token);
+
   double cpuUsage() const { return m_cpuUsage; }
   double memoryUsage() const { return m_memoryUsage; }
   double diskUsage() const { return m_diskUsage; }
+  double lastSampleTime() const { return m_lastSampleNs / 1e6; } // ms
+  int activeMetrics() const;
+  bool screenLocked() const { return m_screenLocked; }
+
+  int coreCount() const { return m_coreUsages.size(); }
+  QList<qreal> coreUsages() const { return m_coreUsages; }
+  Q_INVOKABLE double coreUsage(int core) const {
+    return m_coreUsages.value(core);
+  }
+  Q_INVOKABLE MetricHistory *coreHistory(int core) const {
+    return m_coreHistories.value(core);
+  }
+
+  // "cpu", "memory", "disk", "networkRx" or "networkTx" over `span`: one
+  // point per second (Hour), minute (Day) or hour (Month), loaded from the
+  // archive, so it covers time before this process started
+  Q_INVOKABLE MetricHistory *longHistory(const QString &metric,
+                                         int span = Day);
+
+  bool recordHistory() const { return m_recordHistory; }
+  void setRecordHistory(bool record);
+
+  MetricHistory *cpuHistory() const { return m_cpuHistory; }
+  MetricHistory *memoryHistory() const { return m_memoryHistory; }
+  MetricHistory *diskHistory() const { return m_diskHistory; }
+
+  double networkRxRate() const { return m_networkRxRate; }
+  double networkTxRate() const { return m_networkTxRate; }
+  MetricHistory *networkRxHistory() const { return m_networkRxHistory; }
+  MetricHistory *networkTxHistory() const { return m_networkTxHistory; }
+  NetworkModel *networks() const { return m_networks; }
+
+  bool pressureAvailable() const { return m_pressureAvailable; }
+  PressureValues cpuPressure() const { return m_cpuPressure; }
+  PressureValues memoryPressure() const { return m_memoryPressure; }
+  PressureValues ioPressure() const { return m_ioPressure; }
+
+  double cpuTemperature() const { return m_cpuTemperature; }
+  double cpuFrequency() const { return m_cpuFrequency; }
+  double cpuMaxFrequency() const { return m_cpuMaxFrequency; }
+  SensorModel *sensors() const { return m_sensors; }
+  BatteryState battery() const { return m_battery; }
+
+  DiskModel *disks() const { return m_disks; }
+  ProcessModel *processes() const { return m_processes; }
+  // A process table with its own sortBy/limit, deleted with `owner`. Each
+  // sort key is ranked once per sample, for the largest limit asking for it.
+  Q_INVOKABLE ProcessModel *createProcessModel(QObject *owner);
 
 public slots:
+  // Sample every subscribed metric now instead of waiting for the timer
   void updateStats();
 
 signals:
   void statsChanged();
+  void coreCountChanged();
+  void subscriptionsChanged();
+  void screenLockedChanged();
+  void recordHistoryChanged();
+  void pressureChanged();
+  // Some resource crossed its stall threshold
+  void pressureStalled();
+  void batteryChanged();
 
 private:
-  void readCpuUsage();
-  void readMemoryUsage();
-  void readDiskUsage();
+  explicit SystemMonitor(QObject *parent = nullptr);
+
+  struct Subscription {
+    int metrics = 0;
+    int intervalMs = DefaultIntervalMs;
+  };
+
+  void updateIntervals();
+  void pollScreenLock();
+  void addProcessModel(ProcessModel *model);
+  void updateProcessQuery();
+  void applySample(const SystemSample &sample);
+
+  enum ArchivedMetric {
+    ArchiveCpu,
+    ArchiveMemory,
+    ArchiveDisk,
+    ArchiveNetworkRx,
+    ArchiveNetworkTx,
+    ArchiveCount
+  };
+
+  struct Archived {
+    std::unique_ptr<MetricArchive> file; // Opened on first use
+    MetricHistory *histories[MetricArchive::TierCount] = {};
+    qint64 shownBuckets[MetricArchive::TierCount] = {-1, -1, -1};
+  };
+
+  MetricArchive *openArchive(int metric);
+  void record(int metric, double value, qint64 time);
+
+  QHash<int, Subscription> m_subscriptions;
+  int m_nextToken = 1;
+
+  QThread m_thread;
+  SystemMonitorWorker *m_worker = nullptr;
+
+  // Polled while anything is subscribed; opened on the first subscription
+  std::unique_ptr<IdleMonitor> m_idleMonitor;
+  QTimer m_lockPollTimer;
+  bool m_screenLocked = false;
 
-  QTimer *m_timer;
   double m_cpuUsage = 0.0;
   double m_memoryUsage = 0.0;
   double m_diskUsage = 0.0;
+  double m_networkRxRate = 0.0;
+  double m_networkTxRate = 0.0;
+  qint64 m_lastSampleNs = 0;
+  bool m_pressureAvailable = false;
+  PressureValues m_cpuPressure;
+  PressureValues m_memoryPressure;
+  PressureValues m_ioPressure;
+  double m_cpuTemperature = 0.0;
+  double m_cpuFrequency = 0.0;
+  double m_cpuMaxFrequency = 0.0;
+  BatteryState m_battery;
+  QList<qreal> m_coreUsages;
 
-  // CPU calculation helpers
-  unsigned long long m_prevIdle = 0;
-  unsigned long long m_prevTotal = 0;
+  MetricHistory *m_cpuHistory;
+  MetricHistory *m_memoryHistory;
+  MetricHistory *m_diskHistory;
+  MetricHistory *m_networkRxHistory;
+  MetricHistory *m_networkTxHistory;
+  QList<MetricHistory *> m_coreHistories;
+  Archived m_archived[ArchiveCount];
+  bool m_recordHistory = false;
+  int m_recordToken = 0;
+  DiskModel *m_disks;
+  NetworkModel *m_networks;
+  SensorModel *m_sensors;
+  ProcessModel *m_processes;
+  QList<QPointer<ProcessModel>> m_processModels; // m_processes included
 };
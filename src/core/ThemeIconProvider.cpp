@@ -0,0 +1,544 @@
+#include "ThemeIconProvider.h"
+#include <QAtomicInt>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QIcon>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+#include <climits>
+
+namespace {
+
+const QString FallbackIcon = QStringLiteral("application-x-executable");
+const QStringList IconExtensions = {"png", "svg", "xpm"}; // Preference order
+
+qint64 modifiedMs(const QString &path) {
+  return QFileInfo(path).lastModified().toMSecsSinceEpoch();
+}
+
+QSize effectiveSize(const QSize &requested) {
+  int w = requested.width() > 0 ? requested.width() : requested.height();
+  int h = requested.height() > 0 ? requested.height() : requested.width();
+  if (w <= 0 || h <= 0)
+    return QSize(ThemeIconProvider::DefaultSize, ThemeIconProvider::DefaultSize);
+  return QSize(w, h);
+}
+
+QImage rasterize(const QString &path, const QSize &size) {
+  QImageReader reader(path);
+  const QSize natural = reader.size();
+  // Vector formats (and large bitmaps) render straight at the target size
+  if (reader.supportsOption(QImageIOHandler::ScaledSize) && natural.isValid())
+    reader.setScaledSize(natural.scaled(size, Qt::KeepAspectRatio));
+
+  QImage image = reader.read();
+  if (image.isNull()) {
+    qWarning() << "[ThemeIcons] Failed to read" << path << ":"
+               << reader.errorString();
+    return image;
+  }
+  if (image.width() > size.width() || image.height() > size.height() ||
+      (image.width() < size.width() && image.height() < size.height())) {
+    image = image.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+  }
+  return image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+class ThemeIconResponse : public QQuickImageResponse, public QRunnable {
+public:
+  ThemeIconResponse(ThemeIconProvider *provider, const QString &name,
+                    const QSize &size,
+                    const ThemeIconProvider::IconPaths &paths)
+      : m_provider(provider), m_name(name), m_size(size), m_paths(paths) {
+    setAutoDelete(false); // Owned by the engine, which deletes it on finished
+  }
+
+  void run() override {
+    if (!m_cancelled.loadRelaxed())
+      m_image = m_provider->loadIcon(m_name, m_size, m_paths);
+    emit finished();
+  }
+
+  void cancel() override { m_cancelled.storeRelaxed(1); }
+
+  QQuickTextureFactory *textureFactory() const override {
+    return QQuickTextureFactory::textureFactoryForImage(m_image);
+  }
+
+private:
+  ThemeIconProvider *m_provider;
+  QString m_name;
+  QSize m_size;
+  ThemeIconProvider::IconPaths m_paths;
+  QImage m_image;
+  QAtomicInt m_cancelled;
+};
+
+} // namespace
+
+// One icon theme's directories (index.theme) and every icon file in them,
+// listed once. Immutable after construction, so lookups need no lock.
+class IconThemeIndex {
+public:
+  IconThemeIndex(const QString &name, const QStringList &searchPaths);
+
+  bool isValid() const { return !m_dirs.isEmpty(); }
+  const QStringList &inherits() const { return m_inherits; }
+  // Some listed directory was modified (an icon added or removed) since
+  bool isStale() const;
+
+  // Best file for `name` at `size` pixels, following the spec's
+  // DirectoryMatchesSize / DirectorySizeDistance rules
+  QString lookup(const QString &name, int size) const;
+
+private:
+  struct Dir {
+    enum Type { Fixed, Scalable, Threshold };
+    Type type = Threshold;
+    int size = 0;
+    int minSize = 0;
+    int maxSize = 0;
+    int threshold = 2;
+    int scale = 1;
+  };
+  struct File {
+    int dir;
+    QString path;
+  };
+
+  bool matchesSize(const Dir &dir, int size) const;
+  int sizeDistance(const Dir &dir, int size) const;
+
+  QList<Dir> m_dirs;
+  QStringList m_inherits;
+  QHash<QString, QList<File>> m_files;
+  QHash<QString, qint64> m_listed; // Directory -> mtime when listed
+};
+
+IconThemeIndex::IconThemeIndex(const QString &name,
+                               const QStringList &searchPaths) {
+  QStringList roots;
+  for (const QString &base : searchPaths) {
+    if (QFileInfo::exists(base + "/" + name))
+      roots.append(base + "/" + name);
+  }
+
+  for (const QString &root : roots)
+    m_listed.insert(root, modifiedMs(root));
+
+  for (const QString &root : roots) {
+    if (!QFileInfo::exists(root + "/index.theme"))
+      continue;
+    QSettings ini(root + "/index.theme", QSettings::IniFormat);
+    QStringList dirNames = ini.value("Icon Theme/Directories").toStringList();
+    dirNames += ini.value("Icon Theme/ScaledDirectories").toStringList();
+    m_inherits = ini.value("Icon Theme/Inherits").toStringList();
+
+    for (const QString &dirName : dirNames) {
+      ini.beginGroup(dirName);
+      Dir dir;
+      dir.size = ini.value("Size").toInt();
+      dir.scale = qMax(1, ini.value("Scale", 1).toInt());
+      dir.minSize = ini.value("MinSize", dir.size).toInt();
+      dir.maxSize = ini.value("MaxSize", dir.size).toInt();
+      dir.threshold = ini.value("Threshold", 2).toInt();
+      const QString type = ini.value("Type", "Threshold").toString();
+      if (type == "Fixed")
+        dir.type = Dir::Fixed;
+      else if (type == "Scalable")
+        dir.type = Dir::Scalable;
+      ini.endGroup();
+      if (dir.size <= 0)
+        continue;
+
+      // The directory may be spread over several base paths
+      const int index = m_dirs.size();
+      m_dirs.append(dir);
+      for (const QString &base : roots) {
+        QDir listing(base + "/" + dirName);
+        if (listing.exists())
+          m_listed.insert(listing.path(), modifiedMs(listing.path()));
+        const QStringList files = listing.entryList(
+            {"*.png", "*.svg", "*.xpm"}, QDir::Files | QDir::Readable);
+        for (const QString &file : files) {
+          const int dot = file.lastIndexOf('.');
+          QList<File> &entries = m_files[file.left(dot)];
+          // Keep one file per directory, preferring png over svg over xpm
+          bool replaced = false;
+          for (File &entry : entries) {
+            if (entry.dir != index)
+              continue;
+            const QString ext = entry.path.mid(entry.path.lastIndexOf('.') + 1);
+            if (IconExtensions.indexOf(file.mid(dot + 1)) <
+                IconExtensions.indexOf(ext))
+              entry.path = listing.filePath(file);
+            replaced = true;
+          }
+          if (!replaced)
+            entries.append({index, listing.filePath(file)});
+        }
+      }
+    }
+    break; // The first index.theme defines the theme
+  }
+}
+
+bool IconThemeIndex::isStale() const {
+  for (auto it = m_listed.cbegin(); it != m_listed.cend(); ++it) {
+    if (modifiedMs(it.key()) != it.value())
+      return true;
+  }
+  return false;
+}
+
+bool IconThemeIndex::matchesSize(const Dir &dir, int size) const {
+  switch (dir.type) {
+  case Dir::Fixed:
+    return dir.size * dir.scale == size;
+  case Dir::Scalable:
+    return dir.minSize * dir.scale <= size && size <= dir.maxSize * dir.scale;
+  case Dir::Threshold:
+    return (dir.size - dir.threshold) * dir.scale <= size &&
+           size <= (dir.size + dir.threshold) * dir.scale;
+  }
+  return false;
+}
+
+int IconThemeIndex::sizeDistance(const Dir &dir, int size) const {
+  int low = dir.size;
+  int high = dir.size;
+  if (dir.type == Dir::Scalable) {
+    low = dir.minSize;
+    high = dir.maxSize;
+  } else if (dir.type == Dir::Threshold) {
+    low = dir.size - dir.threshold;
+    high = dir.size + dir.threshold;
+  }
+  if (size < low * dir.scale)
+    return low * dir.scale - size;
+  if (size > high * dir.scale)
+    return size - high * dir.scale;
+  return 0;
+}
+
+QString IconThemeIndex::lookup(const QString &name, int size) const {
+  auto it = m_files.constFind(name);
+  if (it == m_files.cend())
+    return QString();
+
+  QString closest;
+  int closestDistance = INT_MAX;
+  for (const File &file : *it) {
+    const Dir &dir = m_dirs.at(file.dir);
+    if (matchesSize(dir, size))
+      return file.path;
+    const int distance = sizeDistance(dir, size);
+    if (distance < closestDistance) {
+      closestDistance = distance;
+      closest = file.path;
+    }
+  }
+  return closest;
+}
+
+ThemeIconProvider::ThemeIconProvider()
+    : m_cacheDir(QStandardPaths::writableLocation(
+                     QStandardPaths::GenericCacheLocation) +
+                 "/canvasdesk/icons"),
+      m_memory(MemoryCacheKiB) {
+  m_pool.setObjectName("CanvasDeskThemeIcons");
+  m_pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 4));
+  m_clock.start();
+
+  updateIconPaths();
+  // Platform theme changes reach the windows as ThemeChange events
+  qApp->installEventFilter(this);
+}
+
+ThemeIconProvider::~ThemeIconProvider() {
+  m_pool.clear();
+  m_pool.waitForDone();
+}
+
+QQuickImageResponse *
+ThemeIconProvider::requestImageResponse(const QString &id,
+                                        const QSize &requestedSize) {
+  auto *response = new ThemeIconResponse(this, id, effectiveSize(requestedSize),
+                                         iconPaths());
+  m_pool.start(response);
+  return response;
+}
+
+bool ThemeIconProvider::eventFilter(QObject *watched, QEvent *event) {
+  if (event->type() == QEvent::ThemeChange)
+    updateIconPaths();
+  return QQuickAsyncImageProvider::eventFilter(watched, event);
+}
+
+ThemeIconProvider::IconPaths ThemeIconProvider::iconPaths() const {
+  QMutexLocker locker(&m_pathsMutex);
+  return m_paths;
+}
+
+void ThemeIconProvider::updateIconPaths() {
+  IconPaths paths;
+  paths.theme = QIcon::themeName();
+  paths.themeSearchPaths = QIcon::themeSearchPaths();
+  paths.pixmapDirs =
+      QIcon::fallbackSearchPaths() + QStringList{"/usr/share/pixmaps"};
+  {
+    QMutexLocker locker(&m_pathsMutex);
+    if (paths.theme == m_paths.theme &&
+        paths.themeSearchPaths == m_paths.themeSearchPaths &&
+        paths.pixmapDirs == m_paths.pixmapDirs)
+      return; // Every window gets its own ThemeChange
+    m_paths = paths;
+  }
+
+  qDebug() << "[ThemeIcons] Using icon theme" << paths.theme;
+  {
+    QMutexLocker locker(&m_themesMutex);
+    m_themes.clear();
+  }
+  QMutexLocker locker(&m_memoryMutex);
+  m_memory.clear();
+  m_misses.clear();
+}
+
+QImage ThemeIconProvider::loadIcon(const QString &name, const QSize &size,
+                                   const IconPaths &paths) {
+  // Requests still in flight across a theme change keep their own entries
+  const QString key = QStringLiteral("%1/%2@%3x%4")
+                          .arg(paths.theme, name)
+                          .arg(size.width())
+                          .arg(size.height());
+  {
+    QMutexLocker locker(&m_memoryMutex);
+    if (QImage *cached = m_memory.object(key))
+      return *cached;
+    auto miss = m_misses.constFind(key);
+    if (miss != m_misses.cend()) {
+      if (m_clock.elapsed() < *miss) {
+        locker.unlock();
+        return loadIcon(FallbackIcon, size, paths);
+      }
+      m_misses.erase(miss);
+    }
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  const QString cachePath = diskCachePath(paths.theme, name, size);
+  QImage image = readDiskCache(cachePath, name);
+  bool fromDisk = !image.isNull();
+
+  if (image.isNull()) {
+    const int pixels = qMax(size.width(), size.height());
+    Source source = findIcon(name, pixels, paths);
+    // The icon may have been installed after its theme was indexed
+    if (source.path.isEmpty() && expireStaleThemes())
+      source = findIcon(name, pixels, paths);
+
+    if (source.path.isEmpty()) {
+      if (name == FallbackIcon)
+        return image;
+      // Not cached under this name, so the real icon shows once it exists
+      {
+        QMutexLocker locker(&m_memoryMutex);
+        m_misses.insert(key, m_clock.elapsed() + MissRetryMs);
+      }
+      return loadIcon(FallbackIcon, size, paths);
+    }
+
+    image = rasterize(source.path, size);
+    if (!image.isNull())
+      writeDiskCache(cachePath, image, source);
+  }
+
+  if (image.isNull())
+    return image;
+
+  if (!fromDisk) {
+    qDebug() << "[ThemeIcons] Rendered" << name << size << "in"
+             << timer.nsecsElapsed() / 1000 << "us";
+  }
+
+  QMutexLocker locker(&m_memoryMutex);
+  m_memory.insert(key, new QImage(image),
+                  qMax<qsizetype>(1, image.sizeInBytes() / 1024));
+  return image;
+}
+
+ThemeIconProvider::Source
+ThemeIconProvider::findIcon(const QString &name, int size,
+                            const IconPaths &paths) {
+  Source source;
+  if (QDir::isAbsolutePath(name)) {
+    if (QFileInfo::exists(name)) {
+      source.path = name;
+      source.mtime = modifiedMs(name);
+    }
+    return source;
+  }
+
+  // Theme chain, following Inherits, with hicolor last
+  QStringList chain;
+  auto addTheme = [&chain](const QString &theme) {
+    if (!theme.isEmpty() && !chain.contains(theme))
+      chain.append(theme);
+  };
+  addTheme(paths.theme);
+  for (int i = 0; i < chain.size(); ++i) {
+    if (auto index = themeIndex(chain.at(i), paths))
+      for (const QString &parent : index->inherits())
+        addTheme(parent);
+  }
+  addTheme("hicolor");
+
+  auto fromThemes = [&](const QString &candidate) {
+    for (const QString &theme : chain) {
+      auto index = themeIndex(theme, paths);
+      if (!index)
+        continue;
+      const QString path = index->lookup(candidate, size);
+      if (!path.isEmpty())
+        return path;
+    }
+    return QString();
+  };
+
+  // Some desktop files name the icon with its extension
+  QString stem = name;
+  for (const QString &ext : IconExtensions) {
+    if (stem.endsWith("." + ext))
+      stem.chop(ext.size() + 1);
+  }
+
+  source.path = fromThemes(stem);
+
+  // Unthemed icons
+  for (const QString &base : paths.pixmapDirs) {
+    for (const QString &ext : IconExtensions) {
+      if (!source.path.isEmpty())
+        break;
+      const QString path = base + "/" + stem + "." + ext;
+      if (QFileInfo::exists(path))
+        source.path = path;
+    }
+  }
+
+  // Less specific names last, as QIcon does ("app-name-foo" -> "app-name")
+  for (int dash = stem.lastIndexOf('-'); source.path.isEmpty() && dash > 0;
+       dash = stem.lastIndexOf('-', dash - 1)) {
+    source.path = fromThemes(stem.left(dash));
+  }
+
+  if (!source.path.isEmpty())
+    source.mtime = modifiedMs(source.path);
+  return source;
+}
+
+std::shared_ptr<IconThemeIndex>
+ThemeIconProvider::themeIndex(const QString &theme, const IconPaths &paths) {
+  QMutexLocker locker(&m_themesMutex);
+  auto it = m_themes.constFind(theme);
+  if (it != m_themes.cend())
+    return *it;
+
+  QElapsedTimer timer;
+  timer.start();
+  auto index = std::make_shared<IconThemeIndex>(theme, paths.themeSearchPaths);
+  if (!index->isValid())
+    index.reset(); // Cached as missing, so it's not probed again
+  else
+    qDebug() << "[ThemeIcons] Indexed theme" << theme << "in"
+             << timer.elapsed() << "ms";
+  m_themes.insert(theme, index);
+  return index;
+}
+
+bool ThemeIconProvider::expireStaleThemes() {
+  QMutexLocker locker(&m_themesMutex);
+  const qint64 now = m_clock.elapsed();
+  if (m_staleCheckMs >= 0 && now - m_staleCheckMs < MissRetryMs)
+    return false;
+  m_staleCheckMs = now;
+
+  bool expired = false;
+  for (auto it = m_themes.begin(); it != m_themes.end();) {
+    // Missing themes are probed again too: one may have been installed
+    if (!*it || (*it)->isStale()) {
+      qDebug() << "[ThemeIcons] Reindexing theme" << it.key();
+      it = m_themes.erase(it);
+      expired = true;
+    } else {
+      ++it;
+    }
+  }
+  return expired;
+}
+
+QString ThemeIconProvider::diskCachePath(const QString &theme,
+                                         const QString &name,
+                                         const QSize &size) const {
+  const QByteArray hash =
+      QCryptographicHash::hash(name.toUtf8(), QCryptographicHash::Sha1)
+          .toHex()
+          .left(20);
+  return QStringLiteral("%1/%2/%3-%4x%5.png")
+      .arg(m_cacheDir, theme.isEmpty() ? QStringLiteral("none") : theme,
+           QString::fromLatin1(hash))
+      .arg(size.width())
+      .arg(size.height());
+}
+
+QImage ThemeIconProvider::readDiskCache(const QString &path,
+                                        const QString &name) const {
+  QImageReader reader(path, "png");
+  if (!reader.canRead())
+    return QImage();
+
+  // Stale if the icon it was rendered from changed or went away. Older
+  // versions cached the fallback under the missing name: never trust that.
+  const QString source = reader.text("Source");
+  if (source.isEmpty() || !QFileInfo::exists(source) ||
+      reader.text("SourceMtime").toLongLong() != modifiedMs(source) ||
+      (name != FallbackIcon &&
+       QFileInfo(source).completeBaseName() == FallbackIcon))
+    return QImage();
+
+  QImage image = reader.read();
+  if (image.isNull())
+    return image;
+  return image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+void ThemeIconProvider::writeDiskCache(const QString &path, const QImage &image,
+                                       const Source &source) const {
+  QDir().mkpath(QFileInfo(path).absolutePath());
+
+  QImage tagged = image;
+  tagged.setText("Source", source.path);
+  tagged.setText("SourceMtime", QString::number(source.mtime));
+
+  // Icons are small; favour encode speed over size
+  QSaveFile file(path);
+  QImageWriter writer(&file, "png");
+  writer.setCompression(1);
+  if (!file.open(QIODevice::WriteOnly) || !writer.write(tagged) ||
+      !file.commit()) {
+    qWarning() << "[ThemeIcons] Failed to cache" << path << ":"
+               << writer.errorString();
+  }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QCache>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QQuickAsyncImageProvider>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <memory>
+
+class IconThemeIndex;
+
+// Asynchronous provider for image://theme/<icon name or absolute path>.
+//
+// Lookup and rasterization run on a small dedicated thread pool, never on the
+// GUI thread. Icons are resolved with our own freedesktop icon theme lookup
+// (QIcon's loader and pixmap cache are not safe to use off the GUI thread):
+// each theme's directories are listed once into a name -> files index.
+//
+// Results are cached twice:
+//  - in memory, LRU by (theme, name, pixel size). The requested size already
+//    includes the item's device pixel ratio, so that is part of the key too.
+//  - on disk as PNGs under $XDG_CACHE_HOME/canvasdesk/icons/<theme>/, tagged
+//    with the source file and its mtime, so a cold start decodes a small PNG
+//    instead of rendering the SVG again.
+//
+// QIcon's theme name and search paths are only read on the GUI thread: they
+// are snapshotted at construction and again on QEvent::ThemeChange, and each
+// request carries the snapshot to the pool.
+//
+// A name that isn't found shows the generic application icon, but only that
+// icon is cached: the miss itself is remembered in memory for MissRetryMs.
+// A .desktop file often lands before its icon, so on a miss the theme indexes
+// whose directories changed since they were listed are rebuilt (at most once
+// per MissRetryMs) and the lookup is tried again.
+class ThemeIconProvider : public QQuickAsyncImageProvider {
+public:
+  static constexpr int DefaultSize = 64;
+  static constexpr int MemoryCacheKiB = 32 * 1024;
+  static constexpr int MissRetryMs = 10 * 1000;
+
+  // QIcon settings as of the last GUI-thread snapshot
+  struct IconPaths {
+    QString theme;
+    QStringList themeSearchPaths;
+    QStringList pixmapDirs; // Unthemed icons
+  };
+
+  ThemeIconProvider();
+  ~ThemeIconProvider() override;
+
+  QQuickImageResponse *requestImageResponse(const QString &id,
+                                            const QSize &requestedSize) override;
+
+  // Runs on a pool thread
+  QImage loadIcon(const QString &name, const QSize &size,
+                  const IconPaths &paths);
+
+protected:
+  bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+  struct Source {
+    QString path;
+    qint64 mtime = 0;
+  };
+
+  IconPaths iconPaths() const;
+  // GUI thread only; drops every cache if the theme or its paths changed
+  void updateIconPaths();
+
+  Source findIcon(const QString &name, int size, const IconPaths &paths);
+  std::shared_ptr<IconThemeIndex> themeIndex(const QString &theme,
+                                             const IconPaths &paths);
+  // Drops indexes whose directories changed; true if any was dropped
+  bool expireStaleThemes();
+  QString diskCachePath(const QString &theme, const QString &name,
+                        const QSize &size) const;
+  QImage readDiskCache(const QString &path, const QString &name) const;
+  void writeDiskCache(const QString &path, const QImage &image,
+                      const Source &source) const;
+
+  QThreadPool m_pool;
+  QString m_cacheDir;
+
+  mutable QMutex m_pathsMutex;
+  IconPaths m_paths;
+
+  QMutex m_memoryMutex;
+  QCache<QString, QImage> m_memory; // Cost in KiB
+  QHash<QString, qint64> m_misses;  // Key -> m_clock ms to retry at
+  QElapsedTimer m_clock;
+
+  QMutex m_themesMutex; // Also serializes index builds
+  QHash<QString, std::shared_ptr<IconThemeIndex>> m_themes;
+  qint64 m_staleCheckMs = -1; // m_clock ms of the last expireStaleThemes()
+};
@@ -1,26 +1,71 @@
 #include "ThemeManager.h"
+#include "PersistenceService.h"
+#include "IdleMonitor.h"
+#include "WallpaperCache.h"
 #include <QFile>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QImageReader>
+#include <QRandomGenerator>
+#include <QScreen>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QStandardPaths>
 #include <QDir>
 #include <QDebug>
-#include <QMap>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentRun>
 #include <vector>
 #include <algorithm>
 #include <cmath>
 
 static ThemeManager* s_instance = nullptr;
 
+// The pixel sizes DesktopMode.qml asks the wallpaper provider for
+static QList<QSize> outputSizes() {
+    QList<QSize> sizes;
+    const QList<QScreen *> screens = QGuiApplication::screens();
+    for (QScreen *screen : screens) {
+        sizes.append((QSizeF(screen->size()) * screen->devicePixelRatio()).toSize());
+    }
+    return sizes;
+}
+
 ThemeManager* ThemeManager::instance() {
     return s_instance;
 }
 
 ThemeManager::ThemeManager(QObject *parent) : QObject(parent) {
     s_instance = this;
+    connect(&m_paletteWatcher, &QFutureWatcherBase::finished, this, &ThemeManager::onPaletteReady);
+    connect(&m_slideWatcher, &QFutureWatcherBase::finished, this, &ThemeManager::onSlidePrefetched);
+    connect(&m_slideshowTimer, &QTimer::timeout, this, &ThemeManager::onSlideshowTick);
+    m_idlePollTimer.setInterval(IdlePollMs);
+    connect(&m_idlePollTimer, &QTimer::timeout, this, &ThemeManager::onIdlePoll);
+
+    // Decoded wallpapers are only kept at the sizes of the current screens
+    if (qGuiApp) {
+        connect(qGuiApp, &QGuiApplication::screenAdded, this, [this](QScreen *screen) {
+            watchScreen(screen);
+            updateOutputSizes();
+        });
+        connect(qGuiApp, &QGuiApplication::screenRemoved, this, &ThemeManager::updateOutputSizes,
+                Qt::QueuedConnection); // Still listed while the signal is emitted
+        const QList<QScreen *> screens = QGuiApplication::screens();
+        for (QScreen *screen : screens) {
+            watchScreen(screen);
+        }
+        updateOutputSizes();
+    }
     loadColors();
 }
 
+ThemeManager::~ThemeManager() {
+    if (s_instance == this) {
+        s_instance = nullptr;
+    }
+}
+
 QString ThemeManager::wallpaperPath() const {
     return m_wallpaperPath;
 }
@@ -65,22 +110,44 @@ void ThemeManager::analyzeWallpaper(const QString &path) {
     if (localPath.startsWith("file://")) {
         localPath = localPath.mid(7);
     }
+    if (localPath.isEmpty()) {
+        return;
+    }
+
+    if (m_paletteWatcher.isRunning()) {
+        m_pendingAnalysis = localPath;
+        return;
+    }
+    m_paletteWatcher.setFuture(QtConcurrent::run(WallpaperPalette::analyze, localPath));
+}
+
+void ThemeManager::onPaletteReady() {
+    const WallpaperPalette::Result result = m_paletteWatcher.result();
+
+    if (!m_pendingAnalysis.isEmpty()) {
+        // The wallpaper changed again while this one was analyzed
+        const QString next = m_pendingAnalysis;
+        m_pendingAnalysis.clear();
+        if (next != result.path) {
+            analyzeWallpaper(next);
+            return;
+        }
+    }
 
-    QImage image(localPath);
-    if (image.isNull()) {
-        qWarning() << "Failed to load wallpaper for analysis:" << localPath;
+    if (result.path != WallpaperCache::localPath(m_wallpaperPath)) {
+        return; // The slideshow moved on and brought its own palette
+    }
+    if (result.colors.isEmpty()) {
+        qWarning() << "Failed to load wallpaper for analysis:" << result.path;
         return;
     }
 
-    extractColors(image);
+    beginUpdate();
+    extractColors(result.colors);
     saveColors();
+    endUpdate();
 }
 
-struct ColorCount {
-    QRgb color;
-    int count;
-};
-
 // Simple color distance
 double colorDistance(QRgb c1, QRgb c2) {
     long rmean = ((long)qRed(c1) + (long)qRed(c2)) / 2;
@@ -90,50 +157,21 @@ double colorDistance(QRgb c1, QRgb c2) {
     return std::sqrt((((512+rmean)*r*r)>>8) + 4*g*g + (((767-rmean)*b*b)>>8));
 }
 
-void ThemeManager::extractColors(const QImage &sourceImage) {
-    // Scale down for performance
-    QImage image = sourceImage.scaled(100, 100, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-    
-    QMap<QRgb, int> histogram;
-    int totalPixels = 0;
-
-    // Quantize colors to reduce noise (5-bit per channel)
-    for (int y = 0; y < image.height(); ++y) {
-        for (int x = 0; x < image.width(); ++x) {
-            QRgb pixel = image.pixel(x, y);
-            int r = (qRed(pixel) / 8) * 8;
-            int g = (qGreen(pixel) / 8) * 8;
-            int b = (qBlue(pixel) / 8) * 8;
-            QRgb quantized = qRgb(r, g, b);
-            histogram[quantized]++;
-            totalPixels++;
-        }
-    }
-
-    std::vector<ColorCount> sortedColors;
-    for (auto it = histogram.begin(); it != histogram.end(); ++it) {
-        sortedColors.push_back({it.key(), it.value()});
-    }
-
-    // Sort by frequency
-    std::sort(sortedColors.begin(), sortedColors.end(), [](const ColorCount &a, const ColorCount &b) {
-        return a.count > b.count;
-    });
-
+void ThemeManager::extractColors(const QVector<QRgb> &candidates) {
     // Pick distinct top colors
     std::vector<QRgb> palette;
     double minDistance = 50.0; // Minimum distance to be considered distinct
 
-    for (const auto &cc : sortedColors) {
+    for (QRgb candidate : candidates) {
         bool distinct = true;
         for (const auto &existing : palette) {
-            if (colorDistance(cc.color, existing) < minDistance) {
+            if (colorDistance(candidate, existing) < minDistance) {
                 distinct = false;
                 break;
             }
         }
         if (distinct) {
-            palette.push_back(cc.color);
+            palette.push_back(candidate);
         }
         if (palette.size() >= 10) break; // Get top 10 candidates
     }
@@ -189,17 +227,16 @@ void ThemeManager::extractColors(const QImage &sourceImage) {
     m_uiTitleBarLeft = m_secondary;
     m_uiTitleBarRight = m_primary;
 
-    emit colorsChanged();
-    emit uiColorsChanged();
+    notifyChanged(ColorsChange | UiColorsChange);
 }
 
-void ThemeManager::setUiPrimaryColor(const QColor &c) { if (m_uiPrimary != c) { m_uiPrimary = c; emit uiColorsChanged(); saveColors(); } }
-void ThemeManager::setUiSecondaryColor(const QColor &c) { if (m_uiSecondary != c) { m_uiSecondary = c; emit uiColorsChanged(); saveColors(); } }
-void ThemeManager::setUiTertiaryColor(const QColor &c) { if (m_uiTertiary != c) { m_uiTertiary = c; emit uiColorsChanged(); saveColors(); } }
-void ThemeManager::setUiHighlightColor(const QColor &c) { if (m_uiHighlight != c) { m_uiHighlight = c; emit uiColorsChanged(); saveColors(); } }
-void ThemeManager::setUiTextColor(const QColor &c) { if (m_uiText != c) { m_uiText = c; emit uiColorsChanged(); saveColors(); } }
-void ThemeManager::setUiTitleBarLeftColor(const QColor &c) { if (m_uiTitleBarLeft != c) { m_uiTitleBarLeft = c; emit uiColorsChanged(); saveColors(); } }
-void ThemeManager::setUiTitleBarRightColor(const QColor &c) { if (m_uiTitleBarRight != c) { m_uiTitleBarRight = c; emit uiColorsChanged(); saveColors(); } }
+void ThemeManager::setUiPrimaryColor(const QColor &c) { if (m_uiPrimary != c) { m_uiPrimary = c; notifyChanged(UiColorsChange); saveColors(); } }
+void ThemeManager::setUiSecondaryColor(const QColor &c) { if (m_uiSecondary != c) { m_uiSecondary = c; notifyChanged(UiColorsChange); saveColors(); } }
+void ThemeManager::setUiTertiaryColor(const QColor &c) { if (m_uiTertiary != c) { m_uiTertiary = c; notifyChanged(UiColorsChange); saveColors(); } }
+void ThemeManager::setUiHighlightColor(const QColor &c) { if (m_uiHighlight != c) { m_uiHighlight = c; notifyChanged(UiColorsChange); saveColors(); } }
+void ThemeManager::setUiTextColor(const QColor &c) { if (m_uiText != c) { m_uiText = c; notifyChanged(UiColorsChange); saveColors(); } }
+void ThemeManager::setUiTitleBarLeftColor(const QColor &c) { if (m_uiTitleBarLeft != c) { m_uiTitleBarLeft = c; notifyChanged(UiColorsChange); saveColors(); } }
+void ThemeManager::setUiTitleBarRightColor(const QColor &c) { if (m_uiTitleBarRight != c) { m_uiTitleBarRight = c; notifyChanged(UiColorsChange); saveColors(); } }
 
 void ThemeManager::assignColorToRole(const QColor &color, const QString &roleName) {
     if (roleName == "Primary") setUiPrimaryColor(color);
@@ -211,6 +248,264 @@ void ThemeManager::assignColorToRole(const QColor &color, const QString &roleNam
     else if (roleName == "TitleBarRight") setUiTitleBarRightColor(color);
 }
 
+void ThemeManager::setSlideshowDirectory(const QString &directory) {
+    const QString local = WallpaperCache::localPath(directory);
+    if (m_slideshowDirectory != local) {
+        m_slideshowDirectory = local;
+        emit slideshowChanged();
+        saveColors();
+        updateSlideshow();
+    }
+}
+
+void ThemeManager::setSlideshowInterval(int seconds) {
+    seconds = qMax(MinSlideshowInterval, seconds);
+    if (m_slideshowInterval != seconds) {
+        m_slideshowInterval = seconds;
+        emit slideshowChanged();
+        saveColors();
+        updateSlideshow();
+    }
+}
+
+void ThemeManager::setSlideshowShuffle(bool shuffle) {
+    if (m_slideshowShuffle != shuffle) {
+        m_slideshowShuffle = shuffle;
+        emit slideshowChanged();
+        saveColors();
+        updateSlideshow();
+    }
+}
+
+void ThemeManager::setPlaySlideshow(bool play) {
+    if (m_playSlideshow != play) {
+        m_playSlideshow = play;
+        emit slideshowChanged();
+        updateSlideshow();
+    }
+}
+
+void ThemeManager::setSlideshowPaused(bool paused) {
+    if (m_slideshowPaused != paused) {
+        m_slideshowPaused = paused;
+        qInfo() << "[Theme] Slideshow" << (paused ? "paused" : "resumed");
+        emit slideshowPausedChanged();
+    }
+}
+
+qint64 ThemeManager::idleThresholdMs() const {
+    return qMax(IdleThresholdMs, qint64(m_slideshowInterval) * 1000);
+}
+
+void ThemeManager::watchScreen(QScreen *screen) {
+    connect(screen, &QScreen::geometryChanged, this, &ThemeManager::updateOutputSizes);
+    connect(screen, &QScreen::logicalDotsPerInchChanged, this, &ThemeManager::updateOutputSizes);
+}
+
+void ThemeManager::updateOutputSizes() {
+    WallpaperCache::setOutputSizes(outputSizes());
+}
+
+void ThemeManager::updateSlideshow() {
+    m_slideshowDue = false;
+    m_nextSlide = Slide();
+    m_idlePollTimer.stop();
+    setSlideshowPaused(false);
+
+    if (!m_playSlideshow || m_slideshowDirectory.isEmpty()) {
+        m_slideshowTimer.stop();
+        m_idleMonitor.reset();
+        return;
+    }
+    if (!m_idleMonitor) {
+        m_idleMonitor = std::make_unique<IdleMonitor>();
+    }
+    m_slideshowTimer.start(m_slideshowInterval * 1000);
+    prefetchNextSlide();
+}
+
+void ThemeManager::nextWallpaper() {
+    if (m_slideshowDirectory.isEmpty()) {
+        qWarning() << "[Theme] nextWallpaper() without a slideshow directory";
+        return;
+    }
+    if (m_slideshowTimer.isActive()) {
+        m_slideshowTimer.start(); // A full interval for the one shown now
+    }
+    if (m_nextSlide.path.isEmpty() && !m_slideWatcher.isRunning()) {
+        prefetchNextSlide();
+    }
+    showNextSlide();
+}
+
+void ThemeManager::prefetchNextSlide() {
+    if (m_slideWatcher.isRunning()) {
+        m_prefetchPending = true;
+        return;
+    }
+    m_nextSlide = Slide();
+
+    m_slideWatcher.setFuture(QtConcurrent::run(&ThemeManager::prefetchSlide, m_slideshowDirectory,
+                                               m_wallpaperPath, m_slideshowShuffle, outputSizes(),
+                                               m_wallpaperFillMode));
+}
+
+ThemeManager::Slide ThemeManager::prefetchSlide(const QString &directory, const QString &current,
+                                                bool shuffle, const QList<QSize> &sizes,
+                                                int fillMode) {
+    static const QStringList filters = [] {
+        QStringList patterns;
+        const QList<QByteArray> formats = QImageReader::supportedImageFormats();
+        for (const QByteArray &format : formats) {
+            patterns.append("*." + QString::fromLatin1(format));
+        }
+        return patterns;
+    }();
+
+    const QDir dir(directory);
+    const QStringList files = dir.entryList(filters, QDir::Files | QDir::Readable, QDir::Name);
+    if (files.isEmpty()) {
+        qWarning() << "[Theme] No images in slideshow directory" << directory;
+        return Slide();
+    }
+
+    const QFileInfo shown(WallpaperCache::localPath(current));
+    const int at = shown.absolutePath() == dir.absolutePath() ? files.indexOf(shown.fileName()) : -1;
+    int next = (at + 1) % files.size();
+    if (shuffle && files.size() > 1) {
+        // Anything but the one on screen
+        next = QRandomGenerator::global()->bounded(files.size() - (at >= 0 ? 1 : 0));
+        if (at >= 0 && next >= at) {
+            ++next;
+        }
+    }
+
+    // Decode and scale it ahead: the renders stay in WallpaperCache's memory
+    // (it keeps this one and the one on screen), the palette in its disk cache
+    Slide slide;
+    slide.path = dir.absoluteFilePath(files.at(next));
+    for (const QSize &size : sizes) {
+        WallpaperCache::render(slide.path, size, fillMode);
+    }
+    slide.colors = WallpaperPalette::analyze(slide.path).colors;
+    return slide;
+}
+
+void ThemeManager::onSlidePrefetched() {
+    if (m_prefetchPending) {
+        // The settings changed while this one was prepared
+        m_prefetchPending = false;
+        prefetchNextSlide();
+        return;
+    }
+    m_nextSlide = m_slideWatcher.result();
+    if (m_slideshowDue) {
+        m_slideshowDue = false;
+        showNextSlide();
+    }
+}
+
+void ThemeManager::onSlideshowTick() {
+    if (m_idleMonitor && m_idleMonitor->isIdle(idleThresholdMs())) {
+        m_slideshowTimer.stop();
+        m_idlePollTimer.start();
+        setSlideshowPaused(true);
+        return;
+    }
+    showNextSlide();
+}
+
+void ThemeManager::onIdlePoll() {
+    if (m_idleMonitor && m_idleMonitor->isIdle(idleThresholdMs())) {
+        return;
+    }
+    m_idlePollTimer.stop();
+    setSlideshowPaused(false);
+    m_slideshowTimer.start();
+}
+
+void ThemeManager::showNextSlide() {
+    if (m_nextSlide.path.isEmpty()) {
+        // Never wait for the decode here: switch when the prefetch lands
+        m_slideshowDue = m_slideWatcher.isRunning();
+        return;
+    }
+    const Slide slide = m_nextSlide;
+    m_nextSlide = Slide();
+
+    beginUpdate();
+    m_wallpaperPath = slide.path;
+    emit wallpaperPathChanged();
+    if (!slide.colors.isEmpty()) {
+        extractColors(slide.colors);
+    }
+    saveColors();
+    endUpdate();
+
+    prefetchNextSlide();
+}
+
+void ThemeManager::beginUpdate() {
+    ++m_updateDepth;
+}
+
+void ThemeManager::endUpdate() {
+    if (m_updateDepth == 0) {
+        qWarning() << "[Theme] endUpdate() without beginUpdate()";
+        return;
+    }
+    if (--m_updateDepth > 0) {
+        return;
+    }
+
+    const int changes = m_pendingChanges;
+    m_pendingChanges = 0;
+    emitChanges(changes);
+    if (m_savePending) {
+        m_savePending = false;
+        saveColors();
+    }
+}
+
+void ThemeManager::applyPalette(const QVariantMap &roles) {
+    beginUpdate();
+    for (auto it = roles.constBegin(); it != roles.constEnd(); ++it) {
+        const QColor color = it.value().value<QColor>();
+        if (color.isValid()) {
+            assignColorToRole(color, it.key());
+        } else {
+            qWarning() << "[Theme] Invalid color for role" << it.key() << it.value();
+        }
+    }
+    endUpdate();
+}
+
+void ThemeManager::notifyChanged(int changes) {
+    if (m_updateDepth > 0) {
+        m_pendingChanges |= changes;
+        return;
+    }
+    emitChanges(changes);
+}
+
+void ThemeManager::emitChanges(int changes) {
+    if (changes == 0) {
+        return;
+    }
+
+    // Bindings on the theme colors re-evaluate inside these emits; the
+    // window manager's frame redraw is queued and timed on its side
+    QElapsedTimer timer;
+    timer.start();
+    if (changes & ColorsChange) {
+        emit colorsChanged();
+    }
+    if (changes & UiColorsChange) {
+        emit uiColorsChanged();
+    }
+    qDebug() << "[Theme] Change notification took" << timer.nsecsElapsed() / 1000 << "us";
+}
+
 QString ThemeManager::getColorsFilePath() const {
     QString configDir = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) + "/canvasdesk";
     QDir dir(configDir);
@@ -219,11 +514,22 @@ QString ThemeManager::getColorsFilePath() const {
 }
 
 void ThemeManager::saveColors() {
+    if (m_updateDepth > 0) {
+        m_savePending = true;
+        return;
+    }
+
     QJsonObject root;
     root["wallpaper"] = m_wallpaperPath;
     root["fillMode"] = m_wallpaperFillMode;
     root["titleBarTextLeft"] = m_titleBarTextLeft;
 
+    QJsonObject slideshow;
+    slideshow["directory"] = m_slideshowDirectory;
+    slideshow["interval"] = m_slideshowInterval;
+    slideshow["shuffle"] = m_slideshowShuffle;
+    root["slideshow"] = slideshow;
+
     QJsonObject colors;
     colors["primary"] = m_primary.name();
     colors["secondary"] = m_secondary.name();
@@ -244,22 +550,32 @@ void ThemeManager::saveColors() {
     root["colors"] = colors;
     root["uiColors"] = uiColors;
 
-    QFile file(getColorsFilePath());
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(QJsonDocument(root).toJson());
-    }
+    // Debounced + atomic; dragging a color picker coalesces into one write
+    PersistenceService::instance()->scheduleWrite(getColorsFilePath(), QJsonDocument(root).toJson());
 }
 
 void ThemeManager::loadColors() {
-    QFile file(getColorsFilePath());
-    if (file.open(QIODevice::ReadOnly)) {
-        QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QByteArray contents;
+    if (!PersistenceService::instance()->pendingContents(getColorsFilePath(), &contents)) {
+        QFile file(getColorsFilePath());
+        if (file.open(QIODevice::ReadOnly)) {
+            contents = file.readAll();
+        }
+    }
+
+    if (!contents.isEmpty()) {
+        QJsonDocument doc = QJsonDocument::fromJson(contents);
         QJsonObject root = doc.object();
 
         m_wallpaperPath = root["wallpaper"].toString();
         m_wallpaperFillMode = root["fillMode"].toInt(1);
         m_titleBarTextLeft = root["titleBarTextLeft"].toBool(false);
 
+        const QJsonObject slideshow = root["slideshow"].toObject();
+        m_slideshowDirectory = slideshow["directory"].toString();
+        m_slideshowInterval = qMax(MinSlideshowInterval, slideshow["interval"].toInt(m_slideshowInterval));
+        m_slideshowShuffle = slideshow["shuffle"].toBool(false);
+
         QJsonObject colors = root["colors"].toObject();
         if (!colors.isEmpty()) {
             m_primary = QColor(colors["primary"].toString(m_primary.name()));
@@ -295,5 +611,7 @@ void ThemeManager::loadColors() {
         emit wallpaperPathChanged();
         emit wallpaperFillModeChanged();
         emit titleBarTextLeftChanged();
+        emit slideshowChanged();
+        updateSlideshow();
     }
 }
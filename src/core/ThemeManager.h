@@ -4,8 +4,15 @@
 #include <QObject>
 #include <QColor>
 #include <QVariantMap>
+#include <QFutureWatcher>
 #include <QImage>
 #include <QJsonObject>
+#include <QTimer>
+#include <memory>
+#include "WallpaperPalette.h"
+
+class IdleMonitor;
+class QScreen;
 
 class ThemeManager : public QObject {
     Q_OBJECT
@@ -40,8 +47,19 @@ public:
     // Settings
     Q_PROPERTY(bool titleBarTextLeft READ titleBarTextLeft WRITE setTitleBarTextLeft NOTIFY titleBarTextLeftChanged)
 
+    // Slideshow: a new wallpaper from slideshowDirectory (empty = off) every
+    // slideshowInterval seconds, in name order or shuffled
+    Q_PROPERTY(QString slideshowDirectory READ slideshowDirectory WRITE setSlideshowDirectory NOTIFY slideshowChanged)
+    Q_PROPERTY(int slideshowInterval READ slideshowInterval WRITE setSlideshowInterval NOTIFY slideshowChanged)
+    Q_PROPERTY(bool slideshowShuffle READ slideshowShuffle WRITE setSlideshowShuffle NOTIFY slideshowChanged)
+    // Only the instance that plays it changes wallpapers (the desktop runtime)
+    Q_PROPERTY(bool playSlideshow READ playSlideshow WRITE setPlaySlideshow NOTIFY slideshowChanged)
+    // Held while the screen is blanked, locked or nobody touched it for a while
+    Q_PROPERTY(bool slideshowPaused READ slideshowPaused NOTIFY slideshowPausedChanged)
+
 public:
     explicit ThemeManager(QObject *parent = nullptr);
+    ~ThemeManager() override;
 
     QString wallpaperPath() const;
     void setWallpaperPath(const QString &path);
@@ -82,25 +100,67 @@ public:
     bool titleBarTextLeft() const { return m_titleBarTextLeft; }
     void setTitleBarTextLeft(bool left);
 
+    QString slideshowDirectory() const { return m_slideshowDirectory; }
+    void setSlideshowDirectory(const QString &directory);
+
+    int slideshowInterval() const { return m_slideshowInterval; }
+    void setSlideshowInterval(int seconds);
+
+    bool slideshowShuffle() const { return m_slideshowShuffle; }
+    void setSlideshowShuffle(bool shuffle);
+
+    bool playSlideshow() const { return m_playSlideshow; }
+    void setPlaySlideshow(bool play);
+
+    bool slideshowPaused() const { return m_slideshowPaused; }
+
     QColor whiteColor() const { return QColor("#ffffff"); }
     QColor greyColor() const { return QColor("#808080"); }
     QColor blackColor() const { return QColor("#000000"); }
 
+    // Extracts the palette on a worker thread; colors change when it is done
     Q_INVOKABLE void analyzeWallpaper(const QString &path);
     Q_INVOKABLE void saveColors();
+
+    // Theme transactions: changes between beginUpdate() and the matching
+    // endUpdate() (they nest) are announced with one colorsChanged/
+    // uiColorsChanged and written with one save when the outermost ends.
+    Q_INVOKABLE void beginUpdate();
+    Q_INVOKABLE void endUpdate();
+    // Role name (as for assignColorToRole) -> color, as one transaction
+    Q_INVOKABLE void applyPalette(const QVariantMap &roles);
     Q_INVOKABLE void loadColors();
     
     // Helper to assign an extracted color to a role by name
     Q_INVOKABLE void assignColorToRole(const QColor &color, const QString &roleName);
 
+    // Skips to the next slideshow wallpaper and restarts the interval
+    Q_INVOKABLE void nextWallpaper();
+
 signals:
     void wallpaperPathChanged();
     void wallpaperFillModeChanged();
     void colorsChanged();
     void uiColorsChanged();
     void titleBarTextLeftChanged();
+    void slideshowChanged();
+    void slideshowPausedChanged();
 
 private:
+    enum Change { ColorsChange = 0x1, UiColorsChange = 0x2 };
+
+    static constexpr int MinSlideshowInterval = 10; // Seconds
+    static constexpr int IdlePollMs = 2000;
+    // Input-free time after which nobody is watching, unless the interval is
+    // longer
+    static constexpr qint64 IdleThresholdMs = 5 * 60 * 1000;
+
+    // The next slideshow wallpaper, rendered for every screen and analyzed
+    struct Slide {
+        QString path;
+        QVector<QRgb> colors;
+    };
+
     QString m_wallpaperPath;
     int m_wallpaperFillMode = 1; // PreserveAspectCrop (default)
     bool m_titleBarTextLeft = false;
@@ -122,7 +182,44 @@ private:
     QColor m_uiTitleBarLeft = "#2a2a2a";
     QColor m_uiTitleBarRight = "#3a3a3a";
 
-    void extractColors(const QImage &image);
+    // Latest request wins; one analysis runs at a time
+    QFutureWatcher<WallpaperPalette::Result> m_paletteWatcher;
+    QString m_pendingAnalysis;
+
+    QString m_slideshowDirectory;
+    int m_slideshowInterval = 300;
+    bool m_slideshowShuffle = false;
+    bool m_playSlideshow = false;
+    bool m_slideshowPaused = false;
+    // The tick came before the prefetch finished: show it when it does
+    bool m_slideshowDue = false;
+    bool m_prefetchPending = false;
+    Slide m_nextSlide;
+    QFutureWatcher<Slide> m_slideWatcher;
+    QTimer m_slideshowTimer;
+    QTimer m_idlePollTimer;
+    std::unique_ptr<IdleMonitor> m_idleMonitor;
+
+    int m_updateDepth = 0;
+    int m_pendingChanges = 0;
+    bool m_savePending = false;
+
+    void notifyChanged(int changes);
+    void emitChanges(int changes);
+    void onPaletteReady();
+    void updateSlideshow();
+    void watchScreen(QScreen *screen);
+    void updateOutputSizes();
+    void prefetchNextSlide();
+    void onSlidePrefetched();
+    void onSlideshowTick();
+    void onIdlePoll();
+    void showNextSlide();
+    void setSlideshowPaused(bool paused);
+    qint64 idleThresholdMs() const;
+    static Slide prefetchSlide(const QString &directory, const QString &current, bool shuffle,
+                               const QList<QSize> &sizes, int fillMode);
+    void extractColors(const QVector<QRgb> &candidates);
     QString getColorsFilePath() const;
 };
 
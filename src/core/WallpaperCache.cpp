@@ -0,0 +1,300 @@
+#include "WallpaperCache.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <sys/time.h>
+
+namespace {
+
+constexpr qint64 HashChunk = 64 * 1024;
+
+// Serializes writing and pruning; readers only ever see complete files
+QMutex s_cacheMutex;
+
+// One wallpaper at one fill mode, at every output size asked for
+struct Decoded {
+  QByteArray key;
+  QList<QImage> renders;
+};
+
+// Most recently used first, at most MaxDecodedWallpapers
+QMutex s_decodedMutex;
+QList<Decoded> s_decoded;
+QList<QSize> s_outputSizes; // Empty: any
+
+// Moves the entry for `key` to the front, creating it (and evicting the
+// oldest) when missing
+Decoded &touchDecoded(const QByteArray &key) {
+  for (int i = 0; i < s_decoded.size(); ++i) {
+    if (s_decoded.at(i).key == key) {
+      s_decoded.move(i, 0);
+      return s_decoded.first();
+    }
+  }
+  s_decoded.prepend({key, {}});
+  while (s_decoded.size() > WallpaperCache::MaxDecodedWallpapers)
+    s_decoded.removeLast();
+  return s_decoded.first();
+}
+
+QImage findDecoded(const QByteArray &key, const QSize &size) {
+  QMutexLocker locker(&s_decodedMutex);
+  for (const Decoded &entry : std::as_const(s_decoded)) {
+    if (entry.key != key)
+      continue;
+    for (const QImage &image : entry.renders) {
+      if (image.size() == size) {
+        QImage found = image;
+        touchDecoded(key);
+        return found;
+      }
+    }
+    break;
+  }
+  return QImage();
+}
+
+void keepDecoded(const QByteArray &key, const QImage &image) {
+  QMutexLocker locker(&s_decodedMutex);
+  if (!s_outputSizes.isEmpty() && !s_outputSizes.contains(image.size()))
+    return; // A screen that went away meanwhile
+  // Concurrent renders of one size (provider, prefetch, root background)
+  // replace each other
+  QList<QImage> &renders = touchDecoded(key).renders;
+  for (QImage &render : renders) {
+    if (render.size() == image.size()) {
+      render = image;
+      return;
+    }
+  }
+  renders.append(image);
+}
+
+QString cacheDir() {
+  return QStandardPaths::writableLocation(
+             QStandardPaths::GenericCacheLocation) +
+         "/canvasdesk/wallpapers";
+}
+
+// First offset <= 0 at which tiles of `tile` pixels, one of them centred in
+// `extent`, start
+int tileStart(int extent, int tile) {
+  int start = ((extent - tile) / 2) % tile;
+  if (start > 0)
+    start -= tile;
+  return start;
+}
+
+QImage scale(const QString &path, const QSize &size, int fillMode) {
+  using namespace WallpaperCache;
+
+  QImageReader reader(path);
+  QSize natural = reader.size();
+  QImage image;
+  if (!natural.isValid()) {
+    // The format cannot tell its size up front: decode fully
+    image = reader.read();
+    natural = image.size();
+  }
+  if (natural.isEmpty()) {
+    qWarning() << "[WallpaperCache] Cannot read" << path
+               << reader.errorString();
+    return QImage();
+  }
+
+  QSize target = natural;
+  QRect clip;
+  switch (fillMode) {
+  case Stretch:
+    target = size;
+    break;
+  case PreserveAspectFit:
+    target = natural.scaled(size, Qt::KeepAspectRatio);
+    break;
+  case PreserveAspectCrop:
+    target = natural.scaled(size, Qt::KeepAspectRatioByExpanding);
+    clip = QRect(QPoint((target.width() - size.width()) / 2,
+                        (target.height() - size.height()) / 2),
+                 size);
+    break;
+  case TileVertically:
+    target = QSize(size.width(), natural.height());
+    break;
+  case TileHorizontally:
+    target = QSize(natural.width(), size.height());
+    break;
+  case Pad:
+    // Only the centred part that fits on screen
+    if (natural.width() > size.width() || natural.height() > size.height())
+      clip = QRect(QPoint(qMax(0, (natural.width() - size.width()) / 2),
+                          qMax(0, (natural.height() - size.height()) / 2)),
+                   natural.boundedTo(size));
+    break;
+  default: // Tile
+    break;
+  }
+  target = target.expandedTo(QSize(1, 1));
+
+  if (image.isNull()) {
+    // Decoders that support it (JPEG) scale while decoding; QImageReader
+    // scales afterwards for the rest
+    if (target != natural)
+      reader.setScaledSize(target);
+    if (clip.isValid())
+      reader.setScaledClipRect(clip);
+    image = reader.read();
+  } else {
+    if (target != natural)
+      image = image.scaled(target, Qt::IgnoreAspectRatio,
+                           Qt::SmoothTransformation);
+    if (clip.isValid())
+      image = image.copy(clip);
+  }
+  if (image.isNull()) {
+    qWarning() << "[WallpaperCache] Cannot decode" << path
+               << reader.errorString();
+    return image;
+  }
+  if (image.size() == size)
+    return image.convertToFormat(QImage::Format_RGB32);
+
+  // Letterboxed, padded or tiled: compose onto a screen-sized canvas. The
+  // desktop window is black behind a wallpaper, so the bars are too.
+  QImage canvas(size, QImage::Format_RGB32);
+  canvas.fill(Qt::black);
+  QPainter painter(&canvas);
+  const bool tileX = fillMode == Tile || fillMode == TileHorizontally;
+  const bool tileY = fillMode == Tile || fillMode == TileVertically;
+  const int startX = tileX ? tileStart(size.width(), image.width())
+                           : (size.width() - image.width()) / 2;
+  const int startY = tileY ? tileStart(size.height(), image.height())
+                           : (size.height() - image.height()) / 2;
+  for (int y = startY; y < size.height(); y += image.height()) {
+    for (int x = startX; x < size.width(); x += image.width()) {
+      painter.drawImage(x, y, image);
+      if (!tileX)
+        break;
+    }
+    if (!tileY)
+      break;
+  }
+  painter.end();
+  return canvas;
+}
+
+void store(const QString &path, const QImage &image) {
+  QMutexLocker locker(&s_cacheMutex);
+  QDir dir(QFileInfo(path).absolutePath());
+  dir.mkpath(".");
+
+  // Screen-sized images: favour encode speed over size
+  QSaveFile file(path);
+  QImageWriter writer(&file, "png");
+  writer.setCompression(1);
+  if (!file.open(QIODevice::WriteOnly) || !writer.write(image) ||
+      !file.commit()) {
+    qWarning() << "[WallpaperCache] Failed to cache" << path << ":"
+               << writer.errorString();
+    return;
+  }
+
+  // Least recently used first out; hits touch their file's mtime
+  const QFileInfoList files =
+      dir.entryInfoList({"*.png"}, QDir::Files, QDir::Time);
+  for (int i = WallpaperCache::MaxCachedFiles; i < files.size(); ++i)
+    QFile::remove(files.at(i).absoluteFilePath());
+}
+
+} // namespace
+
+namespace WallpaperCache {
+
+QString localPath(const QString &pathOrUrl) {
+  if (pathOrUrl.startsWith("file://"))
+    return pathOrUrl.mid(7);
+  return pathOrUrl;
+}
+
+QByteArray fileHash(const QString &path) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly))
+    return {};
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  const qint64 size = file.size();
+  hash.addData(QByteArray::number(size));
+  hash.addData(file.read(HashChunk));
+  if (size > 2 * HashChunk && file.seek(size - HashChunk))
+    hash.addData(file.read(HashChunk));
+  return hash.result().toHex();
+}
+
+void setOutputSizes(const QList<QSize> &sizes) {
+  QMutexLocker locker(&s_decodedMutex);
+  s_outputSizes = sizes;
+  if (sizes.isEmpty())
+    return;
+  for (Decoded &entry : s_decoded) {
+    entry.renders.removeIf(
+        [&](const QImage &image) { return !sizes.contains(image.size()); });
+  }
+}
+
+QImage render(const QString &pathOrUrl, const QSize &size, int fillMode) {
+  const QString path = localPath(pathOrUrl);
+  if (path.isEmpty() || size.isEmpty())
+    return QImage();
+
+  QElapsedTimer timer;
+  timer.start();
+
+  const QByteArray source = fileHash(path);
+  if (source.isEmpty()) {
+    qWarning() << "[WallpaperCache] Cannot open" << path;
+    return QImage();
+  }
+  const QByteArray decodedKey = source + "/" + QByteArray::number(fillMode);
+  QImage image = findDecoded(decodedKey, size);
+  if (!image.isNull())
+    return image;
+
+  QCryptographicHash key(QCryptographicHash::Sha1);
+  key.addData(source);
+  key.addData(QStringLiteral("/%1x%2/%3")
+                  .arg(size.width())
+                  .arg(size.height())
+                  .arg(fillMode)
+                  .toLatin1());
+  const QString cachePath =
+      cacheDir() + "/" + QString::fromLatin1(key.result().toHex()) + ".png";
+
+  image = QImageReader(cachePath, "png").read();
+  if (image.size() == size) {
+    ::utimes(QFile::encodeName(cachePath).constData(), nullptr);
+    image = image.convertToFormat(QImage::Format_RGB32);
+    keepDecoded(decodedKey, image);
+    return image;
+  }
+
+  image = scale(path, size, fillMode);
+  if (image.isNull())
+    return image;
+  store(cachePath, image);
+  keepDecoded(decodedKey, image);
+
+  qDebug() << "[WallpaperCache] Rendered" << path << size << "mode"
+           << fillMode << "in" << timer.elapsed() << "ms";
+  return image;
+}
+
+} // namespace WallpaperCache
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QList>
+#include <QSize>
+#include <QString>
+
+// Wallpapers rendered once per output size.
+//
+// render() produces the image exactly as a QML Image of `size` with the given
+// fillMode (Image.FillMode values) would show it, decoding the file at the
+// smallest size that covers the output (QImageReader scaled size and clip
+// rect), so the result costs one screen's worth of pixels. Results are kept
+// as PNGs under $XDG_CACHE_HOME/canvasdesk/wallpapers, keyed by a hash of the
+// source file, the size and the fill mode; the most recent MaxCachedFiles are
+// kept. The renders of the MaxDecodedWallpapers most recently used
+// wallpapers (per fill mode, one per output size) also stay decoded in
+// memory: the one on screen and the slideshow's next one, which are then
+// served without decoding. QImage sharing means the images handed out are not
+// copies. Blocking and thread-safe: call it from a worker thread.
+namespace WallpaperCache {
+
+constexpr int MaxCachedFiles = 12;
+constexpr int MaxDecodedWallpapers = 2;
+
+// Same numbering as QML's Image.FillMode
+enum FillMode {
+  Stretch,
+  PreserveAspectFit,
+  PreserveAspectCrop,
+  Tile,
+  TileVertically,
+  TileHorizontally,
+  Pad
+};
+
+QImage render(const QString &path, const QSize &size, int fillMode);
+
+// Pixel sizes of the current outputs. Only renders of these sizes are kept
+// in memory; the others are dropped now and not kept later. Empty (the
+// default) keeps every size.
+void setOutputSizes(const QList<QSize> &sizes);
+
+// Content key of a file: its size plus the first and last 64 KiB, so large
+// images are told apart without being read in full. Empty if unreadable.
+QByteArray fileHash(const QString &path);
+
+// "file://" URLs and plain paths to a local path
+QString localPath(const QString &pathOrUrl);
+
+} // namespace WallpaperCache
@@ -0,0 +1,264 @@
+#include "WallpaperPalette.h"
+#include "WallpaperCache.h"
+#include <QColor>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+constexpr int Bits = 5; // Per channel
+constexpr int Side = 1 << Bits;
+constexpr int Bins = Side * Side * Side;
+
+int binIndex(int r, int g, int b) {
+  return (r << 2 * Bits) | (g << Bits) | b;
+}
+
+// Axis-aligned box of histogram bins, bounds inclusive
+struct Box {
+  int lo[3];
+  int hi[3];
+  quint64 count = 0;
+
+  int length(int axis) const { return hi[axis] - lo[axis] + 1; }
+  quint64 volume() const {
+    return quint64(length(0)) * length(1) * length(2);
+  }
+};
+
+template <typename Visit>
+void forEachBin(const Box &box, Visit visit) {
+  for (int r = box.lo[0]; r <= box.hi[0]; ++r)
+    for (int g = box.lo[1]; g <= box.hi[1]; ++g)
+      for (int b = box.lo[2]; b <= box.hi[2]; ++b)
+        visit(r, g, b);
+}
+
+// Shrinks `box` to its non-empty bins and counts them
+void fit(Box &box, const std::vector<quint32> &histogram) {
+  Box fitted = {{Side, Side, Side}, {-1, -1, -1}, 0};
+  forEachBin(box, [&](int r, int g, int b) {
+    const quint32 n = histogram[binIndex(r, g, b)];
+    if (n == 0)
+      return;
+    const int at[3] = {r, g, b};
+    for (int axis = 0; axis < 3; ++axis) {
+      fitted.lo[axis] = std::min(fitted.lo[axis], at[axis]);
+      fitted.hi[axis] = std::max(fitted.hi[axis], at[axis]);
+    }
+    fitted.count += n;
+  });
+  box = fitted;
+}
+
+// Splits along the longest side at the population median; false when the
+// box is a single bin
+bool split(const Box &box, const std::vector<quint32> &histogram, Box *first,
+           Box *second) {
+  int axis = 0;
+  for (int i = 1; i < 3; ++i) {
+    if (box.length(i) > box.length(axis))
+      axis = i;
+  }
+  if (box.length(axis) < 2)
+    return false;
+
+  quint64 slices[Side] = {};
+  forEachBin(box, [&](int r, int g, int b) {
+    const int at[3] = {r, g, b};
+    slices[at[axis]] += histogram[binIndex(r, g, b)];
+  });
+
+  // Last slice of the first half; never the box's last slice
+  int cut = box.lo[axis];
+  quint64 sum = slices[cut];
+  while (cut < box.hi[axis] - 1 && sum < box.count / 2)
+    sum += slices[++cut];
+
+  *first = box;
+  *second = box;
+  first->hi[axis] = cut;
+  second->lo[axis] = cut + 1;
+  fit(*first, histogram);
+  fit(*second, histogram);
+  return true;
+}
+
+QRgb average(const Box &box, const std::vector<quint32> &histogram) {
+  quint64 sum[3] = {};
+  forEachBin(box, [&](int r, int g, int b) {
+    const quint32 n = histogram[binIndex(r, g, b)];
+    sum[0] += n * r;
+    sum[1] += n * g;
+    sum[2] += n * b;
+  });
+  // Bin centre back to 8 bits
+  const int shift = 8 - Bits;
+  auto channel = [&](int axis) {
+    return int((sum[axis] << shift) / box.count) + (1 << (shift - 1));
+  };
+  return qRgb(channel(0), channel(1), channel(2));
+}
+
+QByteArray paletteKey(const QString &path) {
+  const QByteArray source = WallpaperCache::fileHash(path);
+  if (source.isEmpty())
+    return source;
+  // Part of the key so a change to the quantizer invalidates old entries
+  return QCryptographicHash::hash(source + "/mediancut-1",
+                                  QCryptographicHash::Sha1)
+      .toHex();
+}
+
+QString cacheFile(const QByteArray &hash) {
+  return QStandardPaths::writableLocation(
+             QStandardPaths::GenericCacheLocation) +
+         "/canvasdesk/palettes/" + QString::fromLatin1(hash) + ".json";
+}
+
+bool loadCached(const QString &path, QVector<QRgb> *colors) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly))
+    return false;
+  const QJsonArray array =
+      QJsonDocument::fromJson(file.readAll()).object()["colors"].toArray();
+  for (const QJsonValue &value : array) {
+    const QColor color(value.toString());
+    if (color.isValid())
+      colors->append(color.rgb());
+  }
+  return !colors->isEmpty();
+}
+
+void saveCached(const QString &path, const QVector<QRgb> &colors) {
+  QJsonArray array;
+  for (QRgb color : colors)
+    array.append(QColor(color).name());
+  QJsonObject root;
+  root["colors"] = array;
+
+  QDir().mkpath(QFileInfo(path).absolutePath());
+  QSaveFile file(path);
+  if (file.open(QIODevice::WriteOnly)) {
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    file.commit();
+  }
+}
+
+QImage decodeReduced(const QString &path) {
+  QImageReader reader(path);
+  const QSize size = reader.size();
+  if (size.isValid() &&
+      (size.width() > AnalysisSize || size.height() > AnalysisSize))
+    reader.setScaledSize(
+        size.scaled(AnalysisSize, AnalysisSize, Qt::KeepAspectRatio));
+  QImage image = reader.read();
+  if (image.isNull()) {
+    qWarning() << "[WallpaperPalette] Cannot decode" << path
+               << reader.errorString();
+    return image;
+  }
+  // Formats that cannot scale while decoding arrive at full size
+  if (image.width() > AnalysisSize || image.height() > AnalysisSize)
+    image = image.scaled(AnalysisSize, AnalysisSize, Qt::KeepAspectRatio,
+                         Qt::FastTransformation);
+  return image;
+}
+
+} // namespace
+
+namespace WallpaperPalette {
+
+QVector<QRgb> extract(const QImage &source, int maxColors) {
+  const QImage image = source.format() == QImage::Format_RGB32 ||
+                               source.format() == QImage::Format_ARGB32
+                           ? source
+                           : source.convertToFormat(QImage::Format_RGB32);
+
+  // Top 5 bits of each channel straight from the 0xAARRGGBB word
+  std::vector<quint32> histogram(Bins, 0);
+  for (int y = 0; y < image.height(); ++y) {
+    const QRgb *line = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+    for (int x = 0; x < image.width(); ++x) {
+      const QRgb p = line[x];
+      ++histogram[((p >> 9) & 0x7c00) | ((p >> 6) & 0x3e0) |
+                  ((p >> 3) & 0x1f)];
+    }
+  }
+
+  Box whole = {{0, 0, 0}, {Side - 1, Side - 1, Side - 1}, 0};
+  fit(whole, histogram);
+  if (whole.count == 0)
+    return {};
+
+  // The first splits go to the most populous boxes, the rest to the ones
+  // that are both large and populous, so small but distinct regions (an
+  // accent colour) still get a box of their own
+  std::vector<Box> boxes{whole};
+  const int byCount = std::max(1, maxColors * 3 / 4);
+  while (int(boxes.size()) < maxColors) {
+    const bool weighVolume = int(boxes.size()) >= byCount;
+    auto priority = [weighVolume](const Box &box) {
+      return weighVolume ? box.count * box.volume() : box.count;
+    };
+    // Largest splittable box
+    int pick = -1;
+    for (int i = 0; i < int(boxes.size()); ++i) {
+      if (boxes[i].volume() > 1 &&
+          (pick < 0 || priority(boxes[i]) > priority(boxes[pick])))
+        pick = i;
+    }
+    Box first, second;
+    if (pick < 0 || !split(boxes[pick], histogram, &first, &second))
+      break;
+    boxes[pick] = first;
+    boxes.push_back(second);
+  }
+
+  std::sort(boxes.begin(), boxes.end(),
+            [](const Box &a, const Box &b) { return a.count > b.count; });
+  QVector<QRgb> colors;
+  colors.reserve(int(boxes.size()));
+  for (const Box &box : boxes)
+    colors.append(average(box, histogram));
+  return colors;
+}
+
+Result analyze(const QString &path) {
+  QElapsedTimer timer;
+  timer.start();
+
+  Result result;
+  result.path = path;
+  const QByteArray hash = paletteKey(path);
+  const QString cached = hash.isEmpty() ? QString() : cacheFile(hash);
+  if (!cached.isEmpty() && loadCached(cached, &result.colors)) {
+    result.cached = true;
+    return result;
+  }
+
+  const QImage image = decodeReduced(path);
+  if (image.isNull())
+    return result;
+  result.colors = extract(image);
+  if (!cached.isEmpty() && !result.colors.isEmpty())
+    saveCached(cached, result.colors);
+
+  qDebug() << "[WallpaperPalette]" << result.colors.size() << "colours from"
+           << path << "in" << timer.elapsed() << "ms";
+  return result;
+}
+
+} // namespace WallpaperPalette
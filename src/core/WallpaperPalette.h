@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QString>
+#include <QVector>
+
+// Dominant colours of a wallpaper.
+//
+// analyze() is blocking and meant for a worker thread: it decodes the image
+// at a reduced size (JPEG and friends scale while decoding, so a 6K file never
+// exists at full resolution), counts pixels into a flat 32x32x32 histogram and
+// quantizes it with median cut. Results are cached on disk by a hash of the
+// file contents, so picking the same wallpaper again skips decoding.
+namespace WallpaperPalette {
+
+constexpr int MaxColors = 16;
+constexpr int AnalysisSize = 256; // Longest side decoded, in pixels
+
+struct Result {
+  QString path;
+  // Most common first, possibly with near-duplicates of a large region;
+  // empty when decoding failed
+  QVector<QRgb> colors;
+  bool cached = false;
+};
+
+Result analyze(const QString &path);
+
+// Median cut over `image`; any format, converted to RGB32 if needed
+QVector<QRgb> extract(const QImage &image, int maxColors = MaxColors);
+
+} // namespace WallpaperPalette
@@ -0,0 +1,66 @@
+#include "WallpaperProvider.h"
+#include "WallpaperCache.h"
+#include <QAtomicInt>
+#include <QDebug>
+#include <QRunnable>
+#include <QUrl>
+
+namespace {
+
+class WallpaperResponse : public QQuickImageResponse, public QRunnable {
+public:
+  WallpaperResponse(const QString &path, const QSize &size, int fillMode)
+      : m_path(path), m_size(size), m_fillMode(fillMode) {
+    setAutoDelete(false); // Owned by the engine, which deletes it on finished
+  }
+
+  void run() override {
+    if (!m_cancelled.loadRelaxed())
+      m_image = WallpaperCache::render(m_path, m_size, m_fillMode);
+    emit finished();
+  }
+
+  void cancel() override { m_cancelled.storeRelaxed(1); }
+
+  QQuickTextureFactory *textureFactory() const override {
+    return QQuickTextureFactory::textureFactoryForImage(m_image);
+  }
+
+  QString errorString() const override {
+    return m_image.isNull() ? QStringLiteral("Cannot render wallpaper")
+                            : QString();
+  }
+
+private:
+  QString m_path;
+  QSize m_size;
+  int m_fillMode;
+  QImage m_image;
+  QAtomicInt m_cancelled;
+};
+
+} // namespace
+
+WallpaperProvider::WallpaperProvider() {
+  m_pool.setObjectName("CanvasDeskWallpaper");
+  m_pool.setMaxThreadCount(2);
+}
+
+WallpaperProvider::~WallpaperProvider() {
+  m_pool.clear();
+  m_pool.waitForDone();
+}
+
+QQuickImageResponse *
+WallpaperProvider::requestImageResponse(const QString &id,
+                                        const QSize &requestedSize) {
+  const int slash = id.indexOf('/');
+  const int fillMode = id.left(slash).toInt();
+  const QString path = QUrl::fromPercentEncoding(id.mid(slash + 1).toUtf8());
+  if (!requestedSize.isValid() || requestedSize.isEmpty())
+    qWarning() << "[WallpaperProvider] No sourceSize for" << path;
+
+  auto *response = new WallpaperResponse(path, requestedSize, fillMode);
+  m_pool.start(response);
+  return response;
+}
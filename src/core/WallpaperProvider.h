@@ -0,0 +1,21 @@
+#pragma once
+
+#include <QQuickAsyncImageProvider>
+#include <QThreadPool>
+
+// image://wallpaper/<fill mode>/<percent-encoded path or file:// URL>
+//
+// Serves WallpaperCache renders at exactly the requested size (the Image's
+// sourceSize, one screen), so QML never holds or scales the full-resolution
+// file. Rendering and cache reads run on a dedicated pool.
+class WallpaperProvider : public QQuickAsyncImageProvider {
+public:
+  WallpaperProvider();
+  ~WallpaperProvider() override;
+
+  QQuickImageResponse *requestImageResponse(const QString &id,
+                                            const QSize &requestedSize) override;
+
+private:
+  QThreadPool m_pool;
+};
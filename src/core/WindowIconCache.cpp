@@ -0,0 +1,99 @@
+#include "WindowIconCache.h"
+#include <QMutexLocker>
+#include <algorithm>
+
+WindowIconCache *WindowIconCache::instance() {
+  static WindowIconCache s_instance;
+  return &s_instance;
+}
+
+QList<QImage> WindowIconCache::decode(const unsigned long *data,
+                                      unsigned long count) {
+  QList<QImage> icons;
+  unsigned long idx = 0;
+  while (idx + 2 <= count) {
+    const unsigned long w = data[idx];
+    const unsigned long h = data[idx + 1];
+    idx += 2;
+    if (w == 0 || h == 0 || w > 1024 || h > 1024 || w * h > count - idx)
+      break;
+
+    // Longs hold one 32-bit ARGB (non-premultiplied) pixel each
+    QImage image(int(w), int(h), QImage::Format_ARGB32);
+    for (unsigned long y = 0; y < h; ++y) {
+      auto *line = reinterpret_cast<QRgb *>(image.scanLine(int(y)));
+      const unsigned long *src = data + idx + y * w;
+      for (unsigned long x = 0; x < w; ++x)
+        line[x] = QRgb(src[x] & 0xFFFFFFFF);
+    }
+    icons.append(image.convertToFormat(QImage::Format_ARGB32_Premultiplied));
+    idx += w * h;
+  }
+
+  std::sort(icons.begin(), icons.end(), [](const QImage &a, const QImage &b) {
+    return qint64(a.width()) * a.height() < qint64(b.width()) * b.height();
+  });
+  return icons;
+}
+
+quint32 WindowIconCache::setIcons(quint64 window, const QList<QImage> &icons) {
+  QMutexLocker locker(&m_mutex);
+  if (icons.isEmpty()) {
+    m_entries.remove(window);
+    return 0;
+  }
+
+  Entry &entry = m_entries[window];
+  entry.images = icons;
+  entry.scaled.clear();
+  entry.serial = ++m_nextSerial;
+  return entry.serial;
+}
+
+void WindowIconCache::remove(quint64 window) {
+  QMutexLocker locker(&m_mutex);
+  m_entries.remove(window);
+}
+
+quint32 WindowIconCache::serial(quint64 window) const {
+  QMutexLocker locker(&m_mutex);
+  auto it = m_entries.constFind(window);
+  return it == m_entries.cend() ? 0 : it->serial;
+}
+
+QString WindowIconCache::url(quint64 window) const {
+  const quint32 s = serial(window);
+  if (s == 0)
+    return QString();
+  return QStringLiteral("image://window/%1/%2").arg(window).arg(s);
+}
+
+QImage WindowIconCache::icon(quint64 window, const QSize &size) const {
+  QMutexLocker locker(&m_mutex);
+  auto it = m_entries.constFind(window);
+  if (it == m_entries.cend() || it->images.isEmpty())
+    return QImage();
+
+  if (!size.isValid() || size.isEmpty())
+    return it->images.last();
+
+  const quint64 key = (quint64(size.width()) << 32) | quint64(size.height());
+  auto scaled = it->scaled.constFind(key);
+  if (scaled != it->scaled.cend())
+    return *scaled;
+
+  const QImage *best = &it->images.last();
+  for (const QImage &image : it->images) {
+    if (image.width() >= size.width() && image.height() >= size.height()) {
+      best = &image;
+      break;
+    }
+  }
+
+  QImage result = best->size() == size
+                      ? *best
+                      : best->scaled(size, Qt::KeepAspectRatio,
+                                     Qt::SmoothTransformation);
+  it->scaled.insert(key, result);
+  return result;
+}
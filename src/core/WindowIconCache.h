@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QSize>
+
+// Decoded _NET_WM_ICON images per client window, shared by the titlebar
+// (X11WindowManager) and QML (image://window/, see WindowIconProvider).
+//
+// The window manager fetches a window's icon once when it is mapped and again
+// only when _NET_WM_ICON changes. Every update gets a new serial, which is
+// part of the image URL so QML's pixmap cache never serves a stale icon.
+//
+// Written on the GUI thread, read from QML's image loader thread.
+class WindowIconCache {
+public:
+  static WindowIconCache *instance();
+
+  // _NET_WM_ICON is a list of (width, height, width*height ARGB pixels);
+  // format-32 properties arrive as longs. Malformed trailing data is ignored.
+  static QList<QImage> decode(const unsigned long *data, unsigned long count);
+
+  // Returns the new serial, or 0 if `icons` is empty (entry removed)
+  quint32 setIcons(quint64 window, const QList<QImage> &icons);
+  void remove(quint64 window);
+
+  quint32 serial(quint64 window) const; // 0 = no icon
+  QString url(quint64 window) const;    // Empty if there is no icon
+
+  // Smallest icon covering `size`, scaled down smoothly (largest icon if the
+  // size is invalid). Scaled results are kept until the icon changes.
+  QImage icon(quint64 window, const QSize &size) const;
+
+private:
+  struct Entry {
+    QList<QImage> images; // Ascending by area
+    quint32 serial = 0;
+    mutable QHash<quint64, QImage> scaled; // Keyed by (width << 32 | height)
+  };
+
+  mutable QMutex m_mutex;
+  QHash<quint64, Entry> m_entries;
+  quint32 m_nextSerial = 0;
+};
@@ -0,0 +1,20 @@
+#include "WindowIconProvider.h"
+#include "WindowIconCache.h"
+
+QImage WindowIconProvider::requestImage(const QString &id, QSize *size,
+                                        const QSize &requestedSize) {
+  bool ok = false;
+  const quint64 window = id.section('/', 0, 0).toULongLong(&ok);
+
+  QSize target = requestedSize;
+  if (target.width() <= 0)
+    target.setWidth(target.height());
+  if (target.height() <= 0)
+    target.setHeight(target.width());
+
+  QImage image = ok ? WindowIconCache::instance()->icon(window, target)
+                    : QImage();
+  if (size)
+    *size = image.size();
+  return image;
+}
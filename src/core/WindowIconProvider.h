@@ -0,0 +1,15 @@
+#pragma once
+
+#include <QQuickImageProvider>
+
+// image://window/<window id>/<serial> -- a client window's own icon
+// (_NET_WM_ICON) from WindowIconCache. The serial only busts QML's cache; any
+// value returns the current icon. Lookups are in-memory, so this stays a
+// plain (synchronous) provider.
+class WindowIconProvider : public QQuickImageProvider {
+public:
+  WindowIconProvider() : QQuickImageProvider(QQuickImageProvider::Image) {}
+
+  QImage requestImage(const QString &id, QSize *size,
+                      const QSize &requestedSize) override;
+};
@@ -1,5 +1,6 @@
 #include "WindowManager.h"
 #include "MonitorManager.h"
+#include "WindowIconCache.h"
 #include "X11WindowManager.h"
 #include <QDebug>
 
@@ -63,7 +64,15 @@ QVariantList WindowManager::windows() const {
     win["id"] = (qulonglong)x11Window->window;
     win["title"] = x11Window->title;
     win["appId"] = x11Window->appId;
-    win["icon"] = x11Window->appId; // Use appId as icon name
+    win["icon"] = x11Window->appId; // Theme icon name guess
+
+    // The window's own icon if it has one, else the theme icon for its class
+    QString iconSource = WindowIconCache::instance()->url(x11Window->window);
+    if (iconSource.isEmpty() && !x11Window->appId.isEmpty())
+      iconSource = "image://theme/" + x11Window->appId;
+    else if (iconSource.isEmpty())
+      iconSource = "image://theme/application-x-executable";
+    win["iconSource"] = iconSource;
 
     // Check if this is the active window
     bool isActive =
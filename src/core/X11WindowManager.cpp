@@ -1,7 +1,13 @@
 #include "X11WindowManager.h"
+#include "StartupTracker.h"
 #include "ThemeManager.h"
+#include "WallpaperCache.h"
+#include "WindowIconCache.h"
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QPainter>
 #include <QSet>
+#include <QtConcurrent/QtConcurrentRun>
 // #include <QTimer>  // DISABLED: Compositing disabled for now
 #include <X11/Xatom.h>
 #include <X11/Xutil.h>
@@ -67,6 +73,11 @@ bool X11WindowManager::initialize() {
   // Restore default error handler
   XSetErrorHandler(nullptr);
 
+  // Startup notification messages are broadcast to the root window
+  m_netStartupInfoBegin = XInternAtom(m_display, "_NET_STARTUP_INFO_BEGIN", 0);
+  m_netStartupInfo = XInternAtom(m_display, "_NET_STARTUP_INFO", 0);
+  m_netWmIcon = XInternAtom(m_display, "_NET_WM_ICON", 0);
+
   qInfo() << "[X11] Successfully registered as window manager";
 
   // Create resize cursors
@@ -80,8 +91,16 @@ bool X11WindowManager::initialize() {
   // Connect to ThemeManager for color updates
   if (auto theme = ThemeManager::instance()) {
     connect(theme, &ThemeManager::uiColorsChanged, this,
-            &X11WindowManager::updateThemeColors);
+            &X11WindowManager::scheduleThemeUpdate);
+    connect(theme, &ThemeManager::wallpaperPathChanged, this,
+            &X11WindowManager::scheduleRootBackground);
+    connect(theme, &ThemeManager::wallpaperFillModeChanged, this,
+            &X11WindowManager::scheduleRootBackground);
   }
+  connect(this, &X11WindowManager::monitorsChanged, this,
+          &X11WindowManager::scheduleRootBackground);
+  connect(&m_backgroundWatcher, &QFutureWatcherBase::finished, this,
+          &X11WindowManager::publishRootBackground);
 
   // DISABLED: Compositing disabled for now
   // // Initialize Extensions
@@ -195,13 +214,24 @@ void X11WindowManager::processXEvents() {
     case MotionNotify:
       handleMotionNotify(&event.xmotion);
       break;
+    case ClientMessage:
+      handleClientMessage(&event.xclient);
+      break;
     case PropertyNotify:
       // Handle Dock/Strut changes
       handlePropertyNotify(&event.xproperty);
 
       // Window property changed (title, etc.)
       if (m_windows.contains(event.xproperty.window)) {
-        updateWindowProperties(m_windows[event.xproperty.window]);
+        X11Window *window = m_windows[event.xproperty.window];
+        if (event.xproperty.atom == m_netWmIcon) {
+          fetchWindowIcon(window->window);
+          if (window->frame) {
+            loadWindowIcon(window->frame, window->window);
+            drawTitleBar(window->frame);
+          }
+        }
+        updateWindowProperties(window);
       }
       break;
     case Expose:
@@ -340,9 +370,13 @@ void X11WindowManager::handleMapRequest(XMapRequestEvent *event) {
   window->mapped = true;
   window->workspace = m_currentWorkspace;
 
-  // Get window properties (title, class)
+  // Get window properties (title, class) and the icon, once per window
+  fetchWindowIcon(w);
   updateWindowProperties(window);
 
+  // Match against pending launches (busy feedback, launch latency)
+  reportStartup(w, window->appId);
+
   // Skip CanvasDesk's own desktop window - don't frame it
   if (window->appId.toLower() == "canvasdesk") {
     qInfo() << "[X11] Skipping frame for CanvasDesk desktop window";
@@ -481,6 +515,7 @@ void X11WindowManager::handleDestroyNotify(XDestroyWindowEvent *event) {
   qInfo() << "[X11] Window destroyed (DestroyNotify):" << w;
 
   auto *window = m_windows.take(w);
+  WindowIconCache::instance()->remove(w);
 
   // Destroy associated frame if it exists
   if (window->frame) {
@@ -540,11 +575,96 @@ void X11WindowManager::updateWindowProperties(X11Window *win) {
   emit windowChanged(win);
 }
 
+QByteArray X11WindowManager::readStringProperty(Window w, Atom property) {
+  Atom actualType;
+  int actualFormat;
+  unsigned long nitems, bytesAfter;
+  unsigned char *data = nullptr;
+
+  QByteArray value;
+  if (XGetWindowProperty(m_display, w, property, 0, 1024, 0, AnyPropertyType,
+                         &actualType, &actualFormat, &nitems, &bytesAfter,
+                         &data) == Success &&
+      data) {
+    if (actualFormat == 8)
+      value = QByteArray(reinterpret_cast<const char *>(data), int(nitems));
+    XFree(data);
+  }
+  return value;
+}
+
+void X11WindowManager::reportStartup(Window w, const QString &appId) {
+  Atom netStartupId = XInternAtom(m_display, "_NET_STARTUP_ID", 0);
+  Atom netWmPid = XInternAtom(m_display, "_NET_WM_PID", 0);
+
+  // _NET_STARTUP_ID is on the window or on its group leader
+  QByteArray startupId = readStringProperty(w, netStartupId);
+  if (startupId.isEmpty()) {
+    if (XWMHints *hints = XGetWMHints(m_display, w)) {
+      if ((hints->flags & WindowGroupHint) && hints->window_group != w)
+        startupId = readStringProperty(hints->window_group, netStartupId);
+      XFree(hints);
+    }
+  }
+
+  qint64 pid = 0;
+  Atom actualType;
+  int actualFormat;
+  unsigned long nitems, bytesAfter;
+  unsigned char *data = nullptr;
+  if (XGetWindowProperty(m_display, w, netWmPid, 0, 1, 0, XA_CARDINAL,
+                         &actualType, &actualFormat, &nitems, &bytesAfter,
+                         &data) == Success &&
+      data) {
+    if (actualFormat == 32 && nitems == 1)
+      pid = qint64(*reinterpret_cast<unsigned long *>(data));
+    XFree(data);
+  }
+
+  StartupTracker::instance()->windowMapped(QString::fromUtf8(startupId), pid,
+                                           appId);
+}
+
+void X11WindowManager::handleClientMessage(XClientMessageEvent *event) {
+  if (event->message_type != m_netStartupInfoBegin &&
+      event->message_type != m_netStartupInfo)
+    return;
+  if (event->format != 8)
+    return;
+
+  QByteArray &buffer = m_startupMessages[event->window];
+  if (event->message_type == m_netStartupInfoBegin)
+    buffer.clear();
+
+  // Up to 20 bytes per message; a NUL terminates the whole string
+  const char *bytes = event->data.b;
+  const int length = int(qstrnlen(bytes, 20));
+  buffer.append(bytes, length);
+  if (length == 20 && buffer.size() < 4096)
+    return;
+
+  const QString message = QString::fromUtf8(buffer);
+  m_startupMessages.remove(event->window);
+  StartupTracker::instance()->handleStartupMessage(message);
+}
+
+void X11WindowManager::scheduleThemeUpdate() {
+  if (m_themeUpdatePending)
+    return;
+  m_themeUpdatePending = true;
+  QMetaObject::invokeMethod(this, &X11WindowManager::updateThemeColors,
+                            Qt::QueuedConnection);
+}
+
 void X11WindowManager::updateThemeColors() {
+  m_themeUpdatePending = false;
   auto theme = ThemeManager::instance();
   if (!theme)
     return;
 
+  QElapsedTimer timer;
+  timer.start();
+
   unsigned long frameBg = theme->uiSecondaryColor().rgb() & 0xFFFFFF;
   unsigned long textColor = theme->uiTextColor().rgb() & 0xFFFFFF;
 
@@ -563,11 +683,16 @@ void X11WindowManager::updateThemeColors() {
     // Update Text Color in GC
     XSetForeground(m_display, frame->gc, textColor);
 
+    // Icons are blended onto the titlebar color; re-render from the cache
+    loadWindowIcon(frame, frame->client);
+
     // Redraw TitleBar (Gradient + Text + Buttons)
     drawTitleBar(frame);
   }
 
   XFlush(m_display);
+  qDebug() << "[X11] Theme redraw of" << processedFrames.size() << "frames in"
+           << timer.nsecsElapsed() / 1000 << "us";
 }
 
 // ========== Frame Management Functions ==========
@@ -677,6 +802,7 @@ X11Frame *X11WindowManager::createFrame(Window client, int x, int y, int width,
   renderColor.alpha = 0xFFFF;
   XftColorAllocValue(m_display, visual, colormap, &renderColor,
                      &frame->xftTextColor);
+  frame->xftTextRgb = textColor;
 
   // Select events we care about
   XSelectInput(
@@ -823,9 +949,12 @@ void X11WindowManager::drawTitleBarText(X11Frame *frame, const QString &title) {
   // Note: We do NOT clear the window here because it would erase the gradient
   // background. The background is handled by drawTitleBar().
 
-  // Update Xft text color if theme changed
-  if (auto theme = ThemeManager::instance()) {
-    unsigned long textColor = theme->uiTextColor().rgb() & 0xFFFFFF;
+  // Update Xft text color if theme changed; exposes redraw with the
+  // color already allocated
+  auto theme = ThemeManager::instance();
+  const unsigned long textColor =
+      theme ? theme->uiTextColor().rgb() & 0xFFFFFF : frame->xftTextRgb;
+  if (textColor != frame->xftTextRgb) {
     int screen = DefaultScreen(m_display);
     Visual *visual = DefaultVisual(m_display, screen);
     Colormap colormap = DefaultColormap(m_display, screen);
@@ -839,6 +968,7 @@ void X11WindowManager::drawTitleBarText(X11Frame *frame, const QString &title) {
     renderColor.alpha = 0xFFFF;
     XftColorAllocValue(m_display, visual, colormap, &renderColor,
                        &frame->xftTextColor);
+    frame->xftTextRgb = textColor;
   }
 
   // Convert QString to UTF-8 for Xft
@@ -1006,8 +1136,28 @@ void X11WindowManager::drawTitleBarButton(X11Frame *frame,
   XFreeGC(m_display, buttonGC);
 }
 
+void X11WindowManager::fetchWindowIcon(Window client) {
+  Atom actualType;
+  int actualFormat;
+  unsigned long nItems, bytesAfter;
+  unsigned char *data = nullptr;
+
+  QList<QImage> icons;
+  if (XGetWindowProperty(m_display, client, m_netWmIcon, 0, LONG_MAX, 0,
+                         XA_CARDINAL, &actualType, &actualFormat, &nItems,
+                         &bytesAfter, &data) == Success &&
+      data) {
+    if (actualFormat == 32)
+      icons = WindowIconCache::decode(
+          reinterpret_cast<const unsigned long *>(data), nItems);
+    XFree(data);
+  }
+
+  WindowIconCache::instance()->setIcons(client, icons);
+}
+
 void X11WindowManager::loadWindowIcon(X11Frame *frame, Window client) {
-  if (!frame || !m_display)
+  if (!frame || !m_display || frame->isDock)
     return;
 
   // Clean up old icon if it exists
@@ -1018,70 +1168,27 @@ void X11WindowManager::loadWindowIcon(X11Frame *frame, Window client) {
     frame->iconHeight = 0;
   }
 
-  // Get _NET_WM_ICON atom
-  Atom netWmIcon = XInternAtom(m_display, "_NET_WM_ICON", 0);
-  Atom actualType;
-  int actualFormat;
-  unsigned long nItems, bytesAfter;
-  unsigned char *data = nullptr;
-
-  // Try to get the icon property
-  int result = XGetWindowProperty(m_display, client, netWmIcon, 0, LONG_MAX, 0,
-                                  XA_CARDINAL, &actualType, &actualFormat,
-                                  &nItems, &bytesAfter, &data);
-
-  if (result != Success || !data || nItems < 2) {
-    if (data)
-      XFree(data);
-    return;
-  }
-
-  // _NET_WM_ICON format: width, height, ARGB pixel data
-  unsigned long *iconData = (unsigned long *)data;
-  unsigned long width = iconData[0];
-  unsigned long height = iconData[1];
-
   // We want a small icon for the titlebar (16x16)
   const int TARGET_SIZE = 16;
 
-  // Find the best matching icon size
-  unsigned long bestIdx = 0;
-  unsigned long bestSize = width;
-  unsigned long idx = 0;
-
-  while (idx < nItems) {
-    if (idx + 2 >= nItems)
-      break;
-
-    unsigned long w = iconData[idx];
-    unsigned long h = iconData[idx + 1];
-    unsigned long pixels = w * h;
-
-    if (idx + 2 + pixels > nItems)
-      break;
-
-    // Prefer icons close to TARGET_SIZE
-    if (w >= TARGET_SIZE && w <= bestSize) {
-      bestSize = w;
-      bestIdx = idx;
-    }
-
-    idx += 2 + pixels;
-  }
-
-  // Use the best icon found
-  width = iconData[bestIdx];
-  height = iconData[bestIdx + 1];
-  unsigned long *pixels = &iconData[bestIdx + 2];
+  const QImage icon =
+      WindowIconCache::instance()->icon(client, QSize(TARGET_SIZE, TARGET_SIZE));
+  if (icon.isNull())
+    return;
 
   // Get titlebar left color for alpha blending background
   QColor bgColor = QColor("#3c3c3c"); // Default fallback
   if (auto theme = ThemeManager::instance()) {
     bgColor = theme->uiTitleBarLeftColor();
   }
-  unsigned char bgR = bgColor.red();
-  unsigned char bgG = bgColor.green();
-  unsigned char bgB = bgColor.blue();
+
+  QImage blended(TARGET_SIZE, TARGET_SIZE, QImage::Format_RGB32);
+  blended.fill(bgColor);
+  {
+    QPainter painter(&blended);
+    painter.drawImage((TARGET_SIZE - icon.width()) / 2,
+                      (TARGET_SIZE - icon.height()) / 2, icon);
+  }
 
   // Create a pixmap for the icon
   int screen = DefaultScreen(m_display);
@@ -1091,12 +1198,10 @@ void X11WindowManager::loadWindowIcon(X11Frame *frame, Window client) {
   frame->iconPixmap =
       XCreatePixmap(m_display, root, TARGET_SIZE, TARGET_SIZE, depth);
 
-  if (frame->iconPixmap == None) {
-    XFree(data);
+  if (frame->iconPixmap == None)
     return;
-  }
 
-  // Create an XImage to convert ARGB data
+  // Create an XImage to convert the RGB data
   XImage *image =
       XCreateImage(m_display, DefaultVisual(m_display, screen), depth, ZPixmap,
                    0, nullptr, TARGET_SIZE, TARGET_SIZE, 32, 0);
@@ -1104,44 +1209,22 @@ void X11WindowManager::loadWindowIcon(X11Frame *frame, Window client) {
   if (!image) {
     XFreePixmap(m_display, frame->iconPixmap);
     frame->iconPixmap = None;
-    XFree(data);
     return;
   }
 
   // Allocate image data
-  image->data = (char *)malloc(TARGET_SIZE * TARGET_SIZE * 4);
+  image->data = (char *)malloc(image->bytes_per_line * TARGET_SIZE);
   if (!image->data) {
     XDestroyImage(image);
     XFreePixmap(m_display, frame->iconPixmap);
     frame->iconPixmap = None;
-    XFree(data);
     return;
   }
 
-  // Scale and convert ARGB to RGB with titlebar background color
   for (int y = 0; y < TARGET_SIZE; y++) {
-    for (int x = 0; x < TARGET_SIZE; x++) {
-      // Simple nearest-neighbor scaling
-      int srcX = (x * width) / TARGET_SIZE;
-      int srcY = (y * height) / TARGET_SIZE;
-      unsigned long pixel = pixels[srcY * width + srcX];
-
-      // Extract ARGB components
-      unsigned char a = (pixel >> 24) & 0xFF;
-      unsigned char r = (pixel >> 16) & 0xFF;
-      unsigned char g = (pixel >> 8) & 0xFF;
-      unsigned char b = pixel & 0xFF;
-
-      // Alpha blending with titlebar left color background
-      if (a < 255) {
-        r = (r * a + bgR * (255 - a)) / 255;
-        g = (g * a + bgG * (255 - a)) / 255;
-        b = (b * a + bgB * (255 - a)) / 255;
-      }
-
-      unsigned long rgbPixel = (r << 16) | (g << 8) | b;
-      XPutPixel(image, x, y, rgbPixel);
-    }
+    const QRgb *line = reinterpret_cast<const QRgb *>(blended.constScanLine(y));
+    for (int x = 0; x < TARGET_SIZE; x++)
+      XPutPixel(image, x, y, line[x] & 0xFFFFFF);
   }
 
   // Draw the image to the pixmap
@@ -1157,7 +1240,6 @@ void X11WindowManager::loadWindowIcon(X11Frame *frame, Window client) {
   free(image->data);
   image->data = nullptr;
   XDestroyImage(image);
-  XFree(data);
 }
 
 void X11WindowManager::drawTitleBarIcon(X11Frame *frame) {
@@ -2110,3 +2192,145 @@ void X11WindowManager::restoreDecorations(int workspace) {
   }
   XFlush(m_display);
 }
+
+void X11WindowManager::scheduleRootBackground() {
+  // Coalesces the wallpaper, fill mode and monitor changes of one event
+  // loop pass (e.g. loadColors() emits all of them)
+  if (m_backgroundPending)
+    return;
+  m_backgroundPending = true;
+  QMetaObject::invokeMethod(this, &X11WindowManager::renderRootBackground,
+                            Qt::QueuedConnection);
+}
+
+void X11WindowManager::renderRootBackground() {
+  if (m_backgroundWatcher.isRunning())
+    return; // Rendered again when the current one finishes
+  m_backgroundPending = false;
+
+  ThemeManager *theme = ThemeManager::instance();
+  if (!m_display || !theme || theme->wallpaperPath().isEmpty())
+    return;
+
+  m_backgroundMonitors = m_monitors;
+  if (m_backgroundMonitors.isEmpty()) {
+    const int screen = DefaultScreen(m_display);
+    m_backgroundMonitors.append({"Default", 0, 0,
+                                 DisplayWidth(m_display, screen),
+                                 DisplayHeight(m_display, screen), true});
+  }
+
+  // Same renders as the QML desktop's image://wallpaper, so usually a
+  // cache hit
+  m_backgroundWatcher.setFuture(QtConcurrent::run(
+      [path = theme->wallpaperPath(), mode = theme->wallpaperFillMode(),
+       monitors = m_backgroundMonitors]() {
+        QList<QImage> images;
+        for (const Monitor &mon : monitors)
+          images.append(WallpaperCache::render(
+              path, QSize(mon.width, mon.height), mode));
+        return images;
+      }));
+}
+
+void X11WindowManager::publishRootBackground() {
+  if (m_backgroundPending) {
+    renderRootBackground(); // Stale: something changed meanwhile
+    return;
+  }
+
+  const QList<QImage> images = m_backgroundWatcher.result();
+  bool any = false;
+  for (const QImage &image : images)
+    any = any || !image.isNull();
+  if (!any)
+    return;
+
+  // The pixmap must outlive this connection (and this process), so it is
+  // made on its own connection that is closed with RetainPermanent. The next
+  // publisher, us or a tool like feh, frees it with XKillClient.
+  Display *display = XOpenDisplay(DisplayString(m_display));
+  if (!display) {
+    qWarning() << "[X11] Cannot open a connection for the root background";
+    return;
+  }
+  const int screen = DefaultScreen(display);
+  const Window root = RootWindow(display, screen);
+  const int depth = DefaultDepth(display, screen);
+  const int width = DisplayWidth(display, screen);
+  const int height = DisplayHeight(display, screen);
+
+  Pixmap pixmap = XCreatePixmap(display, root, width, height, depth);
+  GC gc = XCreateGC(display, pixmap, 0, nullptr);
+  XSetForeground(display, gc, BlackPixel(display, screen));
+  XFillRectangle(display, pixmap, gc, 0, 0, width, height);
+
+  // Format_RGB32 scan lines are 0xffRRGGBB words, i.e. a 24/32-bit TrueColor
+  // ZPixmap (the same assumption as the titlebar icons), so they are sent
+  // as they are. Xlib swaps bytes if the server's order differs and splits
+  // large images into several requests.
+  for (int i = 0; i < images.size() && i < m_backgroundMonitors.size(); ++i) {
+    QImage image = images.at(i);
+    if (image.isNull())
+      continue;
+    if (image.format() != QImage::Format_RGB32)
+      image = image.convertToFormat(QImage::Format_RGB32);
+    XImage *ximage = XCreateImage(
+        display, DefaultVisual(display, screen), depth, ZPixmap, 0,
+        reinterpret_cast<char *>(image.bits()), image.width(), image.height(),
+        32, int(image.bytesPerLine()));
+    if (!ximage)
+      continue;
+    ximage->byte_order =
+        Q_BYTE_ORDER == Q_LITTLE_ENDIAN ? LSBFirst : MSBFirst;
+    const Monitor &mon = m_backgroundMonitors.at(i);
+    XPutImage(display, pixmap, gc, ximage, 0, 0, mon.x, mon.y, image.width(),
+              image.height());
+    ximage->data = nullptr; // Owned by the QImage
+    XDestroyImage(ximage);
+  }
+  XFreeGC(display, gc);
+
+  const Atom rootPmap = XInternAtom(display, "_XROOTPMAP_ID", 0);
+  const Atom esetrootPmap = XInternAtom(display, "ESETROOT_PMAP_ID", 0);
+
+  // Free the previous publisher's pixmap; it is only ours to kill when
+  // both properties agree (the Esetroot convention)
+  auto readPixmap = [display, root](Atom property) -> Pixmap {
+    Atom type;
+    int format;
+    unsigned long items, remaining;
+    unsigned char *data = nullptr;
+    Pixmap value = None;
+    if (XGetWindowProperty(display, root, property, 0, 1, 0, AnyPropertyType,
+                           &type, &format, &items, &remaining,
+                           &data) == Success &&
+        type == XA_PIXMAP && items == 1 && data)
+      value = *reinterpret_cast<Pixmap *>(data);
+    if (data)
+      XFree(data);
+    return value;
+  };
+  const Pixmap previous = readPixmap(rootPmap);
+  if (previous != None && previous == readPixmap(esetrootPmap)) {
+    // A stale id (its client already gone) is a harmless BadValue
+    XSync(display, 0);
+    XErrorHandler handler =
+        XSetErrorHandler([](Display *, XErrorEvent *) { return 0; });
+    XKillClient(display, previous);
+    XSync(display, 0);
+    XSetErrorHandler(handler);
+  }
+
+  XChangeProperty(display, root, rootPmap, XA_PIXMAP, 32, PropModeReplace,
+                  reinterpret_cast<unsigned char *>(&pixmap), 1);
+  XChangeProperty(display, root, esetrootPmap, XA_PIXMAP, 32,
+                  PropModeReplace, reinterpret_cast<unsigned char *>(&pixmap),
+                  1);
+  XSetWindowBackgroundPixmap(display, root, pixmap);
+  XClearWindow(display, root);
+  XSetCloseDownMode(display, RetainPermanent);
+  XCloseDisplay(display);
+
+  qInfo() << "[X11] Published root background" << width << "x" << height;
+}
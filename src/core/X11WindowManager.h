@@ -1,6 +1,8 @@
 #pragma once
 
+#include <QFutureWatcher>
 #include <QHash>
+#include <QImage>
 #include <QObject>
 #include <QSocketNotifier>
 // #include <QTimer>  // DISABLED: Compositing disabled for now
@@ -97,6 +99,7 @@ struct X11Frame {
   XftFont *xftFont = nullptr;
   XftDraw *xftDraw = nullptr;
   XftColor xftTextColor;
+  unsigned long xftTextRgb = 0; // What xftTextColor was allocated for
 
   QList<X11Button> buttons; // Titlebar buttons
 
@@ -175,11 +178,25 @@ private:
   void handleButtonPress(XButtonEvent *event);
   void handleButtonRelease(XButtonEvent *event);
   void handleMotionNotify(XMotionEvent *event);
+  void handleClientMessage(XClientMessageEvent *event);
   void updateWindowProperties(X11Window *win);
 
-  // Theme updates
+  // Startup notification
+  void reportStartup(Window w, const QString &appId);
+  QByteArray readStringProperty(Window w, Atom property);
+
+  // Theme updates; theme signals only schedule one redraw pass per event
+  // loop iteration
+  void scheduleThemeUpdate();
   void updateThemeColors();
 
+  // Root window background: the wallpaper from WallpaperCache, one render
+  // per monitor, published as _XROOTPMAP_ID/ESETROOT_PMAP_ID so the server
+  // paints exposed root areas and pseudo-transparent clients can use it
+  void scheduleRootBackground();
+  void renderRootBackground();
+  void publishRootBackground();
+
   // Frame management
   X11Frame *createFrame(Window client, int x, int y, int width, int height);
   void destroyFrame(X11Frame *frame);
@@ -189,7 +206,9 @@ private:
   void createTitleBarButtons(X11Frame *frame);
   void drawTitleBarButton(X11Frame *frame, const X11Button &button);
 
-  // Icon management
+  // Icon management: _NET_WM_ICON is decoded into WindowIconCache once per
+  // window (and on change); the titlebar pixmap is rendered from the cache
+  void fetchWindowIcon(Window client);
   void loadWindowIcon(X11Frame *frame, Window client);
   void drawTitleBarIcon(X11Frame *frame);
 
@@ -211,6 +230,13 @@ private:
   QList<Monitor> m_monitors;
   int m_randrEventBase = 0;
 
+  // _NET_STARTUP_INFO messages arrive in 20-byte chunks per sender window
+  Atom m_netStartupInfoBegin = None;
+  Atom m_netStartupInfo = None;
+  QHash<Window, QByteArray> m_startupMessages;
+
+  Atom m_netWmIcon = None;
+
   // Focus tracking
   Window m_activeWindow = None;
 
@@ -276,6 +302,13 @@ private:
   int m_manualLeft = 0;
   int m_manualRight = 0;
 
+  bool m_themeUpdatePending = false;
+
+  // Root background rendering; one at a time, latest request wins
+  QFutureWatcher<QList<QImage>> m_backgroundWatcher;
+  QList<Monitor> m_backgroundMonitors; // Geometry of the running render
+  bool m_backgroundPending = false;
+
   // Tiling state
   int m_currentWorkspace = 0;
   int m_masterCount = 1;
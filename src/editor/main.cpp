@@ -1,40 +1,20 @@
+#include "ThemeIconProvider.h"
+#include "WallpaperProvider.h"
+#include "WindowIconProvider.h"
 #include <QCoreApplication>
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include <QUrl>
-#include <QQuickImageProvider>
-#include <QIcon>
-#include <QPixmap>
 #include <QDebug>
 #include <cstdio>
 
-class ThemeImageProvider : public QQuickImageProvider {
-public:
-    ThemeImageProvider() : QQuickImageProvider(QQuickImageProvider::Pixmap) {}
-
-    QPixmap requestPixmap(const QString &id, QSize *size, const QSize &requestedSize) override {
-        QIcon icon = QIcon::fromTheme(id);
-        // Fallback if theme icon not found
-        if (icon.isNull()) {
-             icon = QIcon::fromTheme("application-x-executable");
-        }
-
-        QSize actualSize = requestedSize;
-        if (!actualSize.isValid()) {
-            actualSize = QSize(64, 64); // Default size
-        }
-        
-        if (size) *size = actualSize;
-        
-        return icon.pixmap(actualSize);
-    }
-};
-
 int main(int argc, char *argv[]) {
   QGuiApplication app(argc, argv);
 
   QQmlApplicationEngine engine;
-  engine.addImageProvider("theme", new ThemeImageProvider);
+  engine.addImageProvider("theme", new ThemeIconProvider);
+  engine.addImageProvider("window", new WindowIconProvider);
+  engine.addImageProvider("wallpaper", new WallpaperProvider);
 
   // Add import paths for CanvasDesk modules
   engine.addImportPath("qrc:/");
@@ -37,21 +37,51 @@ ApplicationWindow {
     title: "CanvasDesk"
     color: Theme.wallpaperPath ? "black" : Theme.uiSecondaryColor
 
-    // Wallpaper
-    Image {
+    // Wallpaper, one image per screen. Each is rendered off-thread at the
+    // screen's exact pixel size and fill mode (and cached on disk), so only
+    // screen-sized textures stay resident and nothing is scaled per frame.
+    Item {
         id: wallpaperImage
         anchors.fill: parent
         z: -200
-        source: Theme.wallpaperPath ? (Theme.wallpaperPath.startsWith("/") ? "file://" + Theme.wallpaperPath : Theme.wallpaperPath) : ""
-        fillMode: Theme.wallpaperFillMode
         visible: Theme.wallpaperPath !== ""
+
+        Repeater {
+            model: wallpaperImage.visible ? Qt.application.screens : []
+
+            Image {
+                required property var modelData
+
+                x: modelData.virtualX - desktopWindow.x
+                y: modelData.virtualY - desktopWindow.y
+                width: modelData.width
+                height: modelData.height
+                sourceSize: Qt.size(width * modelData.devicePixelRatio,
+                                    height * modelData.devicePixelRatio)
+                source: "image://wallpaper/" + Theme.wallpaperFillMode + "/"
+                        + encodeURIComponent(Theme.wallpaperPath)
+                asynchronous: true
+                cache: false
+            }
+        }
     }
 
     // LayoutManager instance
     LayoutManager {
         id: layoutManager
+        onLayoutSaved: (path) => console.log("Layout saved successfully")
+        onSaveFailed: (path) => console.log("Failed to save layout to " + path)
     }
 
+    // Scene tree mirroring the live desktop; layout reloads are diffed
+    // against it so only changed components are touched
+    SceneModel {
+        id: sceneModel
+    }
+
+    // uid -> EditableComponent (top-level and docked)
+    property var componentItems: ({})
+
     // Selected component for property editing
     property var selectedComponent: null
     property bool isManuallyEditing: false
@@ -276,6 +306,10 @@ ApplicationWindow {
                             ListElement { type: "AtomCpu"; name: "Atom CPU"; icon: "cpu" }
                             ListElement { type: "AtomRam"; name: "Atom RAM"; icon: "memory" }
                             ListElement { type: "AtomDisk"; name: "Atom Disk"; icon: "drive-harddisk" }
+                            ListElement { type: "AtomNet"; name: "Atom Network"; icon: "network-wired" }
+                            ListElement { type: "AtomPressure"; name: "Atom Pressure"; icon: "dialog-warning" }
+                            ListElement { type: "AtomBattery"; name: "Atom Battery"; icon: "battery" }
+                            ListElement { type: "ProcessTable"; name: "Process Table"; icon: "utilities-system-monitor" }
                         }
                         
                         delegate: ItemDelegate {
@@ -811,10 +845,7 @@ ApplicationWindow {
                         highlighted: true
                         onClicked: {
                             saveDesktopLayout()
-                            // Clear and reload
-                            for (var i = desktopContainer.children.length - 1; i >= 0; --i) {
-                                desktopContainer.children[i].destroy()
-                            }
+                            // Reload; only components that differ from the saved layout are touched
                             loadDesktopLayout()
                         }
                     }
@@ -1049,6 +1080,67 @@ ApplicationWindow {
                                 }
                             }
 
+                            // Slideshow
+                            Label {
+                                text: "Slideshow Folder"
+                                color: Theme.uiTextColor
+                            }
+
+                            RowLayout {
+                                Layout.fillWidth: true
+                                TextField {
+                                    Layout.fillWidth: true
+                                    text: Theme.slideshowDirectory
+                                    placeholderText: "Off"
+                                    onEditingFinished: Theme.slideshowDirectory = text
+                                }
+                                Button {
+                                    text: "..."
+                                    onClicked: slideshowDialog.open()
+                                }
+                                Button {
+                                    text: "Next"
+                                    enabled: Theme.slideshowDirectory !== ""
+                                    onClicked: Theme.nextWallpaper()
+                                }
+                            }
+
+                            FolderDialog {
+                                id: slideshowDialog
+                                title: "Select Slideshow Folder"
+                                onAccepted: Theme.slideshowDirectory = selectedFolder
+                            }
+
+                            RowLayout {
+                                Layout.fillWidth: true
+                                enabled: Theme.slideshowDirectory !== ""
+                                Label {
+                                    text: "Every (s)"
+                                    color: Theme.uiTextColor
+                                    Layout.preferredWidth: 80
+                                }
+                                SpinBox {
+                                    from: 10
+                                    to: 86400
+                                    stepSize: 60
+                                    editable: true
+                                    value: Theme.slideshowInterval
+                                    onValueModified: Theme.slideshowInterval = value
+                                }
+                                CheckBox {
+                                    text: "Shuffle"
+                                    checked: Theme.slideshowShuffle
+                                    onToggled: Theme.slideshowShuffle = checked
+                                    contentItem: Text {
+                                        text: parent.text
+                                        color: Theme.uiTextColor
+                                        font: parent.font
+                                        verticalAlignment: Text.AlignVCenter
+                                        leftPadding: parent.indicator.width + parent.spacing
+                                    }
+                                }
+                            }
+
                             // Extracted Colors Preview
                             Label {
                                 text: "Theme Colors (Click to Assign)"
@@ -1780,7 +1872,8 @@ ApplicationWindow {
     // Note: Docking is now handled automatically by EditableComponent and PanelComponent
     // No need for a separate handleDocking function
 
-    function saveDesktopLayout() {
+    // Snapshot of the live desktop in layout.json form
+    function captureDesktopLayout() {
         var components = []
 
         // Iterate through all desktop components (non-docked ones)
@@ -1790,6 +1883,7 @@ ApplicationWindow {
             // Check if it's an EditableComponent and not docked
             if (child && child.componentType && !child.isDocked) {
                 var comp = {
+                    uid: child.componentUid,
                     type: child.componentType,
                     x: child.x,
                     y: child.y,
@@ -1844,6 +1938,7 @@ ApplicationWindow {
                                 if (dockedChild) {
                                     console.log("  - Saving docked:", dockedChild.componentType)
                                     var dockedData = {
+                                        uid: dockedChild.componentUid,
                                         type: dockedChild.componentType,
                                         width: dockedChild.width,
                                         height: dockedChild.height,
@@ -1865,52 +1960,30 @@ ApplicationWindow {
             }
         }
 
-        var layoutData = {
+        return {
             components: components
         }
+    }
+
+    function saveDesktopLayout() {
+        var layoutData = captureDesktopLayout()
+        sceneModel.reset(layoutData)
 
         var json = JSON.stringify(layoutData, null, 2)
-        if (layoutManager.saveLayout("layout.json", json)) {
-            console.log("Layout saved successfully")
-        } else {
+        if (!layoutManager.saveLayout("layout.json", json)) {
             console.log("Failed to save layout")
         }
     }
 
     function loadDesktopLayout() {
-        // Clear existing components
-        for (var i = desktopContainer.children.length - 1; i >= 0; --i) {
-            desktopContainer.children[i].destroy()
-        }
-
         var json = layoutManager.loadLayout("layout.json")
         if (json) {
             console.log("Loading desktop layout")
             try {
                 var data = JSON.parse(json)
-                if (data.components) {
-                    // First pass: create all components on desktop
-                    var panels = []
-                    for (var i = 0; i < data.components.length; ++i) {
-                        var component = createDesktopComponent(data.components[i])
-
-                        // Track panels for second pass
-                        if (component && (data.components[i].type === "Panel" || data.components[i].type === "EnhancedPanel") && data.components[i].dockedComponents) {
-                            panels.push({
-                                panel: component,
-                                dockedData: data.components[i].dockedComponents
-                            })
-                        }
-                    }
-
-                    // Second pass: dock components into panels
-                    // Wait a frame for panels to be fully initialized
-                    Qt.callLater(function() {
-                        for (var i = 0; i < panels.length; i++) {
-                            restoreDockedComponents(panels[i].panel, panels[i].dockedData)
-                        }
-                    })
-                }
+                // Diff against what is on screen right now and patch only what changed
+                sceneModel.reset(captureDesktopLayout())
+                applyScenePatches(sceneModel.update(data))
             } catch (e) {
                 console.log("Error loading layout: " + e)
             }
@@ -1920,6 +1993,144 @@ ApplicationWindow {
         }
     }
 
+    function findComponentItem(uid) {
+        var item = componentItems[uid]
+        // Entries of destroyed items no longer report their uid
+        return (item && item.componentUid === uid) ? item : null
+    }
+
+    function registerComponentItem(item) {
+        if (item && item.componentUid) {
+            componentItems[item.componentUid] = item
+        }
+    }
+
+    // Apply SceneModel patches (add/remove/move/update) to the live items
+    function applyScenePatches(patches) {
+        var docks = []
+
+        for (var i = 0; i < patches.length; i++) {
+            var patch = patches[i]
+            var item = findComponentItem(patch.uid)
+
+            if (patch.op === "add") {
+                if (!patch.parentUid) {
+                    var created = createDesktopComponent(patch.data)
+                    if (created && patch.data.dockedComponents) {
+                        docks.push({ panel: created, dockedData: patch.data.dockedComponents })
+                    }
+                } else {
+                    var panel = findComponentItem(patch.parentUid)
+                    if (panel) {
+                        docks.push({ panel: panel, dockedData: [patch.data],
+                                     uid: patch.uid, afterUid: patch.afterUid })
+                    }
+                }
+            } else if (patch.op === "remove") {
+                if (item) {
+                    if (item.isDocked && item.dockedPanel) {
+                        item.dockedPanel.undockComponent(item, desktopContainer)
+                    }
+                    delete componentItems[patch.uid]
+                    item.destroy()
+                }
+            } else if (patch.op === "move") {
+                if (!item) continue
+                // Re-dock after the preceding sibling, or return to the desktop
+                var target = patch.parentUid ? findComponentItem(patch.parentUid) : null
+                if (item.isDocked && item.dockedPanel) {
+                    item.dockedPanel.undockComponent(item, desktopContainer)
+                }
+                if (target) {
+                    docks.push({ panel: target, items: [item], afterUid: patch.afterUid })
+                }
+            } else if (patch.op === "update") {
+                if (item) updateComponentItem(item, patch.data)
+            }
+        }
+
+        if (docks.length > 0) {
+            // Let freshly created panels finish loading before docking into them
+            Qt.callLater(function() {
+                for (var j = 0; j < docks.length; j++) {
+                    if (docks[j].dockedData) {
+                        restoreDockedComponents(docks[j].panel, docks[j].dockedData)
+                        // Panels append; a single docked add goes after its sibling
+                        if (docks[j].uid) {
+                            placeDockedComponent(findComponentItem(docks[j].uid), docks[j].afterUid)
+                        }
+                    } else if (docks[j].panel.loadedItem) {
+                        for (var k = 0; k < docks[j].items.length; k++) {
+                            var docked = docks[j].items[k]
+                            var section = docked.componentData ? docked.componentData.sectionIndex : undefined
+                            if (docks[j].panel.loadedItem.dockComponent(docked, section)) {
+                                placeDockedComponent(docked, docks[j].afterUid)
+                            }
+                        }
+                    }
+                }
+            })
+        }
+
+        console.log("Applied", patches.length, "scene patches")
+    }
+
+    // Move a docked item right after its preceding sibling in the panel
+    // layout. An empty afterUid, or a sibling in another section, puts it
+    // first. Layouts order by children, so the items that must follow are
+    // reparented back in order to land behind it.
+    function placeDockedComponent(item, afterUid) {
+        if (!item || !item.isDocked || !item.parent) return
+
+        var layout = item.parent
+        var order = []
+        for (var i = 0; i < layout.children.length; i++) {
+            var child = layout.children[i]
+            if (child !== item && child.componentType) order.push(child)
+        }
+
+        var position = 0
+        for (var j = 0; j < order.length; j++) {
+            if (afterUid && order[j].componentUid === afterUid) {
+                position = j + 1
+                break
+            }
+        }
+        order.splice(position, 0, item)
+
+        for (var k = position; k < order.length; k++) {
+            order[k].parent = null
+            order[k].parent = layout
+        }
+    }
+
+    function updateComponentItem(item, changes) {
+        var data = item.componentData || {}
+        for (var key in changes) {
+            var value = changes[key]
+            if (value === null || value === undefined) {
+                delete data[key]
+                continue
+            }
+            data[key] = value
+
+            if (key === "type") {
+                item.componentType = value  // Loader swaps the component
+            } else if (key === "props") {
+                if (item.loadedItem) {
+                    for (var prop in value) {
+                        if (item.loadedItem.hasOwnProperty(prop)) {
+                            item.loadedItem[prop] = value[prop]
+                        }
+                    }
+                }
+            } else if (!item.isDocked && (key === "x" || key === "y" || key === "width" || key === "height")) {
+                item[key] = value  // Docked geometry is owned by the panel
+            }
+        }
+        item.componentData = data
+    }
+
     function createDefaultLayout() {
         console.log("Creating default desktop with panel and basic components")
 
@@ -1966,16 +2177,9 @@ ApplicationWindow {
             ]
         }
 
-        // Create the panel component
-        var panel = createDesktopComponent(panelData)
-
-        // Dock the components to the panel after a short delay
-        // to ensure panel is fully initialized
-        Qt.callLater(function() {
-            if (panel && panelData.dockedComponents) {
-                restoreDockedComponents(panel, panelData.dockedComponents)
-            }
-        })
+        // Create the panel and dock its components through the scene model
+        sceneModel.reset(captureDesktopLayout())
+        applyScenePatches(sceneModel.update({ components: [panelData] }))
 
         console.log("Default layout created")
     }
@@ -2000,10 +2204,15 @@ ApplicationWindow {
             console.log("  Restoring docked component:", compData.type)
 
             // Create the component
+            if (!compData.uid) {
+                compData.uid = sceneModel.createUid(compData.type)
+            }
+
             var componentQml = 'import QtQuick 2.15; import "."; EditableComponent { ' +
                 'width: ' + (compData.width || 40) + '; ' +
                 'height: ' + (compData.height || 40) + '; ' +
                 'componentType: "' + compData.type + '"; ' +
+                'componentUid: ' + JSON.stringify(compData.uid) + '; ' +
                 'editorOpen: showFloatingEditor; ' +
                 'componentData: (' + JSON.stringify(compData) + '); ' +
                 'desktopParent: desktopContainer' +
@@ -2012,6 +2221,8 @@ ApplicationWindow {
             try {
                 var newComponent = Qt.createQmlObject(componentQml, desktopContainer, "docked_" + compData.type + "_" + i)
 
+                registerComponentItem(newComponent)
+
                 // Dock it immediately
                 if (newComponent) {
                     // Pass section index if available (for EnhancedPanel)
@@ -2041,13 +2252,21 @@ ApplicationWindow {
             "SysInfo": { width: 150, height: 80 },
             "AtomCpu": { width: 120, height: 40 },
             "AtomRam": { width: 120, height: 40 },
-            "AtomDisk": { width: 120, height: 40 }
+            "AtomDisk": { width: 120, height: 40 },
+            "AtomNet": { width: 140, height: 40 },
+            "AtomPressure": { width: 120, height: 40 },
+            "AtomBattery": { width: 120, height: 40 },
+            "ProcessTable": { width: 320, height: 300 }
         }
 
         var defaultSize = defaults[data.type] || { width: 100, height: 50 }
         var width = data.width || defaultSize.width
         var height = data.height || defaultSize.height
 
+        if (!data.uid) {
+            data.uid = sceneModel.createUid(data.type)
+        }
+
         // Create component wrapper with loader
         var comp_id = "comp_" + data.type + "_" + Date.now()
         var componentQml = 'import QtQuick 2.15; import "."; EditableComponent { ' +
@@ -2056,6 +2275,7 @@ ApplicationWindow {
             'width: ' + width + '; ' +
             'height: ' + height + '; ' +
             'componentType: "' + data.type + '"; ' +
+            'componentUid: ' + JSON.stringify(data.uid) + '; ' +
             'editorOpen: showFloatingEditor; ' +
             'componentData: (' + JSON.stringify(data) + '); ' +
             'desktopParent: desktopContainer' +
@@ -2063,6 +2283,7 @@ ApplicationWindow {
 
         try {
             var newComponent = Qt.createQmlObject(componentQml, desktopContainer, "component_" + data.type + "_" + Date.now())
+            registerComponentItem(newComponent)
             return newComponent
         } catch (e) {
             console.log("Error creating component " + data.type + ": " + e)
@@ -9,6 +9,7 @@ Item {
     property bool selected: false
     property var componentData: null
     property string componentType: ""
+    property string componentUid: ""  // Stable id in the scene tree (SceneModel)
     property bool isDocked: false
     property var dockedPanel: null  // Reference to the panel this is docked to
     property bool canDock: false  // Visual feedback during drag
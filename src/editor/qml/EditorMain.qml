@@ -29,6 +29,8 @@ ApplicationWindow {
     // LayoutManager instance
     LayoutManager {
         id: layoutManager
+        onLayoutSaved: (path) => console.log("Layout saved to " + path)
+        onSaveFailed: (path) => console.warn("Failed to save layout to " + path)
     }
 
     // Preview mode state (always true in runtime, or when preview is toggled in editor)
@@ -41,11 +43,16 @@ ApplicationWindow {
         }
     }
 
-    function saveLayout() {
+    function newUid(type) {
+        return type + "-" + Math.random().toString(16).slice(2, 14)
+    }
+
+    function layoutJson(indent) {
         var items = []
         for (var i = 0; i < canvasModel.count; ++i) {
             var item = canvasModel.get(i)
             items.push({ 
+                uid: item.uid,
                 type: item.type, 
                 x: item.x, 
                 y: item.y,
@@ -57,9 +64,13 @@ ApplicationWindow {
                 centerComponents: item.centerComponents
             })
         }
-        var json = JSON.stringify({ components: items }, null, 2)
-        if (layoutManager.saveLayout("layout.json", json)) {
-            console.log("Layout saved to layout.json")
+        return JSON.stringify({ components: items }, null, indent)
+    }
+
+    function saveLayout() {
+        var json = layoutJson(2)
+        if (!layoutManager.saveLayout("layout.json", json)) {
+            console.warn("Cannot save layout.json")
         }
     }
 
@@ -71,7 +82,11 @@ ApplicationWindow {
                 canvasModel.clear()
                 if (data.components) {
                     for (var i = 0; i < data.components.length; ++i) {
-                        canvasModel.append(data.components[i])
+                        var comp = data.components[i]
+                        // Same fallback uid the runtime's SceneModel assigns
+                        if (!comp.uid)
+                            comp.uid = comp.type + "#" + i
+                        canvasModel.append(comp)
                     }
                 }
                 console.log("Layout loaded")
@@ -86,6 +101,21 @@ ApplicationWindow {
         id: canvasModel
     }
 
+    // Stream edits to a runtime started with Run, without restarting it
+    Timer {
+        id: livePushTimer
+        interval: 100
+        onTriggered: layoutManager.pushLayout(layoutJson())
+    }
+
+    Connections {
+        target: canvasModel
+        enabled: layoutManager.runtimeConnected
+        function onDataChanged() { livePushTimer.restart() }
+        function onRowsInserted() { livePushTimer.restart() }
+        function onRowsRemoved() { livePushTimer.restart() }
+    }
+
     header: ToolBar {
         visible: !isRuntimeMode
         height: !isRuntimeMode ? implicitHeight : 0
@@ -114,7 +144,12 @@ ApplicationWindow {
             }
             ToolButton {
                 text: "Run"
-                onClicked: layoutManager.runProject("layout.json")
+                onClicked: {
+                    if (layoutManager.runtimeConnected)
+                        layoutManager.pushLayout(layoutJson())
+                    else
+                        layoutManager.runProject("layout.json")
+                }
                 enabled: !previewMode
             }
             Item { Layout.fillWidth: true }
@@ -184,6 +219,10 @@ ApplicationWindow {
                                 ListElement { type: "AtomCpu"; name: "Atom CPU"; icon: "cpu" }
                                 ListElement { type: "AtomRam"; name: "Atom RAM"; icon: "memory" }
                                 ListElement { type: "AtomDisk"; name: "Atom Disk"; icon: "drive-harddisk" }
+                                ListElement { type: "AtomNet"; name: "Atom Network"; icon: "network-wired" }
+                                ListElement { type: "AtomPressure"; name: "Atom Pressure"; icon: "dialog-warning" }
+                                ListElement { type: "AtomBattery"; name: "Atom Battery"; icon: "battery" }
+                                ListElement { type: "ProcessTable"; name: "Process Table"; icon: "utilities-system-monitor" }
                             }
                             delegate: ItemDelegate {
                                 width: parent.width
@@ -203,12 +242,12 @@ ApplicationWindow {
 
                         // Apps List
                         ListView {
-                            model: AppManager.apps
+                            model: AppManager.model
                             clip: true
                             delegate: ItemDelegate {
                                 width: parent ? parent.width : 200
-                                text: modelData.name
-                                icon.name: modelData.icon || "application-x-executable"
+                                text: model.name
+                                icon.name: model.icon || "application-x-executable"
                                 
                                 Drag.active: appDragHandler.active
                                 Drag.dragType: Drag.Automatic
@@ -217,9 +256,9 @@ ApplicationWindow {
                                     "application/x-canvasdesk-app": JSON.stringify({
                                         type: "Button",
                                         properties: {
-                                            text: modelData.name,
-                                            icon: modelData.icon,
-                                            exec: modelData.exec
+                                            text: model.name,
+                                            icon: model.icon,
+                                            exec: model.exec
                                         }
                                     })
                                 }
@@ -313,12 +352,13 @@ ApplicationWindow {
                     onDropped: (drop) => {
                         if (drop.hasText && !drop.formats.includes("application/x-canvasdesk-app")) {
                             var type = drop.text
-                            var comp = { type: type, x: drop.x, y: drop.y }
+                            var comp = { uid: newUid(type), type: type, x: drop.x, y: drop.y }
                             canvasModel.append(comp)
                             drop.accept()
                         } else if (drop.formats.includes("application/x-canvasdesk-app")) {
                             var data = JSON.parse(drop.getDataAsString("application/x-canvasdesk-app"))
                             var comp = { 
+                                uid: newUid(data.type),
                                 type: data.type, 
                                 x: drop.x, 
                                 y: drop.y,
@@ -540,6 +580,7 @@ ApplicationWindow {
                             onClicked: {
                                 // Add component to desktop at center
                                 var comp = {
+                                    uid: newUid(type),
                                     type: type,
                                     x: parent.parent.parent.parent.parent.parent.width / 2 - 50,
                                     y: parent.parent.parent.parent.parent.parent.height / 2 - 25,
@@ -731,7 +772,7 @@ ApplicationWindow {
         } else if (data.type === "Taskbar") {
             qml = 'import QtQuick; import QtQuick.Controls; import QtQuick.Layouts; import CanvasDesk; Rectangle { width: 400; height: 40; x: ' + data.x + '; y: ' + data.y + '; color: Theme.uiPrimaryColor; border.color: "#444"; border.width: 1; radius: 4; ListView { anchors.fill: parent; anchors.margins: 2; orientation: ListView.Horizontal; spacing: 4; model: WindowManager.windows; delegate: Rectangle { width: 100; height: 30; color: modelData.active ? "#3a3a3a" : "#2a2a2a"; border.color: Theme.uiTitleBarLeftColor; radius: 2; Text { anchors.centerIn: parent; text: modelData.title; color: Theme.uiTextColor; elide: Text.ElideRight; width: parent.width - 10; horizontalAlignment: Text.AlignHCenter } MouseArea { anchors.fill: parent; onClicked: WindowManager.activate(modelData.id) } } Text { visible: parent.count === 0; anchors.centerIn: parent; text: "Taskbar (no windows)"; color: "#888"; font.pixelSize: 12 } } }'
         } else if (data.type === "AppGrid") {
-            qml = 'import QtQuick; import QtQuick.Controls; import CanvasDesk; Rectangle { width: 300; height: 400; x: ' + data.x + '; y: ' + data.y + '; color: Theme.uiPrimaryColor; border.color: "#444"; border.width: 1; radius: 4; GridView { anchors.fill: parent; anchors.margins: 8; cellWidth: 80; cellHeight: 80; clip: true; model: AppManager.apps; delegate: Item { width: 80; height: 80; Column { anchors.centerIn: parent; spacing: 5; Rectangle { width: 48; height: 48; color: "transparent"; Image { anchors.fill: parent; source: "image://theme/" + (modelData.icon || "application-x-executable"); sourceSize.width: 48; sourceSize.height: 48; fillMode: Image.PreserveAspectFit } MouseArea { anchors.fill: parent; onClicked: AppManager.launch(modelData.exec) } } Text { text: modelData.name; width: 70; elide: Text.ElideRight; horizontalAlignment: Text.AlignHCenter; font.pixelSize: 10; color: Theme.uiTextColor } } } } }'
+            qml = 'import QtQuick; import QtQuick.Controls; import CanvasDesk; Rectangle { width: 300; height: 400; x: ' + data.x + '; y: ' + data.y + '; color: Theme.uiPrimaryColor; border.color: "#444"; border.width: 1; radius: 4; GridView { anchors.fill: parent; anchors.margins: 8; cellWidth: 80; cellHeight: 80; clip: true; model: AppManager.model; delegate: Item { width: 80; height: 80; Column { anchors.centerIn: parent; spacing: 5; Rectangle { width: 48; height: 48; color: "transparent"; Image { anchors.fill: parent; source: "image://theme/" + (model.icon || "application-x-executable"); sourceSize.width: 48; sourceSize.height: 48; fillMode: Image.PreserveAspectFit } MouseArea { anchors.fill: parent; onClicked: AppManager.launchApp(model.id) } } Text { text: model.name; width: 70; elide: Text.ElideRight; horizontalAlignment: Text.AlignHCenter; font.pixelSize: 10; color: Theme.uiTextColor } } } } }'
         } else if (data.type === "WorkspaceSwitcher") {
             qml = 'import QtQuick; import QtQuick.Controls; import QtQuick.Layouts; import CanvasDesk; Rectangle { width: 180; height: 40; x: ' + data.x + '; y: ' + data.y + '; color: Theme.uiPrimaryColor; border.color: "#444"; border.width: 1; radius: 4; Row { anchors.centerIn: parent; spacing: 5; Repeater { model: WindowManager.workspaceCount; delegate: Rectangle { width: 40; height: 30; color: WindowManager.currentWorkspace === index ? "#3a3a3a" : "#2a2a2a"; border.color: Theme.uiTitleBarLeftColor; radius: 2; Text { anchors.centerIn: parent; text: (index + 1).toString(); color: Theme.uiTextColor } MouseArea { anchors.fill: parent; onClicked: WindowManager.switchToWorkspace(index) } } } } }'
         } else if (data.type === "FileManager") {
@@ -751,6 +792,14 @@ ApplicationWindow {
              qml = 'import QtQuick; import QtQuick.Controls; import CanvasDesk; import "components"; AtomRamComponent { x: ' + data.x + '; y: ' + data.y + ' }'
         } else if (data.type === "AtomDisk") {
              qml = 'import QtQuick; import QtQuick.Controls; import CanvasDesk; import "components"; AtomDiskComponent { x: ' + data.x + '; y: ' + data.y + ' }'
+        } else if (data.type === "AtomNet") {
+             qml = 'import QtQuick; import QtQuick.Controls; import CanvasDesk; import "components"; AtomNetComponent { x: ' + data.x + '; y: ' + data.y + ' }'
+        } else if (data.type === "AtomPressure") {
+             qml = 'import QtQuick; import QtQuick.Controls; import CanvasDesk; import "components"; AtomPressureComponent { x: ' + data.x + '; y: ' + data.y + ' }'
+        } else if (data.type === "AtomBattery") {
+             qml = 'import QtQuick; import QtQuick.Controls; import CanvasDesk; import "components"; AtomBatteryComponent { x: ' + data.x + '; y: ' + data.y + ' }'
+        } else if (data.type === "ProcessTable") {
+             qml = 'import QtQuick; import QtQuick.Controls; import CanvasDesk; import "components"; ProcessTableComponent { x: ' + data.x + '; y: ' + data.y + ' }'
         } else {
             qml = 'import QtQuick; Rectangle { color: "#ddeeff"; border.color: "blue"; width: 100; height: 50; x: ' + data.x + '; y: ' + data.y + '; Text { anchors.centerIn: parent; text: "' + data.type + '"; color: "black" } }'
         }
@@ -25,7 +25,7 @@ Rectangle {
         cellWidth: root.cellWidth
         cellHeight: root.cellHeight
         clip: true
-        model: AppManager.apps
+        model: AppManager.model
         
         delegate: Item {
             width: root.cellWidth
@@ -42,7 +42,7 @@ Rectangle {
                     
                     Image {
                         anchors.fill: parent
-                        source: "image://theme/" + (modelData.icon || "application-x-executable")
+                        source: "image://theme/" + (model.icon || "application-x-executable")
                         sourceSize.width: 48
                         sourceSize.height: 48
                         fillMode: Image.PreserveAspectFit
@@ -51,12 +51,12 @@ Rectangle {
                     MouseArea {
                         anchors.fill: parent
                         enabled: !root.editorOpen
-                        onClicked: AppManager.launch(modelData.exec)
+                        onClicked: AppManager.launchApp(model.id)
                     }
                 }
                 
                 Text {
-                    text: modelData.name
+                    text: model.name
                     width: 70
                     elide: Text.ElideRight
                     horizontalAlignment: Text.AlignHCenter
@@ -19,6 +19,18 @@ Rectangle {
     // Internal state
     property bool showPopup: false
 
+    // Ranked search over the installed apps; empty query lists everything
+    AppSearchModel {
+        id: searchModel
+        sourceModel: AppManager.model
+        query: searchField.text
+    }
+
+    function launchApp(appId) {
+        AppManager.launchApp(appId)
+        root.showPopup = false
+    }
+
     // Smart positioning helper
     PopupPositionHelper {
         id: positionHelper
@@ -52,6 +64,24 @@ Rectangle {
         
         enabled: !root.editorOpen
         onClicked: root.showPopup = !root.showPopup
+
+        // Startup feedback while a launched app hasn't shown a window yet
+        BusyIndicator {
+            anchors.right: parent.right
+            anchors.verticalCenter: parent.verticalCenter
+            anchors.rightMargin: 2
+            height: parent.height - 8
+            width: height
+            running: AppManager.startup.busy
+            visible: running
+
+            ToolTip.visible: running && busyHover.hovered
+            ToolTip.text: "Starting " + AppManager.startup.pending.map(p => p.name).join(", ")
+
+            HoverHandler {
+                id: busyHover
+            }
+        }
     }
     
     // App grid popup (parented to desktop to escape panel clipping)
@@ -75,6 +105,9 @@ Rectangle {
         onVisibleChanged: {
             if (visible) {
                 positionHelper.calculatePosition()
+                searchField.forceActiveFocus()
+            } else {
+                searchField.text = ""
             }
         }
         
@@ -98,7 +131,24 @@ Rectangle {
                         text: "Apps"
                         font.bold: true
                         color: Theme.uiTextColor
+                    }
+
+                    TextField {
+                        id: searchField
                         Layout.fillWidth: true
+                        placeholderText: "Search..."
+                        color: Theme.uiTextColor
+                        // Launch the best match
+                        onAccepted: {
+                            if (searchModel.count > 0)
+                                root.launchApp(searchModel.get(0).id)
+                        }
+                        Keys.onEscapePressed: {
+                            if (text.length > 0)
+                                text = ""
+                            else
+                                root.showPopup = false
+                        }
                     }
                     
                     // View Switcher Buttons
@@ -156,7 +206,7 @@ Rectangle {
                     clip: true
                     cellWidth: 100
                     cellHeight: 110
-                    model: AppManager.apps
+                    model: searchModel
                     delegate: Item {
                         width: 100
                         height: 110
@@ -174,8 +224,7 @@ Rectangle {
                                 onEntered: parent.hovered = true
                                 onExited: parent.hovered = false
                                 onClicked: {
-                                    AppManager.launch(modelData.exec)
-                                    root.showPopup = false
+                                    root.launchApp(model.id)
                                 }
                             }
                             
@@ -185,7 +234,7 @@ Rectangle {
                                 
                                 Image {
                                     anchors.horizontalCenter: parent.horizontalCenter
-                                    source: "image://theme/" + (modelData.icon || "application-x-executable")
+                                    source: "image://theme/" + (model.icon || "application-x-executable")
                                     sourceSize.width: 64
                                     sourceSize.height: 64
                                     width: 64
@@ -194,7 +243,7 @@ Rectangle {
                                 }
                                 
                                 Text {
-                                    text: modelData.name
+                                    text: model.name
                                     width: 90
                                     elide: Text.ElideRight
                                     horizontalAlignment: Text.AlignHCenter
@@ -211,7 +260,7 @@ Rectangle {
                     clip: true
                     cellWidth: 70
                     cellHeight: 80
-                    model: AppManager.apps
+                    model: searchModel
                     delegate: Item {
                         width: 70
                         height: 80
@@ -229,8 +278,7 @@ Rectangle {
                                 onEntered: parent.hovered = true
                                 onExited: parent.hovered = false
                                 onClicked: {
-                                    AppManager.launch(modelData.exec)
-                                    root.showPopup = false
+                                    root.launchApp(model.id)
                                 }
                             }
                             
@@ -240,7 +288,7 @@ Rectangle {
                                 
                                 Image {
                                     anchors.horizontalCenter: parent.horizontalCenter
-                                    source: "image://theme/" + (modelData.icon || "application-x-executable")
+                                    source: "image://theme/" + (model.icon || "application-x-executable")
                                     sourceSize.width: 32
                                     sourceSize.height: 32
                                     width: 32
@@ -249,7 +297,7 @@ Rectangle {
                                 }
                                 
                                 Text {
-                                    text: modelData.name
+                                    text: model.name
                                     width: 66
                                     elide: Text.ElideRight
                                     horizontalAlignment: Text.AlignHCenter
@@ -264,7 +312,7 @@ Rectangle {
                 // 2: List View
                 ListView {
                     clip: true
-                    model: AppManager.apps
+                    model: searchModel
                     spacing: 2
                     delegate: Rectangle {
                         width: ListView.view.width
@@ -279,8 +327,7 @@ Rectangle {
                             onEntered: parent.hovered = true
                             onExited: parent.hovered = false
                             onClicked: {
-                                AppManager.launch(modelData.exec)
-                                root.showPopup = false
+                                root.launchApp(model.id)
                             }
                         }
                         
@@ -290,7 +337,7 @@ Rectangle {
                             spacing: 10
                             
                             Image {
-                                source: "image://theme/" + (modelData.icon || "application-x-executable")
+                                source: "image://theme/" + (model.icon || "application-x-executable")
                                 sourceSize.width: 24
                                 sourceSize.height: 24
                                 Layout.preferredWidth: 24
@@ -299,7 +346,7 @@ Rectangle {
                             }
                             
                             Text {
-                                text: modelData.name
+                                text: model.name
                                 color: Theme.uiTextColor
                                 font.pixelSize: 12
                                 Layout.fillWidth: true
@@ -317,7 +364,7 @@ Rectangle {
                         spacing: 8
                         
                         Repeater {
-                            model: AppManager.apps
+                            model: searchModel
                             
                             delegate: Rectangle {
                                 width: 80
@@ -341,7 +388,7 @@ Rectangle {
                                     
                                     Image {
                                         anchors.horizontalCenter: parent.horizontalCenter
-                                        source: "image://theme/" + (modelData.icon || "application-x-executable")
+                                        source: "image://theme/" + (model.icon || "application-x-executable")
                                         sourceSize.width: 48
                                         sourceSize.height: 48
                                         width: 48
@@ -350,7 +397,7 @@ Rectangle {
                                     }
                                     
                                     Text {
-                                        text: modelData.name
+                                        text: model.name
                                         width: 76
                                         elide: Text.ElideRight
                                         horizontalAlignment: Text.AlignHCenter
@@ -365,8 +412,7 @@ Rectangle {
                                     onEntered: parent.hovered = true
                                     onExited: parent.hovered = false
                                     onClicked: {
-                                        AppManager.launch(modelData.exec)
-                                        root.showPopup = false
+                                        root.launchApp(model.id)
                                     }
                                 }
                             }
@@ -0,0 +1,84 @@
+import QtQuick
+import QtQuick.Controls
+import CanvasDesk
+
+Rectangle {
+    id: root
+    
+    // Configurable properties
+    property color textColor: Theme.uiTextColor
+    property color barColor: Theme.uiHighlightColor
+    property color lowColor: "#d9534f"
+    property color backgroundColor: Theme.uiSecondaryColor
+    property real lowPercent: 15
+    property bool showTime: true
+    
+    // Editor support
+    property bool editorOpen: false
+    
+    readonly property var battery: SystemMonitor.battery
+    readonly property bool low: battery.present && !battery.charging
+                                && battery.percent <= lowPercent
+    
+    width: 120
+    height: 40
+    color: backgroundColor
+    radius: 4
+    border.color: Theme.uiTitleBarLeftColor
+    border.width: 1
+    
+    function formatTime(seconds) {
+        if (seconds < 0)
+            return ""
+        var hours = Math.floor(seconds / 3600)
+        var minutes = Math.floor((seconds % 3600) / 60)
+        return hours + ":" + (minutes < 10 ? "0" : "") + minutes
+    }
+    
+    // Plug/unplug and capacity changes arrive as uevents; the interval is
+    // only a fallback for drivers that do not send them
+    MonitorSubscription {
+        metrics: SystemMonitor.Battery
+        interval: 60000
+        active: root.visible && root.Window.window !== null && root.Window.window.visible
+    }
+
+    Row {
+        anchors.centerIn: parent
+        spacing: 10
+        
+        Text { 
+            anchors.verticalCenter: parent.verticalCenter
+            text: root.battery.charging || (!root.battery.present && root.battery.acOnline) ? "AC" : "BAT"
+            color: root.textColor
+            font.pixelSize: 12
+            font.bold: true
+        }
+        
+        Column {
+            spacing: 2
+            
+            Rectangle {
+                width: 60
+                height: 12
+                color: "#444444"
+                radius: 2
+                
+                Rectangle {
+                    width: parent.width * Math.min(1, root.battery.percent / 100)
+                    height: parent.height
+                    color: root.low ? root.lowColor : root.barColor
+                    radius: 2
+                }
+            }
+            
+            Text {
+                visible: root.showTime && root.battery.present
+                text: root.battery.percent.toFixed(0) + "%"
+                      + (root.battery.secondsRemaining >= 0 ? "  " + root.formatTime(root.battery.secondsRemaining) : "")
+                color: root.textColor
+                font.pixelSize: 9
+            }
+        }
+    }
+}
@@ -9,6 +9,10 @@ Rectangle {
     property color textColor: Theme.uiTextColor
     property color barColor: Theme.uiHighlightColor
     property color backgroundColor: Theme.uiSecondaryColor
+    property bool showHistory: true
+    // Live, or Hour/Day/Month from the on-disk archive
+    property int historySpan: SystemMonitor.Live
+    property bool showCores: false
     
     // Editor support
     property bool editorOpen: false
@@ -20,6 +24,22 @@ Rectangle {
     border.color: Theme.uiTitleBarLeftColor
     border.width: 1
     
+    // Sample only while this atom is on screen
+    MonitorSubscription {
+        metrics: SystemMonitor.Cpu
+        active: root.visible && root.Window.window !== null && root.Window.window.visible
+    }
+
+    // History behind the bar, drawn straight from the ring buffer
+    Sparkline {
+        anchors.fill: parent
+        anchors.margins: 2
+        visible: root.showHistory
+        history: SystemMonitor.longHistory("cpu", root.historySpan)
+        color: root.barColor
+        opacity: 0.35
+    }
+
     Row {
         anchors.centerIn: parent
         spacing: 10
@@ -31,7 +51,33 @@ Rectangle {
             font.bold: true
         }
         
+        // One thin bar per core
+        Row {
+            visible: root.showCores
+            height: 16
+            spacing: 1
+
+            Repeater {
+                model: root.showCores ? SystemMonitor.coreCount : 0
+
+                Rectangle {
+                    width: Math.max(2, 60 / SystemMonitor.coreCount - 1)
+                    height: parent.height
+                    color: "#444444"
+
+                    Rectangle {
+                        property var history: SystemMonitor.coreHistory(index)
+                        anchors.bottom: parent.bottom
+                        width: parent.width
+                        height: parent.height * (history ? history.latest : 0)
+                        color: root.barColor
+                    }
+                }
+            }
+        }
+
         Rectangle {
+            visible: !root.showCores
             width: 60
             height: 12
             color: "#444444"
@@ -9,6 +9,11 @@ Rectangle {
     property color textColor: Theme.uiTextColor
     property color barColor: Theme.uiHighlightColor
     property color backgroundColor: Theme.uiSecondaryColor
+    property bool showHistory: true
+    // Live, or Hour/Day/Month from the on-disk archive
+    property int historySpan: SystemMonitor.Live
+    property string mountPoint: "/"
+    property bool showThroughput: false
     
     // Editor support
     property bool editorOpen: false
@@ -20,28 +25,79 @@ Rectangle {
     border.color: Theme.uiTitleBarLeftColor
     border.width: 1
     
-    Row {
+    // Sample only while this atom is on screen
+    MonitorSubscription {
+        metrics: SystemMonitor.Disk
+        active: root.visible && root.Window.window !== null && root.Window.window.visible
+    }
+
+    // History behind the bar, drawn straight from the ring buffer
+    Sparkline {
+        anchors.fill: parent
+        anchors.margins: 2
+        visible: root.showHistory && root.mountPoint === "/"
+        history: SystemMonitor.longHistory("disk", root.historySpan)
+        color: root.barColor
+        opacity: 0.35
+    }
+
+    function formatRate(bytesPerSec) {
+        if (bytesPerSec >= 1048576)
+            return (bytesPerSec / 1048576).toFixed(1) + "M"
+        if (bytesPerSec >= 1024)
+            return (bytesPerSec / 1024).toFixed(0) + "K"
+        return bytesPerSec.toFixed(0) + "B"
+    }
+
+    Column {
         anchors.centerIn: parent
-        spacing: 10
-        
-        Text { 
-            text: "DSK"
-            color: root.textColor
-            font.pixelSize: 12
-            font.bold: true
-        }
-        
-        Rectangle {
-            width: 60
-            height: 12
-            color: "#444444"
-            radius: 2
+        spacing: 2
+
+        Row {
+            spacing: 10
+            
+            Text { 
+                text: "DSK"
+                color: root.textColor
+                font.pixelSize: 12
+                font.bold: true
+            }
             
             Rectangle {
-                width: parent.width * SystemMonitor.diskUsage
-                height: parent.height
-                color: root.barColor
+                width: 60
+                height: 12
+                color: "#444444"
                 radius: 2
+                
+                // SystemMonitor.disks has one row per mount; show ours
+                Repeater {
+                    model: SystemMonitor.disks
+                    delegate: Rectangle {
+                        required property string mountPoint
+                        required property real usage
+                        required property bool responsive
+                        
+                        visible: mountPoint === root.mountPoint
+                        width: parent.width * usage
+                        height: parent.height
+                        color: responsive ? root.barColor : "#aa4444"
+                        radius: 2
+                    }
+                }
+            }
+        }
+
+        Repeater {
+            model: root.showThroughput ? SystemMonitor.disks : null
+            delegate: Text {
+                required property string mountPoint
+                required property real readRate
+                required property real writeRate
+                
+                visible: mountPoint === root.mountPoint
+                text: "R " + root.formatRate(readRate) + "  W " + root.formatRate(writeRate)
+                color: root.textColor
+                font.pixelSize: 9
             }
         }
     }
@@ -0,0 +1,112 @@
+import QtQuick
+import QtQuick.Controls
+import CanvasDesk
+
+Rectangle {
+    id: root
+    
+    // Configurable properties
+    property color textColor: Theme.uiTextColor
+    property color barColor: Theme.uiHighlightColor
+    property color txColor: Theme.uiTitleBarLeftColor
+    property color backgroundColor: Theme.uiSecondaryColor
+    property bool showHistory: true
+    property string interfaceName: "" // Empty = all physical interfaces
+    // Live, or Hour/Day/Month of the totals from the on-disk archive
+    property int historySpan: SystemMonitor.Live
+    
+    // Editor support
+    property bool editorOpen: false
+    
+    // Totals unless a matching interface row overrides them below
+    property real rxRate: SystemMonitor.networkRxRate
+    property real txRate: SystemMonitor.networkTxRate
+    property var rxHistory: SystemMonitor.longHistory("networkRx", root.historySpan)
+    property var txHistory: SystemMonitor.longHistory("networkTx", root.historySpan)
+    
+    width: 140
+    height: 40
+    color: backgroundColor
+    radius: 4
+    border.color: Theme.uiTitleBarLeftColor
+    border.width: 1
+    
+    function formatRate(bytesPerSec) {
+        if (bytesPerSec >= 1048576)
+            return (bytesPerSec / 1048576).toFixed(1) + " MB/s"
+        if (bytesPerSec >= 1024)
+            return (bytesPerSec / 1024).toFixed(0) + " KB/s"
+        return bytesPerSec.toFixed(0) + " B/s"
+    }
+    
+    // Sample only while this atom is on screen
+    MonitorSubscription {
+        metrics: SystemMonitor.Network
+        active: root.visible && root.Window.window !== null && root.Window.window.visible
+    }
+    
+    Repeater {
+        model: root.interfaceName !== "" ? SystemMonitor.networks : null
+        delegate: Item {
+            required property string name
+            required property real rxRate
+            required property real txRate
+            required property var rxHistory
+            required property var txHistory
+            
+            readonly property bool matches: name === root.interfaceName
+            
+            Binding { target: root; property: "rxRate"; value: rxRate; when: matches }
+            Binding { target: root; property: "txRate"; value: txRate; when: matches }
+            Binding { target: root; property: "rxHistory"; value: rxHistory; when: matches }
+            Binding { target: root; property: "txHistory"; value: txHistory; when: matches }
+        }
+    }
+
+    // Receive and transmit history, each scaled to its own peak
+    Sparkline {
+        anchors.fill: parent
+        anchors.margins: 2
+        visible: root.showHistory
+        history: root.rxHistory
+        color: root.barColor
+        autoScale: true
+        opacity: 0.35
+    }
+    
+    Sparkline {
+        anchors.fill: parent
+        anchors.margins: 2
+        visible: root.showHistory
+        history: root.txHistory
+        color: root.txColor
+        autoScale: true
+        opacity: 0.35
+    }
+
+    Row {
+        anchors.centerIn: parent
+        spacing: 8
+        
+        Text { 
+            anchors.verticalCenter: parent.verticalCenter
+            text: "NET"
+            color: root.textColor
+            font.pixelSize: 12
+            font.bold: true
+        }
+        
+        Column {
+            Text {
+                text: "↓ " + root.formatRate(root.rxRate)
+                color: root.textColor
+                font.pixelSize: 10
+            }
+            Text {
+                text: "↑ " + root.formatRate(root.txRate)
+                color: root.textColor
+                font.pixelSize: 10
+            }
+        }
+    }
+}
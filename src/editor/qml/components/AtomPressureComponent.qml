@@ -0,0 +1,68 @@
+import QtQuick
+import QtQuick.Controls
+import CanvasDesk
+
+Rectangle {
+    id: root
+    
+    // Configurable properties
+    property color textColor: Theme.uiTextColor
+    property color barColor: Theme.uiHighlightColor
+    property color warningColor: "#d9534f"
+    property color backgroundColor: Theme.uiSecondaryColor
+    property real warnPercent: 5 // some avg10 at which to warn
+    
+    // Editor support
+    property bool editorOpen: false
+    
+    readonly property var pressure: SystemMonitor.memoryPressure
+    readonly property bool warning: SystemMonitor.pressureAvailable
+                                    && (pressure.stalled || pressure.some10 >= warnPercent)
+    
+    width: 120
+    height: 40
+    color: warning ? warningColor : backgroundColor
+    radius: 4
+    border.color: Theme.uiTitleBarLeftColor
+    border.width: 1
+    
+    Behavior on color { ColorAnimation { duration: 200 } }
+    
+    // Stalls are pushed by kernel triggers; the interval only refreshes
+    // the averages
+    MonitorSubscription {
+        metrics: SystemMonitor.Pressure
+        interval: 10000
+        active: SystemMonitor.pressureAvailable && root.visible
+                && root.Window.window !== null && root.Window.window.visible
+    }
+
+    Row {
+        anchors.centerIn: parent
+        spacing: 10
+        
+        Text { 
+            text: "MEM"
+            color: root.textColor
+            font.pixelSize: 12
+            font.bold: true
+        }
+        
+        Column {
+            Text {
+                text: SystemMonitor.pressureAvailable
+                      ? root.pressure.some10.toFixed(1) + "% stall"
+                      : "no PSI"
+                color: root.textColor
+                font.pixelSize: 10
+            }
+            Text {
+                visible: SystemMonitor.pressureAvailable
+                text: "60s " + root.pressure.some60.toFixed(1) + "%"
+                color: root.textColor
+                font.pixelSize: 9
+                opacity: 0.7
+            }
+        }
+    }
+}
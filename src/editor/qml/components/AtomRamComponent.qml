@@ -9,6 +9,9 @@ Rectangle {
     property color textColor: Theme.uiTextColor
     property color barColor: Theme.uiHighlightColor
     property color backgroundColor: Theme.uiSecondaryColor
+    property bool showHistory: true
+    // Live, or Hour/Day/Month from the on-disk archive
+    property int historySpan: SystemMonitor.Live
     
     // Editor support
     property bool editorOpen: false
@@ -20,6 +23,22 @@ Rectangle {
     border.color: Theme.uiTitleBarLeftColor
     border.width: 1
     
+    // Sample only while this atom is on screen
+    MonitorSubscription {
+        metrics: SystemMonitor.Memory
+        active: root.visible && root.Window.window !== null && root.Window.window.visible
+    }
+
+    // History behind the bar, drawn straight from the ring buffer
+    Sparkline {
+        anchors.fill: parent
+        anchors.margins: 2
+        visible: root.showHistory
+        history: SystemMonitor.longHistory("memory", root.historySpan)
+        color: root.barColor
+        opacity: 0.35
+    }
+
     Row {
         anchors.centerIn: parent
         spacing: 10
@@ -0,0 +1,149 @@
+import QtQuick
+import QtQuick.Controls
+import CanvasDesk
+
+Rectangle {
+    id: root
+    
+    // Configurable properties
+    property color textColor: Theme.uiTextColor
+    property color barColor: Theme.uiHighlightColor
+    property color backgroundColor: Theme.uiSecondaryColor
+    property int rows: 15
+    
+    // Editor support
+    property bool editorOpen: false
+    
+    // Own query: sorting or resizing this table leaves the others alone
+    readonly property ProcessModel processes: SystemMonitor.createProcessModel(root)
+    
+    width: 320
+    height: 300
+    color: backgroundColor
+    radius: 6
+    border.color: Theme.uiTitleBarLeftColor
+    border.width: 1
+    
+    function formatMemory(bytes) {
+        if (bytes >= 1073741824)
+            return (bytes / 1073741824).toFixed(1) + " G"
+        if (bytes >= 1048576)
+            return (bytes / 1048576).toFixed(0) + " M"
+        return (bytes / 1024).toFixed(0) + " K"
+    }
+    
+    // Sample only while this table is on screen
+    MonitorSubscription {
+        metrics: SystemMonitor.Processes
+        active: root.visible && root.Window.window !== null && root.Window.window.visible
+    }
+    
+    Binding {
+        target: root.processes
+        property: "limit"
+        value: root.rows
+    }
+    
+    Column {
+        anchors.fill: parent
+        anchors.margins: 8
+        spacing: 4
+        
+        // Header; CPU and Mem sort the table
+        Row {
+            width: parent.width
+            height: 18
+            
+            Text {
+                width: parent.width - 120
+                text: "Process (" + root.processes.totalCount + ")"
+                color: root.textColor
+                font.pixelSize: 11
+                font.bold: true
+                elide: Text.ElideRight
+            }
+            
+            Text {
+                width: 50
+                text: "CPU" + (root.processes.sortBy === ProcessModel.Cpu ? " ▾" : "")
+                color: root.textColor
+                font.pixelSize: 11
+                font.bold: true
+                horizontalAlignment: Text.AlignRight
+                
+                MouseArea {
+                    anchors.fill: parent
+                    enabled: !root.editorOpen
+                    onClicked: root.processes.sortBy = ProcessModel.Cpu
+                }
+            }
+            
+            Text {
+                width: 70
+                text: "Mem" + (root.processes.sortBy === ProcessModel.Memory ? " ▾" : "")
+                color: root.textColor
+                font.pixelSize: 11
+                font.bold: true
+                horizontalAlignment: Text.AlignRight
+                
+                MouseArea {
+                    anchors.fill: parent
+                    enabled: !root.editorOpen
+                    onClicked: root.processes.sortBy = ProcessModel.Memory
+                }
+            }
+        }
+        
+        ListView {
+            width: parent.width
+            height: parent.height - 22
+            clip: true
+            interactive: false
+            model: root.processes
+            
+            // Rows keep their delegate when the order changes
+            move: Transition { NumberAnimation { property: "y"; duration: 150 } }
+            displaced: Transition { NumberAnimation { property: "y"; duration: 150 } }
+            
+            delegate: Item {
+                width: ListView.view.width
+                height: 16
+                
+                // CPU share behind the row
+                Rectangle {
+                    width: parent.width * Math.min(1, model.cpu)
+                    height: parent.height
+                    color: root.barColor
+                    opacity: 0.3
+                    radius: 2
+                }
+                
+                Row {
+                    anchors.fill: parent
+                    
+                    Text {
+                        width: parent.width - 120
+                        text: model.name
+                        color: root.textColor
+                        font.pixelSize: 10
+                        elide: Text.ElideRight
+                    }
+                    Text {
+                        width: 50
+                        text: (model.cpu * 100).toFixed(1) + "%"
+                        color: root.textColor
+                        font.pixelSize: 10
+                        horizontalAlignment: Text.AlignRight
+                    }
+                    Text {
+                        width: 70
+                        text: root.formatMemory(model.memory)
+                        color: root.textColor
+                        font.pixelSize: 10
+                        horizontalAlignment: Text.AlignRight
+                    }
+                }
+            }
+        }
+    }
+}
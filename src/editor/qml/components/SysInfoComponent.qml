@@ -20,6 +20,12 @@ Rectangle {
     border.color: Theme.uiTitleBarLeftColor
     border.width: 1
     
+    // Sample only while this widget is on screen
+    MonitorSubscription {
+        metrics: SystemMonitor.Cpu | SystemMonitor.Memory | SystemMonitor.Disk
+        active: root.visible && root.Window.window !== null && root.Window.window.visible
+    }
+
     Column {
         anchors.fill: parent
         anchors.margins: 10
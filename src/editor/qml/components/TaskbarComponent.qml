@@ -47,7 +47,7 @@ Rectangle {
                 Image {
                     Layout.preferredWidth: 16
                     Layout.preferredHeight: 16
-                    source: "image://theme/" + (modelData.appId || "application-x-executable")
+                    source: modelData.iconSource
                     sourceSize.width: 16
                     sourceSize.height: 16
                     fillMode: Image.PreserveAspectFit
@@ -1,42 +1,20 @@
 #include "core/SystemMonitor.h"
+#include "core/ThemeIconProvider.h"
+#include "core/WallpaperProvider.h"
 #include "core/ThemeManager.h"
+#include "core/WindowIconProvider.h"
 #include <QCommandLineParser>
 #include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
 #include <QFile>
 #include <QGuiApplication>
-#include <QIcon>
-#include <QPixmap>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
-#include <QQuickImageProvider>
 #include <QStandardPaths>
 #include <QTextStream>
 #include <QUrl>
 
-class ThemeImageProvider : public QQuickImageProvider {
-public:
-  ThemeImageProvider() : QQuickImageProvider(QQuickImageProvider::Pixmap) {}
-
-  QPixmap requestPixmap(const QString &id, QSize *size,
-                        const QSize &requestedSize) override {
-    QIcon icon = QIcon::fromTheme(id);
-    if (icon.isNull()) {
-      icon = QIcon::fromTheme("application-x-executable");
-    }
-
-    QSize actualSize = requestedSize;
-    if (!actualSize.isValid()) {
-      actualSize = QSize(64, 64);
-    }
-
-    if (size)
-      *size = actualSize;
-    return icon.pixmap(actualSize);
-  }
-};
-
 int main(int argc, char *argv[]) {
   QGuiApplication app(argc, argv);
   app.setApplicationName("CanvasDesk");
@@ -156,22 +134,24 @@ int main(int argc, char *argv[]) {
   bool runtimeMode = parser.isSet(runtimeOption);
   bool previewMode = parser.isSet(previewOption);
 
+  // The desktop keeps metric history on disk so graphs survive restarts
+  if (runtimeMode)
+    SystemMonitor::instance()->setRecordHistory(true);
+
   QQmlApplicationEngine engine;
-  engine.addImageProvider("theme", new ThemeImageProvider);
+  engine.addImageProvider("theme", new ThemeIconProvider);
+  engine.addImageProvider("window", new WindowIconProvider);
+  engine.addImageProvider("wallpaper", new WallpaperProvider);
 
   // Register ThemeManager
   qmlRegisterType<ThemeManager>("CanvasDesk", 1, 0, "ThemeManager");
 
-  // Register SystemMonitor
-  qmlRegisterSingletonType<SystemMonitor>(
-      "CanvasDesk", 1, 0, "SystemMonitor",
-      [](QQmlEngine *, QJSEngine *) -> QObject * {
-        return new SystemMonitor();
-      });
-
   // Create global theme instance
   ThemeManager *themeManager = new ThemeManager(&app);
   engine.rootContext()->setContextProperty("Theme", themeManager);
+  // Only the desktop advances the wallpaper slideshow
+  if (runtimeMode)
+    themeManager->setPlaySlideshow(true);
 
   // Add import paths for CanvasDesk modules
   engine.addImportPath("qrc:/");
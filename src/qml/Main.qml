@@ -12,6 +12,27 @@ ApplicationWindow {
         id: layoutManager
     }
 
+    SceneModel {
+        id: sceneModel
+    }
+
+    // Top-level items by component uid
+    property var items: ({})
+
+    // Live updates from the editor that launched us (see LayoutManager::runProject)
+    LayoutServer {
+        id: layoutServer
+        onLayoutReceived: (layout) => applyPatches(sceneModel.update(layout))
+        onPatchesReceived: (patches) => {
+            var ok = sceneModel.applyPatches(patches)
+            applyPatches(patches)
+            if (!ok) {
+                // Out of sync with the editor; ask for the full layout
+                layoutServer.requestResync()
+            }
+        }
+    }
+
     Item {
         id: container
         anchors.fill: parent
@@ -21,13 +42,7 @@ ApplicationWindow {
             if (json) {
                 console.log("Loaded layout in runtime")
                 try {
-                    var data = JSON.parse(json)
-                    if (data.components) {
-                        for (var i = 0; i < data.components.length; ++i) {
-                            var comp = data.components[i]
-                            createObject(comp)
-                        }
-                    }
+                    applyPatches(sceneModel.update(JSON.parse(json)))
                 } catch (e) {
                     console.log("Error parsing layout: " + e)
                 }
@@ -37,29 +52,74 @@ ApplicationWindow {
         }
     }
 
+    function destroyItem(uid) {
+        if (items[uid]) {
+            items[uid].destroy()
+            delete items[uid]
+        }
+    }
+
+    function recreateItem(uid) {
+        destroyItem(uid)
+        var data = sceneModel.componentData(uid)
+        if (data.type)
+            items[uid] = createObject(data)
+    }
+
+    // Only top-level components are rendered here; docked ones are skipped
+    function applyPatches(patches) {
+        for (var i = 0; i < patches.length; ++i) {
+            var patch = patches[i]
+            if (patch.op === "add") {
+                if (!patch.parentUid)
+                    items[patch.uid] = createObject(patch.data)
+            } else if (patch.op === "remove") {
+                destroyItem(patch.uid)
+            } else if (patch.op === "move") {
+                if (patch.parentUid)
+                    destroyItem(patch.uid)
+                else if (!items[patch.uid])
+                    recreateItem(patch.uid)
+            } else if (patch.op === "update") {
+                var item = items[patch.uid]
+                if (!item)
+                    continue
+                var keys = Object.keys(patch.data)
+                var moveOnly = keys.every(k => k === "x" || k === "y")
+                if (moveOnly) {
+                    if (patch.data.x !== undefined) item.x = patch.data.x
+                    if (patch.data.y !== undefined) item.y = patch.data.y
+                } else {
+                    // Properties are baked into the generated QML
+                    recreateItem(patch.uid)
+                }
+            }
+        }
+    }
+
     function createObject(data) {
         if (data.type === "Button") {
             var qml = 'import QtQuick; import QtQuick.Controls; import CanvasDesk; Button { text: "' + data.text + '"; icon.name: "' + (data.icon || "") + '"; x: ' + data.x + '; y: ' + data.y + '; onClicked: AppManager.launch("' + data.exec + '") }'
-            Qt.createQmlObject(qml, container, "dynamicComponent")
+            return Qt.createQmlObject(qml, container, "dynamicComponent")
         } else if (data.type === "Taskbar") {
-            var qml = 'import QtQuick; import QtQuick.Controls; import QtQuick.Layouts; import CanvasDesk; ListView { orientation: ListView.Horizontal; width: 400; height: 40; x: ' + data.x + '; y: ' + data.y + '; model: WindowManager.windows; delegate: Button { text: modelData.title; icon.name: modelData.icon; highlighted: modelData.active; onClicked: WindowManager.activate(modelData.id) } }'
-            Qt.createQmlObject(qml, container, "dynamicComponent")
+            var qml = 'import QtQuick; import QtQuick.Controls; import QtQuick.Layouts; import CanvasDesk; ListView { orientation: ListView.Horizontal; width: 400; height: 40; x: ' + data.x + '; y: ' + data.y + '; model: WindowManager.windows; delegate: Button { text: modelData.title; icon.source: modelData.iconSource; highlighted: modelData.active; onClicked: WindowManager.activate(modelData.id) } }'
+            return Qt.createQmlObject(qml, container, "dynamicComponent")
         } else if (data.type === "AppGrid") {
-            var qml = 'import QtQuick; import QtQuick.Controls; import CanvasDesk; GridView { width: 300; height: 400; cellWidth: 80; cellHeight: 80; x: ' + data.x + '; y: ' + data.y + '; model: AppManager.apps; delegate: Item { width: 80; height: 80; Column { anchors.centerIn: parent; spacing: 5; ToolButton { icon.name: modelData.icon || "application-x-executable"; icon.width: 48; icon.height: 48; onClicked: AppManager.launch(modelData.exec) } Text { text: modelData.name; width: 70; elide: Text.ElideRight; horizontalAlignment: Text.AlignHCenter; font.pixelSize: 10 } } } }'
-            Qt.createQmlObject(qml, container, "dynamicComponent")
+            var qml = 'import QtQuick; import QtQuick.Controls; import CanvasDesk; GridView { width: 300; height: 400; cellWidth: 80; cellHeight: 80; x: ' + data.x + '; y: ' + data.y + '; model: AppManager.model; delegate: Item { width: 80; height: 80; Column { anchors.centerIn: parent; spacing: 5; ToolButton { icon.name: model.icon || "application-x-executable"; icon.width: 48; icon.height: 48; onClicked: AppManager.launchApp(model.id) } Text { text: model.name; width: 70; elide: Text.ElideRight; horizontalAlignment: Text.AlignHCenter; font.pixelSize: 10 } } } }'
+            return Qt.createQmlObject(qml, container, "dynamicComponent")
         } else if (data.type === "FileManager") {
             var qml = 'import QtQuick; import QtQuick.Controls; import Qt.labs.folderlistmodel; import CanvasDesk; ListView { width: 200; height: 300; x: ' + data.x + '; y: ' + data.y + '; model: FolderListModel { folder: "file://" + AppManager.homeDir(); showDirsFirst: true; nameFilters: ["*"] }; delegate: ItemDelegate { text: fileName; icon.name: fileIsDir ? "folder" : "text-x-generic"; width: parent.width } }'
-            Qt.createQmlObject(qml, container, "dynamicComponent")
+            return Qt.createQmlObject(qml, container, "dynamicComponent")
         } else if (data.type === "WorkspaceSwitcher") {
             var qml = 'import QtQuick; import QtQuick.Controls; import QtQuick.Layouts; import CanvasDesk; Row { spacing: 5; x: ' + data.x + '; y: ' + data.y + '; Repeater { model: WindowManager.workspaceCount; delegate: Button { text: (index + 1).toString(); highlighted: WindowManager.currentWorkspace === index; onClicked: WindowManager.switchToWorkspace(index); width: 40; height: 30 } } }'
-            Qt.createQmlObject(qml, container, "dynamicComponent")
+            return Qt.createQmlObject(qml, container, "dynamicComponent")
         } else if (data.type === "Clock") {
             var qml = 'import QtQuick; import QtQuick.Controls; Rectangle { width: 120; height: 40; color: "#2a2a2a"; border.color: "#555"; radius: 4; x: ' + data.x + '; y: ' + data.y + '; Text { id: clockText; anchors.centerIn: parent; color: "white"; font.pixelSize: 16; font.family: "monospace"; text: Qt.formatTime(new Date(), "hh:mm:ss"); } Timer { interval: 1000; running: true; repeat: true; onTriggered: clockText.text = Qt.formatTime(new Date(), "hh:mm:ss") } }'
-            Qt.createQmlObject(qml, container, "dynamicComponent")
+            return Qt.createQmlObject(qml, container, "dynamicComponent")
         } else {
             // Fallback for other types
             var qml = 'import QtQuick; Rectangle { color: "#ddeeff"; border.color: "blue"; width: 100; height: 50; x: ' + data.x + '; y: ' + data.y + '; Text { anchors.centerIn: parent; text: "' + data.type + '" } }'
-            Qt.createQmlObject(qml, container, "dynamicComponent")
+            return Qt.createQmlObject(qml, container, "dynamicComponent")
         }
     }
 }